@@ -17,6 +17,11 @@ let package = Package(
             dependencies: ["VoicePipeline"],
             path: "Voca",
             resources: [.copy("Resources")]
+        ),
+        .testTarget(
+            name: "VocaTests",
+            dependencies: ["VocaLib"],
+            path: "Tests/VocaTests"
         )
     ]
 )
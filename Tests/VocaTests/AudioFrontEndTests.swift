@@ -0,0 +1,69 @@
+import XCTest
+import Accelerate
+@testable import VocaLib
+
+final class AudioFrontEndTests: XCTestCase {
+    private let sampleRate = AudioFrontEnd.sampleRate
+    /// 100 ms blocks, as the recorder feeds them
+    private let block = 1600
+
+    /// Voiced syllables (harmonics of a pitch that changes every syllable) 200 ms long with
+    /// 50 ms gaps, at an RMS of about 0.04 while voiced
+    private func speech(seconds: Double) -> [Float] {
+        let pitches: [Double] = [120, 160, 140, 180]
+        return (0..<Int(seconds * Double(sampleRate))).map { index in
+            let time = Double(index) / Double(sampleRate)
+            let syllable = Int(time / 0.25)
+            guard time - Double(syllable) * 0.25 < 0.2 else { return 0 }
+            let pitch = pitches[syllable % pitches.count]
+            let voiced = (1...10).reduce(0.0) { sum, harmonic in
+                sum + sin(2 * Double.pi * pitch * Double(harmonic) * time) / Double(harmonic)
+            }
+            return Float(0.045 * voiced)
+        }
+    }
+
+    /// Clean `input` in blocks and segment the result, as the recorder does
+    private func cleanAndSegment(_ input: [Float], frontEnd: AudioFrontEnd) -> [SpeechSegmenter.Segment] {
+        var cleaned: [Float] = []
+        for start in stride(from: 0, to: input.count, by: block) {
+            frontEnd.process(Array(input[start..<min(start + block, input.count)]), into: &cleaned)
+        }
+        frontEnd.flush(into: &cleaned)
+        cleaned.removeFirst(AudioFrontEnd.latency)
+
+        var segmenter = SpeechSegmenter()
+        var segments: [SpeechSegmenter.Segment] = []
+        for start in stride(from: 0, to: cleaned.count, by: block) {
+            let samples = Array(cleaned[start..<min(start + block, cleaned.count)])
+            var meanSquare: Float = 0
+            vDSP_measqv(samples, 1, &meanSquare, vDSP_Length(samples.count))
+            if let segment = segmenter.append(samples, rms: meanSquare.squareRoot()) {
+                segments.append(segment)
+            }
+        }
+        if let segment = segmenter.finish() {
+            segments.append(segment)
+        }
+        return segments
+    }
+
+    func testSpeechFromTheFirstSampleSurvives() throws {
+        let input = speech(seconds: 2) + [Float](repeating: 0, count: 2 * sampleRate)
+        let segments = cleanAndSegment(input, frontEnd: AudioFrontEnd())
+
+        let segment = try XCTUnwrap(segments.first)
+        XCTAssertEqual(segments.count, 1)
+        XCTAssertEqual(segment.start, 0)
+        XCTAssertGreaterThanOrEqual(segment.samples.count, 3 * sampleRate / 2)
+    }
+
+    func testCarriedNoiseFloorKeepsSpeech() throws {
+        let first = AudioFrontEnd()
+        _ = cleanAndSegment(speech(seconds: 2) + [Float](repeating: 0, count: 2 * sampleRate), frontEnd: first)
+
+        let segments = cleanAndSegment(speech(seconds: 2) + [Float](repeating: 0, count: 2 * sampleRate),
+                                frontEnd: AudioFrontEnd(noiseFloor: first.noiseFloor))
+        XCTAssertEqual(segments.count, 1)
+    }
+}
@@ -0,0 +1,59 @@
+import XCTest
+@testable import VocaLib
+
+final class BPETokenizerTests: XCTestCase {
+    private static let modelPath = URL(fileURLWithPath: #filePath)
+        .deletingLastPathComponent().deletingLastPathComponent().deletingLastPathComponent()
+        .appendingPathComponent("Voca/Resources/assets/chn_jpn_yue_eng_ko_spectok.bpe.model").path
+
+    private var cacheDir: URL!
+
+    override func setUp() {
+        cacheDir = FileManager.default.temporaryDirectory.appendingPathComponent("voca-tests-\(UUID().uuidString)")
+    }
+
+    override func tearDown() {
+        try? FileManager.default.removeItem(at: cacheDir)
+    }
+
+    private func load() throws -> BPETokenizer {
+        try XCTUnwrap(BPETokenizer.load(modelPath: Self.modelPath, cacheDir: cacheDir))
+    }
+
+    func testEncodeDecodeRoundTrip() throws {
+        let tokenizer = try load()
+        for text in ["voca transcribes speech on device", "我们今天讨论语音识别", "Hello world 你好"] {
+            let ids = tokenizer.encode(text)
+            XCTAssertFalse(ids.contains(tokenizer.unknownId), text)
+            XCTAssertEqual(tokenizer.decode(ids), text)
+        }
+    }
+
+    func testMappedCacheMatchesFreshCompile() throws {
+        let cold = try load()
+        let warm = try load()
+        let text = "voca transcribes speech on device"
+        XCTAssertEqual(cold.vocabularySize, warm.vocabularySize)
+        XCTAssertEqual(cold.encode(text), warm.encode(text))
+    }
+
+    func testReplacedModelRecompilesTheCache() throws {
+        // A copy stands in for a model replaced in place with one of the same size
+        try FileManager.default.createDirectory(at: cacheDir, withIntermediateDirectories: true)
+        let model = cacheDir.appendingPathComponent("replaced.bpe.model")
+        try FileManager.default.copyItem(atPath: Self.modelPath, toPath: model.path)
+        let cache = cacheDir.appendingPathComponent("replaced.bin")
+
+        XCTAssertNotNil(BPETokenizer.load(modelPath: model.path, cacheDir: cacheDir))
+        let stale = try Data(contentsOf: cache)
+        try FileManager.default.setAttributes([.modificationDate: Date(timeIntervalSinceNow: 60)], ofItemAtPath: model.path)
+        XCTAssertNotNil(BPETokenizer.load(modelPath: model.path, cacheDir: cacheDir))
+        XCTAssertNotEqual(try Data(contentsOf: cache), stale)
+    }
+
+    func testDecodeSkipsControlTokensAndOutOfRangeIds() throws {
+        let tokenizer = try load()
+        let ids = tokenizer.encode("speech")
+        XCTAssertEqual(tokenizer.decode([0] + ids + [Int32(tokenizer.vocabularySize), -1]), "speech")
+    }
+}
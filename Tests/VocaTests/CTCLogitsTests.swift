@@ -0,0 +1,86 @@
+import XCTest
+@testable import VocaLib
+
+/// fp16 logit storage must not change what is decoded
+final class CTCLogitsTests: XCTestCase {
+    private let frameCount = 60
+    private let vocabularySize = 300
+
+    /// The label that wins `frame`: a token on two frames in five, blank otherwise
+    private func label(at frame: Int) -> Int {
+        frame % 5 < 2 ? 1 + (frame * 37) % (vocabularySize - 1) : 0
+    }
+
+    /// Mostly blank frames with a token run every few frames; the best score leads the
+    /// rest by at least a nat, far above fp16 rounding
+    private func logits() -> CTCLogits {
+        var state: UInt64 = 0x9E37_79B9_7F4A_7C15
+        func noise() -> Float {
+            state = state &* 6_364_136_223_846_793_005 &+ 1_442_695_040_888_963_407
+            return Float(state >> 40) / Float(1 << 24) * 8 - 4
+        }
+        return CTCLogits(frameCount: frameCount, vocabularySize: vocabularySize, precision: .single) { frame, row in
+            for i in 0..<row.count {
+                row[i] = noise()
+            }
+            row[self.label(at: frame)] = 6 + noise() / 4
+        }
+    }
+
+    func testHalfStorageIsHalfTheSize() {
+        let single = logits()
+        let half = single.converted(to: .half)
+        XCTAssertEqual(half.precision, .half)
+        XCTAssertEqual(half.storedBytes * 2, single.storedBytes)
+    }
+
+    func testScoresSurviveTheRoundTrip() {
+        let single = logits()
+        let restored = single.converted(to: .half).converted(to: .single)
+        var worst: Float = 0
+        single.forEachFrame { frame, expected in
+            restored.forEachFrame(frame..<(frame + 1)) { _, actual in
+                for i in 0..<vocabularySize {
+                    worst = max(worst, abs(expected[i] - actual[i]))
+                }
+            }
+        }
+        // fp16 keeps 11 significant bits: below 8 the spacing is at most 2^-8
+        XCTAssertLessThanOrEqual(worst, 1.0 / 256)
+    }
+
+    func testGreedyDecodeMatches() {
+        let single = logits()
+        let half = single.converted(to: .half)
+        let expected = CTCBeamDecoder.greedyAlign(single)
+        XCTAssertFalse(expected.isEmpty)
+        XCTAssertEqual(CTCBeamDecoder.greedyAlign(half).map(\.id), expected.map(\.id))
+        XCTAssertEqual(half.nonBlankRatio(), single.nonBlankRatio())
+    }
+
+    func testBiasedBeamSearchMatches() {
+        var single = logits()
+        var half = single.converted(to: .half)
+        single.applyLogSoftmax()
+        half.applyLogSoftmax()
+
+        var hotwords = HotwordTrie()
+        hotwords.insert([label(at: 5), label(at: 6)].map(Int32.init))
+        let decoder = CTCBeamDecoder()
+        let expected = decoder.decode(single, hotwords: hotwords)
+        XCTAssertEqual(expected, CTCBeamDecoder.greedyDecode(single))
+        XCTAssertEqual(decoder.decode(half, hotwords: hotwords), expected)
+    }
+
+    func testLogSoftmaxStaysNormalizedInHalf() {
+        var half = logits().converted(to: .half)
+        half.applyLogSoftmax()
+        half.forEachFrame { _, row in
+            var sum: Float = 0
+            for i in 0..<vocabularySize {
+                sum += expf(row[i])
+            }
+            XCTAssertEqual(sum, 1, accuracy: 0.01)
+        }
+    }
+}
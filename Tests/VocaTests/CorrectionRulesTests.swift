@@ -0,0 +1,49 @@
+import XCTest
+@testable import VocaLib
+
+final class CorrectionRulesTests: XCTestCase {
+    func testExactMappingRespectsWordBoundaries() {
+        let rules = CorrectionRules(mappings: [WordMapping(find: "zor vex", replace: "Zorvex")], customWords: [])
+        XCTAssertEqual(rules.apply("we shipped zor vex today"), "we shipped Zorvex today")
+        XCTAssertEqual(rules.apply("we shipped Zor Vex today"), "we shipped Zorvex today")
+        XCTAssertEqual(rules.apply("a zor vexing day"), "a zor vexing day")
+    }
+
+    func testLatinCustomWordMatchesBySound() {
+        let rules = CorrectionRules(mappings: [], customWords: ["ChatGPT"])
+        XCTAssertEqual(rules.apply("ask chat gpt about it"), "ask ChatGPT about it")
+        XCTAssertEqual(rules.apply("ask ChatGPT about it"), "ask ChatGPT about it")
+    }
+
+    func testRealWordsSharingAKeyAreLeftAlone() {
+        let rules = CorrectionRules(mappings: [], customWords: ["Claude", "Nuxt"])
+        XCTAssertEqual(rules.apply("the cloud is down"), "the cloud is down")
+        XCTAssertEqual(rules.apply("we could call it later"), "we could call it later")
+        // "next" has Nuxt's key and spelling distance but is a real word
+        XCTAssertEqual(rules.apply("what comes next"), "what comes next")
+        XCTAssertEqual(rules.apply("we moved to nuxt"), "we moved to Nuxt")
+    }
+
+    func testDistantSpellingsAreNotMatched() {
+        let rules = CorrectionRules(mappings: [WordMapping(find: "zor vex", replace: "Zorvex")], customWords: [])
+        XCTAssertEqual(rules.apply("zorvex"), "Zorvex")
+        XCTAssertEqual(rules.apply("the sir vex"), "the sir vex")
+    }
+
+    func testHanCustomWordMatchesBySound() {
+        let rules = CorrectionRules(mappings: [], customWords: ["语音"])
+        XCTAssertEqual(rules.apply("我们做雨因识别"), "我们做语音识别")
+    }
+
+    func testSingleHanCharacterIsExactOnly() {
+        let rules = CorrectionRules(mappings: [WordMapping(find: "汪", replace: "王")], customWords: ["王"])
+        XCTAssertEqual(rules.apply("晚上去网上看"), "晚上去网上看")
+        XCTAssertEqual(rules.apply("汪先生"), "王先生")
+    }
+
+    func testEmptyRulesLeaveTextAlone() {
+        let rules = CorrectionRules(mappings: [], customWords: [])
+        XCTAssertTrue(rules.isEmpty)
+        XCTAssertEqual(rules.apply("nothing to do"), "nothing to do")
+    }
+}
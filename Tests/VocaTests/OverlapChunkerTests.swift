@@ -0,0 +1,83 @@
+import XCTest
+@testable import VocaLib
+
+final class OverlapChunkerTests: XCTestCase {
+    private let names = ["alpha", "bravo", "charlie", "delta", "echo", "foxtrot", "golf", "hotel", "india", "juliet"]
+
+    /// Word `i` spans [0.5·i, 0.5·i + 0.4) seconds
+    private func word(_ index: Int, _ text: String? = nil) -> TimedWord {
+        TimedWord(text: text ?? names[index], start: Double(index) * 0.5, end: Double(index) * 0.5 + 0.4)
+    }
+
+    private func chunk(_ start: TimeInterval, _ end: TimeInterval, _ words: [TimedWord]) -> OverlapChunker.Chunk {
+        OverlapChunker.Chunk(start: start, end: end,
+                             transcript: TimedTranscript(text: words.map(\.text).joined(separator: " "), words: words))
+    }
+
+    private func text(_ start: TimeInterval, _ end: TimeInterval, _ words: [String]) -> OverlapChunker.Chunk {
+        OverlapChunker.Chunk(start: start, end: end, transcript: TimedTranscript(text: words.joined(separator: " ")))
+    }
+
+    func testTimedOverlapIsKeptOnce() {
+        let merged = OverlapChunker.merge([
+            chunk(0, 3, (0...5).map { word($0) }),
+            chunk(2, 5, (4...9).map { word($0) }),
+        ])
+        XCTAssertEqual(merged.text, names.joined(separator: " "))
+        XCTAssertEqual(merged.words, (0...9).map { word($0) })
+    }
+
+    func testWordsCutByAnEdgeAreDropped() {
+        // Each chunk garbles the word its edge cuts through
+        let merged = OverlapChunker.merge([
+            chunk(0, 2.7, (0...4).map { word($0) } + [word(5, "foxx")]),
+            chunk(2.2, 5, [word(4, "ecx")] + (5...9).map { word($0) }),
+        ])
+        XCTAssertEqual(merged.text, names.joined(separator: " "))
+    }
+
+    func testTextOnlyChunksAlignOnSharedWords() {
+        let merged = OverlapChunker.merge([
+            OverlapChunker.Chunk(start: 0, end: 3, transcript: TimedTranscript(text: "alpha bravo charlie delta echo foxtrot")),
+            OverlapChunker.Chunk(start: 2, end: 5, transcript: TimedTranscript(text: "echo foxtrot golf hotel")),
+        ])
+        XCTAssertEqual(merged.text, "alpha bravo charlie delta echo foxtrot golf hotel")
+        XCTAssertTrue(merged.words.isEmpty)
+    }
+
+    func testTextOnlyChunksWithoutMatchAreCutAtTheMiddle() {
+        // Ten words per ten-second chunk; the right chunk garbles the two it shares
+        let merged = OverlapChunker.merge([
+            text(0, 10, (0...9).map { "w\($0)" }),
+            text(8, 18, ["v8", "v9"] + (10...17).map { "w\($0)" }),
+        ])
+        XCTAssertEqual(merged.text, ((0...8).map { "w\($0)" } + ["v9"] + (10...17).map { "w\($0)" }).joined(separator: " "))
+    }
+
+    func testTextOnlyMatchFarFromTheOverlapIsIgnored() {
+        // "of the" appears early in the left chunk and late in the right one, never in the overlap
+        let merged = OverlapChunker.merge([
+            text(0, 10, ["a0", "of", "the", "a3", "a4", "a5", "a6", "a7", "a8", "a9"]),
+            text(8, 18, ["a9", "b1", "b2", "b3", "of", "the", "b6", "b7", "b8", "b9"]),
+        ])
+        XCTAssertEqual(merged.text, "a0 of the a3 a4 a5 a6 a7 a8 b1 b2 b3 of the b6 b7 b8 b9")
+    }
+
+    func testCJKSeamJoinsWithoutSpace() {
+        let merged = OverlapChunker.merge([
+            OverlapChunker.Chunk(start: 0, end: 3, transcript: TimedTranscript(text: "我们今天讨论")),
+            OverlapChunker.Chunk(start: 2, end: 5, transcript: TimedTranscript(text: "今天讨论语音")),
+        ])
+        XCTAssertEqual(merged.text, "我们今天讨论语音")
+    }
+
+    func testRangesCoverTheAudioWithOverlap() {
+        let chunker = OverlapChunker(chunkSeconds: 20, overlapSeconds: 2)
+        let ranges = chunker.ranges(sampleCount: 65 * 100, sampleRate: 100)
+        XCTAssertEqual(ranges.first?.lowerBound, 0)
+        XCTAssertEqual(ranges.last?.upperBound, 65 * 100)
+        for (left, right) in zip(ranges, ranges.dropFirst()) {
+            XCTAssertGreaterThanOrEqual(left.upperBound - right.lowerBound, 2 * 100)
+        }
+    }
+}
@@ -0,0 +1,128 @@
+import Foundation
+#if canImport(VocaLib)
+@testable import VocaLib
+#endif
+
+/// Quality and throughput checks for `Resampler`, shared by `ResamplerTests` and
+/// `scripts/resampler-check.sh` (which builds with swiftc alone, so it also runs on Linux).
+enum ResamplerCheck {
+    /// Largest allowed passband gain variation, in dB
+    static let maxRippleDB = 0.1
+    /// Loudest allowed alias of a full-scale tone above the output Nyquist rate, in dB
+    static let maxAliasDB = -70.0
+
+    /// Print per-rate results; returns false if any bound is violated
+    @discardableResult
+    static func run(outputRate: Int = 16000) -> Bool {
+        print("Input     Ripple     Worst alias   Streaming   Throughput")
+        var passed = true
+        for rate in Resampler.commonInputRates {
+            let ripple = passbandRippleDB(inputRate: rate, outputRate: outputRate)
+            let alias = worstAliasDB(inputRate: rate, outputRate: outputRate)
+            let mismatch = streamingMismatch(inputRate: rate, outputRate: outputRate)
+            let realtime = throughput(inputRate: rate, outputRate: outputRate)
+            let ok = ripple <= maxRippleDB && alias <= maxAliasDB && mismatch == 0
+            passed = passed && ok
+            let measured = String(format: "%5d Hz  %.4f dB  %7.1f dB", rate, ripple, alias)
+            let speed = String(format: "%8.0f× realtime", realtime)
+            print("\(measured)     \(mismatch == 0 ? "identical" : "DIFFERS  ")  \(speed) \(ok ? "✓" : "✗")")
+        }
+        return passed
+    }
+
+    /// Gain spread over tones from 50 Hz to the passband edge
+    static func passbandRippleDB(inputRate: Int, outputRate: Int) -> Double {
+        let edge = Double(min(inputRate, outputRate)) / 2 * Resampler.passband
+        var gains: [Double] = []
+        var frequency = 50.0
+        while frequency <= edge {
+            gains.append(20 * log10(toneGain(frequency, inputRate: inputRate, outputRate: outputRate)))
+            frequency += 250
+        }
+        return (gains.max() ?? 0) - (gains.min() ?? 0)
+    }
+
+    /// Output level of tones between the output Nyquist rate and the input Nyquist rate;
+    /// everything that comes out is an alias
+    static func worstAliasDB(inputRate: Int, outputRate: Int) -> Double {
+        guard inputRate > outputRate else { return -.infinity }
+        var worst = -Double.infinity
+        var frequency = Double(outputRate) / 2 + 200
+        while frequency < Double(inputRate) / 2 - 100 {
+            worst = max(worst, 20 * log10(toneGain(frequency, inputRate: inputRate, outputRate: outputRate)))
+            frequency += 431
+        }
+        return worst
+    }
+
+    /// Largest difference between one-shot and irregular block-by-block output
+    static func streamingMismatch(inputRate: Int, outputRate: Int) -> Float {
+        var random = LCG(seed: UInt64(inputRate))
+        let input = (0..<inputRate).map { _ in random.nextSample() }
+        let reference = Resampler.resample(input, from: inputRate, to: outputRate)
+
+        let resampler = Resampler(inputRate: inputRate, outputRate: outputRate)
+        var streamed: [Float] = []
+        var start = 0
+        while start < input.count {
+            let end = min(input.count, start + 1 + Int(random.next() % 3000))
+            resampler.process(Array(input[start..<end]), into: &streamed)
+            start = end
+        }
+        resampler.flush(into: &streamed)
+
+        guard streamed.count == reference.count else { return .infinity }
+        return zip(streamed, reference).map { abs($0 - $1) }.max() ?? 0
+    }
+
+    /// Seconds of audio converted per second, in capture-sized (4096-sample) blocks
+    static func throughput(inputRate: Int, outputRate: Int) -> Double {
+        var random = LCG(seed: 7)
+        let seconds = 60
+        let input = (0..<(inputRate * seconds)).map { _ in random.nextSample() }
+        let resampler = Resampler(inputRate: inputRate, outputRate: outputRate)
+        var output: [Float] = []
+        output.reserveCapacity(outputRate * seconds + 1)
+
+        let start = DispatchTime.now().uptimeNanoseconds
+        input.withUnsafeBufferPointer { buffer in
+            var offset = 0
+            while offset < buffer.count {
+                let count = min(4096, buffer.count - offset)
+                resampler.process(UnsafeBufferPointer(rebasing: buffer[offset..<(offset + count)]), into: &output)
+                offset += count
+            }
+        }
+        resampler.flush(into: &output)
+        let elapsed = Double(DispatchTime.now().uptimeNanoseconds - start) / 1e9
+        return Double(seconds) / max(elapsed, 1e-9)
+    }
+
+    /// RMS gain for a steady tone, ignoring the filter's start-up and tail
+    private static func toneGain(_ frequency: Double, inputRate: Int, outputRate: Int) -> Double {
+        let step = 2 * Double.pi * frequency / Double(inputRate)
+        let input = (0..<inputRate).map { Float(sin(Double($0) * step)) }
+        let output = Resampler.resample(input, from: inputRate, to: outputRate)
+        let steady = output[(outputRate / 8)..<(output.count - outputRate / 8)]
+        let power = steady.reduce(0.0) { $0 + Double($1) * Double($1) } / Double(steady.count)
+        return max((power * 2).squareRoot(), 1e-12)
+    }
+
+    /// Deterministic noise so runs are comparable
+    private struct LCG {
+        var state: UInt64
+
+        init(seed: UInt64) {
+            state = seed &+ 0x9E37_79B9_7F4A_7C15
+        }
+
+        mutating func next() -> UInt64 {
+            state = state &* 6_364_136_223_846_793_005 &+ 1_442_695_040_888_963_407
+            return state >> 33
+        }
+
+        mutating func nextSample() -> Float {
+            Float(next() % 65536) / 32768 - 1
+        }
+    }
+}
@@ -0,0 +1,35 @@
+import XCTest
+@testable import VocaLib
+
+final class ResamplerTests: XCTestCase {
+    func testPassbandIsFlat() {
+        for rate in Resampler.commonInputRates {
+            XCTAssertLessThanOrEqual(ResamplerCheck.passbandRippleDB(inputRate: rate, outputRate: 16000),
+                                     ResamplerCheck.maxRippleDB, "\(rate) Hz")
+        }
+    }
+
+    func testAliasesAreAttenuated() {
+        for rate in Resampler.commonInputRates {
+            XCTAssertLessThanOrEqual(ResamplerCheck.worstAliasDB(inputRate: rate, outputRate: 16000),
+                                     ResamplerCheck.maxAliasDB, "\(rate) Hz")
+        }
+    }
+
+    func testBlockwiseOutputMatchesOneShot() {
+        for rate in Resampler.commonInputRates {
+            XCTAssertEqual(ResamplerCheck.streamingMismatch(inputRate: rate, outputRate: 16000), 0, "\(rate) Hz")
+        }
+    }
+
+    func testOutputLengthFollowsTheRatio() {
+        let output = Resampler.resample([Float](repeating: 0.5, count: 48000), from: 48000)
+        XCTAssertEqual(output.count, 16000)
+        XCTAssertEqual(output[8000], 0.5, accuracy: 1e-3)
+    }
+
+    func testSameRateIsPassedThrough() {
+        let input: [Float] = [0.1, -0.2, 0.3]
+        XCTAssertEqual(Resampler.resample(input, from: 16000), input)
+    }
+}
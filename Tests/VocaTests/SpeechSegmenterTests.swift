@@ -0,0 +1,65 @@
+import XCTest
+@testable import VocaLib
+
+final class SpeechSegmenterTests: XCTestCase {
+    /// 100 ms blocks, as the recorder and server feed them
+    private let block = 1600
+
+    /// Feed `blocks` of silence (RMS 0) or speech (RMS 0.2); returns any segments
+    private func feed(_ segmenter: inout SpeechSegmenter, blocks: Int, speech: Bool) -> [SpeechSegmenter.Segment] {
+        var segments: [SpeechSegmenter.Segment] = []
+        for _ in 0..<blocks {
+            let samples = [Float](repeating: speech ? 0.2 : 0, count: block)
+            if let segment = segmenter.append(samples, rms: speech ? 0.2 : 0) {
+                segments.append(segment)
+            }
+        }
+        return segments
+    }
+
+    func testSilenceYieldsNothing() {
+        var segmenter = SpeechSegmenter()
+        XCTAssertTrue(feed(&segmenter, blocks: 50, speech: false).isEmpty)
+        XCTAssertNil(segmenter.finish())
+    }
+
+    func testPauseEndsASegment() throws {
+        var segmenter = SpeechSegmenter()
+        XCTAssertTrue(feed(&segmenter, blocks: 5, speech: false).isEmpty)
+        XCTAssertTrue(feed(&segmenter, blocks: 20, speech: true).isEmpty)
+        let segments = feed(&segmenter, blocks: 13, speech: false)
+
+        let segment = try XCTUnwrap(segments.first)
+        XCTAssertEqual(segments.count, 1)
+        XCTAssertEqual(segment.start, 0)
+        // Pre-roll and the speech, without (most of) the pause that ended it
+        XCTAssertGreaterThanOrEqual(segment.samples.count, 8000 + 2 * 16000)
+        XCTAssertLessThanOrEqual(segment.samples.count, 8000 + 2 * 16000 + block)
+        XCTAssertNil(segmenter.finish())
+    }
+
+    func testSegmentsAreContiguousInTheStream() throws {
+        var segmenter = SpeechSegmenter()
+        var segments = feed(&segmenter, blocks: 5, speech: false)
+        for _ in 0..<2 {
+            segments += feed(&segmenter, blocks: 20, speech: true)
+            segments += feed(&segmenter, blocks: 13, speech: false)
+        }
+        XCTAssertEqual(segments.count, 2)
+        let first = try XCTUnwrap(segments.first)
+        XCTAssertEqual(segments.last?.start, first.start + first.samples.count)
+    }
+
+    func testShortBlipIsNotASegmentOnItsOwn() {
+        var segmenter = SpeechSegmenter()
+        XCTAssertTrue(feed(&segmenter, blocks: 3, speech: true).isEmpty)
+        XCTAssertTrue(feed(&segmenter, blocks: 13, speech: false).isEmpty)
+    }
+
+    func testFinishFlushesTrailingSpeech() throws {
+        var segmenter = SpeechSegmenter()
+        _ = feed(&segmenter, blocks: 20, speech: true)
+        let segment = try XCTUnwrap(segmenter.finish())
+        XCTAssertEqual(segment.samples.count, 2 * 16000)
+    }
+}
@@ -0,0 +1,131 @@
+import XCTest
+@testable import VocaLib
+
+/// TextPostProcessor must produce exactly what the regex chain it replaced did
+final class TextPostProcessorTests: XCTestCase {
+    /// Golden corpus: each entry is a dictation as the segments handleSpeechSegment receives
+    private static let corpus: [[String]] = [
+        ["um so I think we should ship it", "uh, tomorrow morning."],
+        ["Hello world.", "This is a test.", "hmm let me think about it"],
+        ["so the plan is , um , to wait ..", "and then? ? we go!!"],
+        ["What time is it?", "I don't know. ,", "maybe five."],
+        ["Um we need e.g. three items", "ah okay"],
+        ["我觉得 呃 这个方案可以。", "嗯 明天再说吧 。"],
+        ["那个 我们今天开会吗？", "好的，。", "没问题！。"],
+        ["你好 , 世界 . 今天天气不错", "是吗 ? 我觉得还行 !"],
+        ["ok so 呃 the meeting is at 3", "然后我们去吃饭。"],
+        ["えーと 今日は 晴れです。", "あの 明日は 雨です。"],
+        ["음 오늘 회의 있어요?", "어 네 있어요."],
+        ["the um thing is   that er we", "er, forgot"],
+        ["Wait.  . what", "no way , really ?"],
+        ["first sentence", "second sentence", "third sentence um"],
+        ["um", "hello there"],
+    ]
+
+    func testMatchesRegexChainAfterEverySegment() {
+        for segments in Self.corpus {
+            let processor = TextPostProcessor()
+            for count in 1...segments.count {
+                processor.append(segments[count - 1])
+                let joined = segments[0..<count].joined(separator: " ")
+                XCTAssertEqual(processor.text, Self.legacyPostProcess(joined), "\(segments[0..<count])")
+                // Reading `text` must not disturb later segments
+                XCTAssertEqual(processor.text, Self.legacyPostProcess(joined))
+            }
+        }
+    }
+
+    func testOneShotMatchesRegexChain() {
+        for segments in Self.corpus {
+            let joined = segments.joined(separator: " ")
+            XCTAssertEqual(TextPostProcessor.process(joined), Self.legacyPostProcess(joined))
+        }
+    }
+
+    func testLongDictationMatchesAsThePrefixGrows() {
+        // Mixed dictations: the first CJK one switches the whole text to CJK punctuation
+        let segments = (0..<60).map { Self.corpus[($0 * 7) % Self.corpus.count].joined(separator: " ") }
+        let processor = TextPostProcessor()
+        for count in 1...segments.count {
+            processor.append(segments[count - 1])
+            XCTAssertEqual(processor.text, Self.legacyPostProcess(segments[0..<count].joined(separator: " ")), "segment \(count)")
+        }
+        let unread = TextPostProcessor()
+        segments.forEach(unread.append)
+        XCTAssertEqual(unread.text, processor.text)
+    }
+
+    func testResetStartsOver() {
+        let processor = TextPostProcessor()
+        processor.append("我觉得 呃 这个方案可以。")
+        _ = processor.text
+        processor.reset()
+        XCTAssertTrue(processor.isEmpty)
+        processor.append("um hello there")
+        XCTAssertEqual(processor.text, "Hello there")
+    }
+
+    /// Reference: the regex chain TextPostProcessor replaced
+    private static func legacyPostProcess(_ text: String) -> String {
+        var result = text
+
+        // 1. Remove basic filler words (multiple languages)
+        // English: um, uh, er, ah, hmm
+        // Chinese: 呃, 嗯, 啊, 那个
+        // Japanese: えーと, あの, えー
+        // Korean: 음, 어
+        let fillerWords = ["um", "uh", "er", "ah", "hmm", "呃", "嗯", "啊", "那个", "えーと", "あの", "えー", "음", "어"]
+        for filler in fillerWords {
+            // Remove filler surrounded by spaces
+            result = result.replacingOccurrences(of: " \(filler) ", with: " ", options: .caseInsensitive)
+            // Remove filler at start
+            result = result.replacingOccurrences(of: "^\(filler) ", with: "", options: [.caseInsensitive, .regularExpression])
+            // Remove filler followed by comma
+            result = result.replacingOccurrences(of: " \(filler),", with: ",", options: .caseInsensitive)
+        }
+
+        // 2. Fix spacing and punctuation
+        result = result.replacingOccurrences(of: "  +", with: " ", options: .regularExpression)  // Multiple spaces
+        result = result.replacingOccurrences(of: " ,", with: ",")  // Space before comma
+        result = result.replacingOccurrences(of: " \\.", with: ".", options: .regularExpression)  // Space before period
+
+        // 3. Clean up duplicate/mixed punctuation
+        // Detect if text is primarily Chinese (contains CJK characters)
+        let isChinese = result.range(of: "\\p{Han}", options: .regularExpression) != nil
+
+        if isChinese {
+            // Chinese text: normalize to Chinese punctuation
+            // Handle mixed punctuation with optional spaces: ... 。 or 。 . or 。。. etc.
+            result = result.replacingOccurrences(of: "[。.\\s]*[。.][。.\\s]*", with: "。", options: .regularExpression)
+            result = result.replacingOccurrences(of: "[，,\\s]*[，,][，,\\s]*", with: "，", options: .regularExpression)
+            result = result.replacingOccurrences(of: "[？?\\s]*[？?][？?\\s]*", with: "？", options: .regularExpression)
+            result = result.replacingOccurrences(of: "[！!\\s]*[！!][！!\\s]*", with: "！", options: .regularExpression)
+            // Remove comma before period: ，。 → 。
+            result = result.replacingOccurrences(of: "，。", with: "。")
+            result = result.replacingOccurrences(of: "。，", with: "。")
+            // Remove period after question/exclamation: ？。 → ？, ！。 → ！
+            result = result.replacingOccurrences(of: "？[。.]", with: "？", options: .regularExpression)
+            result = result.replacingOccurrences(of: "！[。.]", with: "！", options: .regularExpression)
+            result = result.replacingOccurrences(of: "\\?[。.]", with: "？", options: .regularExpression)
+            result = result.replacingOccurrences(of: "![。.]", with: "！", options: .regularExpression)
+        } else {
+            // English text: normalize to English punctuation
+            result = result.replacingOccurrences(of: "[.\\s]*\\.[.\\s]*", with: ". ", options: .regularExpression)
+            result = result.replacingOccurrences(of: ",+", with: ",", options: .regularExpression)
+            result = result.replacingOccurrences(of: ",\\s*\\.", with: ".", options: .regularExpression)  // Comma before period → period
+            result = result.replacingOccurrences(of: "\\.\\s*,", with: ",", options: .regularExpression)  // Period before comma → comma
+            result = result.replacingOccurrences(of: "\\?+", with: "?", options: .regularExpression)
+            result = result.replacingOccurrences(of: "!+", with: "!", options: .regularExpression)
+        }
+
+        // Clean up any remaining multiple spaces
+        result = result.replacingOccurrences(of: "\\s{2,}", with: " ", options: .regularExpression)
+
+        // 4. Capitalize first letter (for English text)
+        if let first = result.first {
+            result = first.uppercased() + result.dropFirst()
+        }
+
+        return result.trimmingCharacters(in: .whitespaces)
+    }
+}
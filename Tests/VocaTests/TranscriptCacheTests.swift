@@ -0,0 +1,16 @@
+import XCTest
+@testable import VocaLib
+
+final class TranscriptCacheTests: XCTestCase {
+    func testQuantizedSamplesSurviveA16BitRoundTrip() {
+        let samples: [Float] = [0, 0.1234567, -0.5, 0.99999, 1.5, -1.5, 1e-6]
+        let quantized = TranscriptCache.quantized(samples)
+
+        // What a 16-bit PCM file stores and reads back
+        let reread = quantized.map { Float(Int16(($0 * 32768).rounded())) / 32768 }
+        XCTAssertEqual(reread, quantized)
+        XCTAssertEqual(TranscriptCache.quantized(quantized), quantized)
+        XCTAssertEqual(TranscriptCache.key(quantized[...], configuration: "a"),
+                       TranscriptCache.key(reread[...], configuration: "a"))
+    }
+}
@@ -0,0 +1,1564 @@
+#if DEBUG
+import Foundation
+import CryptoKit
+import VoicePipeline
+
+/// Headless micro-benchmarks for app-side pipeline stages (debug builds only; correctness
+/// checks live in the VocaTests target).
+///
+/// Run from a terminal: `Voca.app/Contents/MacOS/Voca --benchmark <name> [path]`.
+/// Results are printed and the app quits without starting the UI.
+enum Benchmarks {
+    /// Run the benchmark named after `--benchmark`, if any. Returns true if one ran.
+    static func runIfRequested(modelDir: String, assetsDir: String) -> Bool {
+        let arguments = ProcessInfo.processInfo.arguments
+        guard let flagIndex = arguments.firstIndex(of: "--benchmark") else { return false }
+        let name = flagIndex + 1 < arguments.count ? arguments[flagIndex + 1] : ""
+        let path = flagIndex + 2 < arguments.count ? arguments[flagIndex + 2] : nil
+
+        switch name {
+        case "tokenizer":
+            benchmarkTokenizer(assetsDir: assetsDir)
+        case "postprocess":
+            benchmarkPostProcess()
+        case "hotwords":
+            benchmarkHotwords(testSetDir: path, modelDir: modelDir, assetsDir: assetsDir)
+        case "corrections":
+            benchmarkCorrections()
+        case "history":
+            benchmarkHistory()
+        case "download":
+            benchmarkDownload()
+        case "models":
+            benchmarkModels(audioPath: path, modelDir: modelDir, assetsDir: assetsDir)
+        case "onnx":
+            benchmarkONNX(audioDir: path, modelDir: modelDir, assetsDir: assetsDir)
+        case "seams":
+            benchmarkSeams(clipDir: path, modelDir: modelDir, assetsDir: assetsDir)
+        case "frontend":
+            benchmarkFrontEnd(clipDir: path, modelDir: modelDir, assetsDir: assetsDir)
+        case "confidence":
+            benchmarkConfidence(recordingsDir: path, modelDir: modelDir, assetsDir: assetsDir)
+        case "trace":
+            benchmarkTrace(audioPath: path, modelDir: modelDir, assetsDir: assetsDir)
+        case "server":
+            benchmarkServer(audioPath: path, modelDir: modelDir, assetsDir: assetsDir)
+        case "streaming":
+            benchmarkStreaming(audioPath: path, modelDir: modelDir, assetsDir: assetsDir)
+        case "parakeet":
+            benchmarkParakeet(testSetDir: path, modelDir: modelDir, assetsDir: assetsDir)
+        case "routing":
+            benchmarkRouting(testSetDir: path, modelDir: modelDir, assetsDir: assetsDir)
+        case "cache":
+            benchmarkCache(audioPath: path, modelDir: modelDir, assetsDir: assetsDir)
+        case "halfprecision":
+            benchmarkHalfPrecision(clipDir: path, modelDir: modelDir, assetsDir: assetsDir)
+        default:
+            print("Unknown benchmark '\(name)'. Available: tokenizer, postprocess, hotwords, corrections, history, download, models, onnx, seams, frontend, confidence, trace, server, streaming, parakeet, routing, cache, halfprecision")
+        }
+        return true
+    }
+
+    // MARK: - Tokenizer
+
+    /// Compare vocab.json + TokenDecoder against the mapped BPETokenizer (load + decode)
+    private static func benchmarkTokenizer(assetsDir: String) {
+        let vocabPath = "\(assetsDir)/vocab.json"
+        let modelPath = "\(assetsDir)/chn_jpn_yue_eng_ko_spectok.bpe.model"
+        let cacheDir = FileManager.default.temporaryDirectory.appendingPathComponent("voca-bench-\(UUID().uuidString)")
+        defer { try? FileManager.default.removeItem(at: cacheDir) }
+
+        print("── Tokenizer ──────────────────────────")
+
+        let jsonLoadMs = measureMs { _ = TokenDecoder.shared.loadVocabulary(path: vocabPath) }
+        print("vocab.json load:        \(format(jsonLoadMs)) ms")
+
+        var tokenizer: BPETokenizer?
+        let compileMs = measureMs { tokenizer = BPETokenizer.load(modelPath: modelPath, cacheDir: cacheDir) }
+        print("BPE compile (cold):     \(format(compileMs)) ms")
+
+        let mappedLoadMs = measureMs { tokenizer = BPETokenizer.load(modelPath: modelPath, cacheDir: cacheDir) }
+        print("BPE mapped load (warm): \(format(mappedLoadMs)) ms")
+
+        guard let bpe = tokenizer else {
+            print("✗ BPETokenizer failed to load")
+            return
+        }
+
+        // Random utterances of 40 text tokens (skip the special/control tail of the vocab)
+        var generator = SystemRandomNumberGenerator()
+        let textRange = Int32(3)..<Int32(min(bpe.vocabularySize, 24_000))
+        let utterances: [[Int32]] = (0..<2_000).map { _ in
+            (0..<40).map { _ in Int32.random(in: textRange, using: &generator) }
+        }
+        let kotlinUtterances = utterances.map { $0.map { KotlinInt(int: $0) } }
+        let tokenCount = Double(utterances.count * 40)
+
+        var mismatches = 0
+        let jsonDecodeMs = measureMs {
+            for ids in kotlinUtterances { _ = TokenDecoder.shared.decode(tokenIds: ids) }
+        }
+        let bpeDecodeMs = measureMs {
+            for ids in utterances { _ = bpe.decode(ids) }
+        }
+        for (ids, kotlinIds) in zip(utterances, kotlinUtterances)
+        where bpe.decode(ids) != TokenDecoder.shared.decode(tokenIds: kotlinIds).trimmingCharacters(in: .whitespaces) {
+            mismatches += 1
+        }
+
+        print("TokenDecoder decode:    \(format(tokenCount / jsonDecodeMs * 1000)) tokens/s")
+        print("BPETokenizer decode:    \(format(tokenCount / bpeDecodeMs * 1000)) tokens/s")
+        print("Decode mismatches:      \(mismatches)/\(utterances.count)")
+
+        let sample = "Voca transcribes speech on device"
+        let encodeMs = measureMs {
+            for _ in 0..<1_000 { _ = bpe.encode(sample) }
+        }
+        print("BPETokenizer encode:    \(format(encodeMs)) µs/call (\(bpe.encode(sample).count) tokens)")
+    }
+
+    // MARK: - Post-processing
+
+    /// Sample dictated sentences (also used as filler text by other benchmarks)
+    private static let dictation = [
+        "um so I think we should ship it uh, tomorrow morning.",
+        "so the plan is , um , to wait .. and then? ? we go!!",
+        "我觉得 呃 这个方案可以。 嗯 明天再说吧 。",
+        "the um thing is   that er we er, forgot",
+        "えーと 今日は 晴れです。 あの 明日は 雨です。",
+        "음 오늘 회의 있어요? 어 네 있어요.",
+    ]
+
+    /// Cost of refreshing the preview after each of 300 segments: one-shot processing of the
+    /// whole transcript each time (how the regex chain scaled) vs. the incremental processor.
+    /// Parity with the regex chain is checked by TextPostProcessorTests.
+    private static func benchmarkPostProcess() {
+        print("── Post-processing ────────────────────")
+
+        let segments = (0..<300).map { i in dictation[i % dictation.count] }
+
+        let oneShotMs = measureMs {
+            for count in 1...segments.count {
+                _ = TextPostProcessor.process(segments[0..<count].joined(separator: " "))
+            }
+        }
+        let incrementalMs = measureMs {
+            let processor = TextPostProcessor()
+            for segment in segments {
+                processor.append(segment)
+                _ = processor.text
+            }
+        }
+        print("One-shot (300 segs):    \(format(oneShotMs)) ms")
+        print("Incremental (300 segs): \(format(incrementalMs)) ms")
+    }
+
+    // MARK: - Hotwords
+
+    /// Hotword recall and decode cost, greedy vs. biased beam search.
+    ///
+    /// The test set directory holds `hotwords.txt` (one word per line) and clips as
+    /// `<name>.wav` with the reference transcript in `<name>.txt`.
+    private static func benchmarkHotwords(testSetDir: String?, modelDir: String, assetsDir: String) {
+        print("── Hotwords ───────────────────────────")
+
+        guard let dir = testSetDir,
+              let list = try? String(contentsOfFile: "\(dir)/hotwords.txt", encoding: .utf8) else {
+            print("Usage: --benchmark hotwords <dir with hotwords.txt, *.wav and matching *.txt>")
+            return
+        }
+        let hotwords = list.split(whereSeparator: \.isNewline)
+            .map { $0.trimmingCharacters(in: .whitespaces) }
+            .filter { !$0.isEmpty }
+
+        guard let recognizer = HotwordRecognizer.load(modelDir: modelDir, assetsDir: assetsDir) else {
+            print("✗ SenseVoice model not available in \(modelDir)")
+            return
+        }
+        recognizer.setHotwords(hotwords)
+        let beamWidth = recognizer.decoder.beamWidth
+
+        let clips = ((try? FileManager.default.contentsOfDirectory(atPath: dir)) ?? [])
+            .filter { $0.hasSuffix(".wav") }
+            .sorted()
+
+        var audioSeconds = 0.0
+        var logitsMs = 0.0
+        var greedyMs = 0.0
+        var beamMs = 0.0
+        var expected = 0
+        var greedyHits = 0
+        var beamHits = 0
+        var greedyExtra = 0
+        var beamExtra = 0
+
+        for clip in clips {
+            let name = (clip as NSString).deletingPathExtension
+            guard let reference = try? String(contentsOfFile: "\(dir)/\(name).txt", encoding: .utf8),
+                  let samples = Transcriber.loadAudioFile(url: URL(fileURLWithPath: "\(dir)/\(clip)")) else {
+                print("⚠️ Skipping \(clip) (missing audio or reference)")
+                continue
+            }
+
+            var logits: CTCLogits?
+            logitsMs += measureMs { logits = recognizer.logits(for: samples) }
+            guard let clipLogits = logits else { continue }
+            audioSeconds += Double(samples.count) / 16000
+
+            // Beam width 1 takes the greedy fast path
+            var greedyLogits = clipLogits
+            var greedyText = ""
+            recognizer.decoder.beamWidth = 1
+            greedyMs += measureMs { greedyText = recognizer.decode(&greedyLogits) }
+
+            var beamLogits = clipLogits
+            var beamText = ""
+            recognizer.decoder.beamWidth = beamWidth
+            beamMs += measureMs { beamText = recognizer.decode(&beamLogits) }
+
+            for word in hotwords {
+                let inReference = occurrences(of: word, in: reference)
+                let inGreedy = occurrences(of: word, in: greedyText)
+                let inBeam = occurrences(of: word, in: beamText)
+                expected += inReference
+                greedyHits += min(inGreedy, inReference)
+                beamHits += min(inBeam, inReference)
+                greedyExtra += max(inGreedy - inReference, 0)
+                beamExtra += max(inBeam - inReference, 0)
+            }
+            if greedyText != beamText {
+                print("  \(name): \(greedyText)")
+                print("  \(String(repeating: " ", count: name.count))→ \(beamText)")
+            }
+        }
+
+        guard audioSeconds > 0 else {
+            print("✗ No usable clips in \(dir)")
+            return
+        }
+
+        print("Clips:                  \(clips.count) (\(format(audioSeconds)) s audio, \(hotwords.count) hotwords)")
+        print("Hotword recall greedy:  \(greedyHits)/\(expected) (\(greedyExtra) false alarms)")
+        print("Hotword recall biased:  \(beamHits)/\(expected) (\(beamExtra) false alarms)")
+        print("Logits extraction:      \(format(logitsMs / audioSeconds)) ms per audio second")
+        print("Greedy decode:          \(format(greedyMs / audioSeconds)) ms per audio second")
+        print("Beam decode (width \(beamWidth)):  \(format(beamMs / audioSeconds)) ms per audio second")
+        print("Added by beam search:   \(format((beamMs - greedyMs) / audioSeconds)) ms per audio second")
+    }
+
+    private static func occurrences(of word: String, in text: String) -> Int {
+        text.lowercased().components(separatedBy: word.lowercased()).count - 1
+    }
+
+    // MARK: - Corrections
+
+    /// 5,000 product names as mappings ("zor vex=Zorvex") and custom words, against
+    /// the previous approach of one `replacingOccurrences` per mapping
+    private static func benchmarkCorrections() {
+        print("── Corrections ────────────────────────")
+
+        // Deterministic pseudo-random names from syllables
+        var seed: UInt64 = 0x9E3779B97F4A7C15
+        func next(_ bound: Int) -> Int {
+            seed = seed &* 6364136223846793005 &+ 1442695040888963407
+            return Int((seed >> 33) % UInt64(bound))
+        }
+        let onsets = ["b", "d", "f", "g", "k", "l", "m", "n", "p", "r", "s", "t", "v", "z", "br", "kr", "tr", "st"]
+        let vowels = ["a", "e", "i", "o", "u"]
+        let codas = ["", "n", "r", "x", "l", "s", "m"]
+        func syllable() -> String { onsets[next(onsets.count)] + vowels[next(vowels.count)] + codas[next(codas.count)] }
+
+        var names: [String] = []
+        var seen = Set<String>()
+        while names.count < 5_000 {
+            let parts = [syllable(), syllable(), syllable()]
+            let name = parts.joined()
+            guard name.count >= 6, seen.insert(name).inserted else { continue }
+            names.append(name.prefix(1).uppercased() + name.dropFirst())
+        }
+        // ASR tends to split unknown names into words
+        let mappings = names.map { WordMapping(find: splitForm(of: $0), replace: $0) }
+
+        let fillers = "so we talked about the new release and then decided to move on with it today".split(separator: " ").map(String.init)
+        var segments: [(text: String, exact: String, nearMiss: String)] = []
+        for _ in 0..<200 {
+            var words = (0..<24).map { _ in fillers[next(fillers.count)] }
+            let exact = names[next(names.count)]
+            let nearMiss = names[next(names.count)]
+            words.insert(splitForm(of: exact), at: next(words.count))
+            words.insert(misheard(nearMiss), at: next(words.count))
+            segments.append((words.joined(separator: " "), exact, nearMiss))
+        }
+
+        let corrector = WordCorrector()
+        let compileMs = measureMs { _ = corrector.rules(mappings: mappings, customWords: names) }
+        let cachedMs = measureMs {
+            for _ in 0..<1_000 { _ = corrector.rules(mappings: mappings, customWords: names) }
+        }
+
+        let naiveMs = measureMs {
+            for segment in segments {
+                var text = segment.text
+                for mapping in mappings {
+                    text = text.replacingOccurrences(of: mapping.find, with: mapping.replace, options: .caseInsensitive)
+                }
+            }
+        }
+
+        var exactHits = 0
+        var nearMissHits = 0
+        let engineMs = measureMs {
+            for segment in segments {
+                let corrected = corrector.apply(segment.text, mappings: mappings, customWords: names)
+                if corrected.contains(segment.exact) { exactHits += 1 }
+                if corrected.contains(segment.nearMiss) { nearMissHits += 1 }
+            }
+        }
+
+        print("Rules:                  \(mappings.count) mappings + \(names.count) custom words")
+        print("Compile (on change):    \(format(compileMs)) ms")
+        print("Cache check:            \(format(cachedMs)) µs/call")
+        print("Per-mapping replace:    \(format(naiveMs / Double(segments.count))) ms/segment")
+        print("Correction engine:      \(format(engineMs / Double(segments.count))) ms/segment")
+        print("Exact mappings fixed:   \(exactHits)/\(segments.count)")
+        print("Near-misses fixed:      \(nearMissHits)/\(segments.count)")
+    }
+
+    /// "Zorvexal" → "zor vexal"
+    private static func splitForm(of name: String) -> String {
+        let lower = name.lowercased()
+        let middle = lower.index(lower.startIndex, offsetBy: lower.count / 2)
+        return "\(lower[..<middle]) \(lower[middle...])"
+    }
+
+    /// A phonetically close misspelling: swap one vowel for a similar-sounding one
+    private static func misheard(_ name: String) -> String {
+        let swaps: [Character: Character] = ["a": "o", "o": "a", "e": "i", "i": "e", "u": "o"]
+        var characters = Array(name.lowercased())
+        if let index = characters.indices.dropFirst().first(where: { swaps[characters[$0]] != nil }) {
+            characters[index] = swaps[characters[index]]!
+        }
+        return String(characters)
+    }
+
+    // MARK: - History
+
+    /// Append, reload and search a 20,000-entry history log
+    private static func benchmarkHistory() {
+        print("── History ────────────────────────────")
+
+        let dir = FileManager.default.temporaryDirectory.appendingPathComponent("voca-bench-\(UUID().uuidString)")
+        defer { try? FileManager.default.removeItem(at: dir) }
+        guard let store = HistoryStore(directory: dir) else {
+            print("✗ Could not create history store")
+            return
+        }
+
+        let sentences = dictation
+        let entryCount = 20_000
+        let appendMs = measureMs {
+            for i in 0..<entryCount {
+                let text = "\(sentences[i % sentences.count]) \(sentences[(i * 7) % sentences.count]) #\(i)"
+                store.append(text, hasAudio: false)
+            }
+        }
+        print("Append:                 \(format(appendMs * 1000 / Double(entryCount))) µs/entry")
+
+        var reopened: HistoryStore?
+        let loadMs = measureMs { reopened = HistoryStore(directory: dir) }
+        guard let history = reopened else { return }
+        let indexMs = measureMs { history.waitUntilIndexed() }
+        print("Reopen (headers only):  \(format(loadMs)) ms for \(history.count) entries")
+        print("Background index build: \(format(loadMs + indexMs)) ms after launch")
+
+        let queries = ["ship it", "tomorrow", "明天", "회의", "#19999", "#123", "no way", "天气不错", "not present anywhere"]
+        var hits = 0
+        let rounds = 100
+        let searchMs = measureMs {
+            for _ in 0..<rounds {
+                for query in queries { hits += history.search(query, limit: 20).count }
+            }
+        }
+        print("Search:                 \(format(searchMs * 1000 / Double(rounds * queries.count))) µs/query (\(hits / rounds) hits per round)")
+
+        var ordinals = (0..<1_000).map { ($0 * 7919) % history.count }
+        ordinals.shuffle()
+        let readMs = measureMs {
+            for ordinal in ordinals {
+                if let entry = history.entry(at: ordinal) { _ = history.text(of: entry) }
+            }
+        }
+        print("Lazy text read:         \(format(readMs * 1000 / Double(ordinals.count))) µs/entry")
+    }
+
+    // MARK: - Model Download
+
+    /// Fetch a synthetic model archive from a local HTTP stand-in: once with a dropped
+    /// connection and a simulated relaunch mid-way, then again cleanly over the installed copy
+    private static func benchmarkDownload() {
+        print("── Model download ─────────────────────")
+
+        let fm = FileManager.default
+        let root = fm.temporaryDirectory.appendingPathComponent("voca-bench-\(UUID().uuidString)")
+        defer { try? fm.removeItem(at: root) }
+        let folderName = "bench-model.mlmodelc"
+        let source = root.appendingPathComponent("source/\(folderName)")
+        let modelsDir = root.appendingPathComponent("models")
+        try? fm.createDirectory(at: source.appendingPathComponent("weights"), withIntermediateDirectories: true)
+        try? fm.createDirectory(at: modelsDir, withIntermediateDirectories: true)
+
+        // Incompressible weights plus compressible text, like a compiled CoreML model
+        var weights = Data(count: 48 << 20)
+        weights.withUnsafeMutableBytes { arc4random_buf($0.baseAddress, $0.count) }
+        let text = Data(String(repeating: dictation.joined(separator: "\n"), count: 2000).utf8)
+        let sourceFiles = ["weights/weight.bin": weights, "model.mil": text, "metadata.json": Data("{\"bench\":true}".utf8)]
+        for (path, data) in sourceFiles {
+            try? data.write(to: source.appendingPathComponent(path))
+        }
+
+        let archiveURL = root.appendingPathComponent("bench.zip")
+        let ditto = Process()
+        ditto.executableURL = URL(fileURLWithPath: "/usr/bin/ditto")
+        ditto.arguments = ["-c", "-k", "--keepParent", source.path, archiveURL.path]
+        try? ditto.run()
+        ditto.waitUntilExit()
+        guard ditto.terminationStatus == 0, let archive = try? Data(contentsOf: archiveURL) else {
+            print("✗ Could not build test archive")
+            return
+        }
+
+        let hashes = sourceFiles.mapValues { SHA256.hash(data: $0).map { String(format: "%02x", $0) }.joined() }
+        let manifest = ModelFetcher.Manifest(files: Dictionary(uniqueKeysWithValues: hashes.map { ("\(folderName)/\($0.key)", $0.value) }))
+        guard let server = LocalHTTPServer(), server.start(),
+              let manifestData = try? JSONEncoder().encode(manifest) else {
+            print("✗ Could not start local HTTP server")
+            return
+        }
+        defer { server.stop() }
+        server.serve(archive, at: "/bench.zip")
+        server.serve(manifestData, at: "/bench.manifest.json")
+        print("Archive:                \(format(Double(archive.count) / 1_048_576)) MB, \(sourceFiles.count) files")
+
+        func fetch(cancelAt cancelProgress: Double? = nil) -> (Result<URL, Error>?, Double) {
+            let fetcher = ModelFetcher(
+                archiveURL: server.baseURL.appendingPathComponent("bench.zip"),
+                manifestURL: server.baseURL.appendingPathComponent("bench.manifest.json"),
+                folderName: folderName,
+                modelsDirectory: modelsDir,
+                configuration: .ephemeral
+            )
+            var result: Result<URL, Error>?
+            var cancelled = false
+            fetcher.onProgress = { [weak fetcher] progress in
+                if let cancelProgress = cancelProgress, progress >= cancelProgress, !cancelled {
+                    cancelled = true
+                    fetcher?.cancel()
+                }
+            }
+            fetcher.onComplete = { result = $0 }
+            let ms = measureMs {
+                fetcher.start()
+                let deadline = Date().addingTimeInterval(120)
+                while result == nil && !cancelled && Date() < deadline {
+                    RunLoop.main.run(until: Date().addingTimeInterval(0.01))
+                }
+            }
+            // Let the cancellation settle before the next fetcher touches the partial state
+            RunLoop.main.run(until: Date().addingTimeInterval(0.2))
+            return (result, ms)
+        }
+
+        func verify() -> Bool {
+            sourceFiles.allSatisfy { path, data in
+                (try? Data(contentsOf: modelsDir.appendingPathComponent("\(folderName)/\(path)"))) == data
+            }
+        }
+
+        // Drop the first transfer at 30%, then "quit" at 70% and resume in a new fetcher
+        server.dropNextResponse(to: "/bench.zip", after: archive.count * 3 / 10)
+        _ = fetch(cancelAt: 0.7)
+        let (resumed, resumedMs) = fetch()
+        let resumedServed = server.bytesServed
+        guard case .success = resumed, verify() else {
+            print("✗ Resumed download failed: \(resumed.map { "\($0)" } ?? "timed out")")
+            return
+        }
+        print("Interrupted download:   ok, \(server.requestCount) requests, \(format(Double(resumedServed) / Double(archive.count))) × archive bytes sent")
+        print("  after relaunch:       \(format(resumedMs)) ms")
+
+        let servedBefore = server.bytesServed
+        let (clean, cleanMs) = fetch()
+        guard case .success = clean, verify() else {
+            print("✗ Clean download failed")
+            return
+        }
+        let megabytes = Double(server.bytesServed - servedBefore) / 1_048_576
+        print("Clean download:         \(format(cleanMs)) ms (\(format(megabytes / (cleanMs / 1000))) MB/s), replaced installed model")
+        print("Partial state removed:  \(!fm.fileExists(atPath: modelsDir.appendingPathComponent(".partial/\(folderName)").path))")
+    }
+
+    // MARK: - Model Switching
+
+    /// Cold and warm switch latency, resident memory per model, switching during a
+    /// transcription, and LRU eviction under a tight budget
+    private static func benchmarkModels(audioPath: String?, modelDir: String, assetsDir: String) {
+        print("── Model switching ────────────────────")
+
+        let downloaded = ASRModel.availableModels.filter { ModelManager.shared.isModelDownloaded($0) }
+        guard let first = downloaded.first else {
+            print("✗ No models downloaded in \(modelDir)")
+            return
+        }
+        let samples = audioPath.flatMap { Transcriber.loadAudioFile(url: URL(fileURLWithPath: $0)) }
+            ?? (0..<(10 * 16000)).map { Float(sin(Double($0) * 0.05)) * 0.1 }
+        let audio = KotlinFloatArray(size: Int32(samples.count))
+        for (index, sample) in samples.enumerated() {
+            audio.set(index: Int32(index), value: sample)
+        }
+
+        let registry = ModelRegistry(modelDir: modelDir, assetsDir: assetsDir, initial: first, memoryBudget: .max)
+        for model in downloaded {
+            let coldMs = measureMs {
+                registry.setActive(model)
+                registry.waitUntilIdle()
+            }
+            let resident = registry.stats().first { $0.model == model }
+            print("\(model.rawValue.padding(toLength: 12, withPad: " ", startingAt: 0)) cold switch \(format(coldMs)) ms, resident ~\((resident?.residentBytes ?? 0) >> 20) MB")
+        }
+
+        let rounds = 1000
+        let warmMs = measureMs {
+            for i in 0..<rounds {
+                registry.setActive(downloaded[i % downloaded.count])
+            }
+        }
+        print("Warm switch:            \(format(warmMs * 1000 / Double(rounds))) µs")
+
+        // Switch away while a transcription holds the previous model
+        registry.setActive(first)
+        guard let running = registry.recognizer() else { return }
+        let done = DispatchSemaphore(value: 0)
+        var transcribeMs = 0.0
+        var text: String?
+        DispatchQueue.global(qos: .userInitiated).async {
+            transcribeMs = measureMs { text = running.recognizer.transcribe(audio: audio) }
+            done.signal()
+        }
+        Thread.sleep(forTimeInterval: 0.05)
+        let target = downloaded.last!
+        let switchMs = measureMs { registry.setActive(target) }
+        done.wait()
+        print("Switch during transcription: call \(format(switchMs * 1000)) µs, in-flight \(running.model.rawValue) finished in \(format(transcribeMs)) ms (\(text == nil ? "no text" : "ok"))")
+        registry.waitUntilIdle()
+        print("Active after switch:    \(registry.activeModel.rawValue)")
+
+        // A budget smaller than any model keeps only the active one resident
+        let tight = ModelRegistry(modelDir: modelDir, assetsDir: assetsDir, initial: first, memoryBudget: 1 << 20)
+        for model in downloaded {
+            tight.setActive(model)
+            tight.waitUntilIdle()
+        }
+        let resident = tight.stats().map(\.model.rawValue).joined(separator: ", ")
+        print("Resident at 1 MB budget: \(resident) (of \(downloaded.count) loaded)")
+    }
+
+    // MARK: - ONNX Backend
+
+    /// Multi-file throughput of SenseVoice on ONNX Runtime as sessions scale with cores,
+    /// against the CoreML engine run serially
+    private static func benchmarkONNX(audioDir: String?, modelDir: String, assetsDir: String) {
+        print("── ONNX backend ───────────────────────")
+
+        var clips: [[Float]] = []
+        if let dir = audioDir, let names = try? FileManager.default.contentsOfDirectory(atPath: dir) {
+            for name in names.sorted() where ["wav", "m4a", "mp3", "caf"].contains((name as NSString).pathExtension.lowercased()) {
+                if let samples = Transcriber.loadAudioFile(url: URL(fileURLWithPath: dir).appendingPathComponent(name)) {
+                    clips.append(samples)
+                }
+            }
+        }
+        if clips.isEmpty {
+            clips = (0..<16).map { clip in
+                (0..<(8 * 16000)).map { Float(sin(Double($0) * (0.03 + 0.002 * Double(clip)))) * 0.1 }
+            }
+        }
+        let audio: [KotlinFloatArray] = clips.map { samples in
+            let array = KotlinFloatArray(size: Int32(samples.count))
+            for (index, sample) in samples.enumerated() {
+                array.set(index: Int32(index), value: sample)
+            }
+            return array
+        }
+        let audioSeconds = Double(clips.reduce(0) { $0 + $1.count }) / 16000
+        print("Workload: \(clips.count) files, \(format(audioSeconds)) s of audio")
+
+        let engine = ASREngine(modelDir: modelDir, assetsDir: assetsDir)
+        if engine.initialize() {
+            _ = engine.transcribe(audio: audio[0])
+            let coreMLMs = measureMs { audio.forEach { _ = engine.transcribe(audio: $0) } }
+            print("CoreML (serial):    \(format(coreMLMs)) ms, \(format(audioSeconds * 1000 / coreMLMs))× realtime")
+        }
+
+        let cores = ProcessInfo.processInfo.activeProcessorCount
+        let sessionCounts = [1, 2, 4, 8, 16].filter { $0 <= cores }
+        var baselineMs: Double?
+        for sessions in sessionCounts {
+            var recognizer: ONNXSenseVoice?
+            let loadMs = measureMs {
+                recognizer = ONNXSenseVoice.load(modelsDir: "\(modelDir)/\(ONNXSenseVoice.folderName)",
+                                                 assetsDir: assetsDir, sessions: sessions)
+            }
+            guard let onnx = recognizer else {
+                print("✗ SenseVoice ONNX model not available in \(modelDir)/\(ONNXSenseVoice.folderName)")
+                return
+            }
+            _ = onnx.transcribe(audio: audio[0])
+
+            let wallMs = measureMs {
+                DispatchQueue.concurrentPerform(iterations: audio.count) { index in
+                    _ = onnx.transcribe(audio: audio[index])
+                }
+            }
+            let speedup = (baselineMs ?? wallMs) / wallMs
+            baselineMs = baselineMs ?? wallMs
+            print("ONNX \(sessions) session(s):  \(format(wallMs)) ms, \(format(audioSeconds * 1000 / wallMs))× realtime, "
+                + "\(format(speedup))× vs 1 session (load \(format(loadMs)) ms)")
+        }
+        print("Cores: \(cores)")
+    }
+
+    // MARK: - Chunk Seams
+
+    /// Word errors per seam for hard cuts vs overlap-and-merge: on simulated chunk outputs
+    /// (edge words garbled or dropped, jittered timestamps), and on concatenated clips
+    /// against the clips transcribed one by one
+    private static func benchmarkSeams(clipDir: String?, modelDir: String, assetsDir: String) {
+        print("── Chunk seams ────────────────────────")
+
+        var random = SystemRandomNumberGenerator()
+        let english = ["the", "model", "speech", "chunk", "seam", "word", "merge", "audio", "river", "stone", "light", "voice"]
+        let chinese = "我们今天讨论语音识别模型的性能问题".map(String.init)
+        let chunker = OverlapChunker(chunkSeconds: 20, overlapSeconds: 2)
+
+        for (name, chineseShare) in [("English", 0.0), ("Chinese", 1.0), ("Mixed", 0.5)] {
+            var hardErrors = 0, timedErrors = 0, textErrors = 0, seams = 0
+            for _ in 0..<20 {
+                // 400 words with realistic durations and pauses
+                var words: [TimedWord] = []
+                var time = 0.2
+                for _ in 0..<400 {
+                    let text = Double.random(in: 0..<1, using: &random) < chineseShare
+                        ? chinese.randomElement(using: &random)! : english.randomElement(using: &random)!
+                    let duration = WordTiming.isCJK(text.unicodeScalars.first!) ? 0.12 : 0.3
+                    words.append(TimedWord(text: text, start: time, end: time + duration))
+                    time += duration + [0.02, 0.05, 0.1].randomElement(using: &random)!
+                }
+                let reference = seamUnits(simulatedTranscript(words, from: 0, to: time, random: &random).text)
+                let sampleRate = 100
+                let ranges = chunker.ranges(sampleCount: Int(time * Double(sampleRate)), sampleRate: sampleRate)
+                seams += ranges.count - 1
+
+                for timed in [true, false] {
+                    let chunks = ranges.map { range -> OverlapChunker.Chunk in
+                        let start = Double(range.lowerBound) / Double(sampleRate)
+                        let end = Double(range.upperBound) / Double(sampleRate)
+                        var transcript = simulatedTranscript(words, from: start, to: end, random: &random)
+                        if !timed {
+                            transcript.words = []
+                        }
+                        return OverlapChunker.Chunk(start: start, end: end, transcript: transcript)
+                    }
+                    let errors = editDistance(reference, seamUnits(OverlapChunker.merge(chunks).text))
+                    if timed { timedErrors += errors } else { textErrors += errors }
+                }
+
+                // Same number of cuts, no overlap, texts joined with a space
+                let cut = time / Double(ranges.count)
+                let hard = (0..<ranges.count).map {
+                    simulatedTranscript(words, from: Double($0) * cut, to: Double($0 + 1) * cut, random: &random).text
+                }
+                hardErrors += editDistance(reference, seamUnits(hard.joined(separator: " ")))
+            }
+            let perSeam = { (errors: Int) in format(Double(errors) / Double(max(seams, 1))) }
+            print("\(name.padding(toLength: 8, withPad: " ", startingAt: 0)) word errors/seam: hard cut \(perSeam(hardErrors)), "
+                + "overlap+timing \(perSeam(timedErrors)), overlap+text \(perSeam(textErrors))")
+        }
+
+        // Real speech: clips concatenated back to back, so chunk edges land mid-word
+        guard let dir = clipDir, let names = try? FileManager.default.contentsOfDirectory(atPath: dir) else {
+            print("(pass a directory of short speech clips to also measure real transcripts)")
+            return
+        }
+        let clips = names.sorted()
+            .filter { ["wav", "m4a", "mp3", "caf"].contains(($0 as NSString).pathExtension.lowercased()) }
+            .compactMap { Transcriber.loadAudioFile(url: URL(fileURLWithPath: dir).appendingPathComponent($0)) }
+        guard !clips.isEmpty else {
+            print("✗ No audio clips in \(dir)")
+            return
+        }
+
+        let registry = ModelRegistry(modelDir: modelDir, assetsDir: assetsDir, initial: .senseVoice)
+        let transcriber = Transcriber(models: registry)
+        let reference = clips.compactMap { transcriber.transcribe(samples: $0, chunking: .silence).text }.joined(separator: " ")
+        var long: [Float] = []
+        while long.count < 5 * 60 * 16000 {
+            for clip in clips {
+                long += clip
+            }
+        }
+        let repeats = long.count / clips.reduce(0) { $0 + $1.count }
+        let expected = seamUnits(Array(repeating: reference, count: repeats).joined(separator: " "))
+        print("Concatenated: \(clips.count) clips × \(repeats), \(format(Double(long.count) / 16000)) s")
+
+        let modes: [(String, Transcriber.Chunking)] = [
+            ("60 s VAD/hard cut", .silence),
+            ("20 s + 2 s overlap", .overlapping(OverlapChunker(chunkSeconds: 20, overlapSeconds: 2))),
+            ("10 s + 2 s overlap", .overlapping(OverlapChunker(chunkSeconds: 10, overlapSeconds: 2))),
+        ]
+        for (name, mode) in modes {
+            var result: TranscriptionResult?
+            let ms = measureMs { result = transcriber.transcribe(samples: long, chunking: mode) }
+            let errors = editDistance(expected, seamUnits(result?.text ?? ""))
+            print("\(name.padding(toLength: 20, withPad: " ", startingAt: 0)) \(errors) word errors "
+                + "(\(format(100 * Double(errors) / Double(max(expected.count, 1))))%), \(format(ms)) ms")
+        }
+    }
+
+    /// What a model would return for [from, to): words cut by an edge are garbled or dropped,
+    /// timestamps jitter by up to 40 ms
+    private static func simulatedTranscript(_ words: [TimedWord], from start: TimeInterval, to end: TimeInterval,
+                                            random: inout SystemRandomNumberGenerator) -> TimedTranscript {
+        var heard: [TimedWord] = []
+        for word in words where word.end > start && word.start < end {
+            var text = word.text
+            if word.start < start || word.end > end {
+                guard Bool.random(using: &random) else { continue }
+                text = WordTiming.isCJK(text.unicodeScalars.first!) ? text : String(text.prefix(max(1, text.count / 2))) + "x"
+            }
+            let jitter = Double.random(in: -0.04...0.04, using: &random)
+            heard.append(TimedWord(text: text, start: word.start + jitter, end: word.end + jitter))
+        }
+        var text = ""
+        for word in heard {
+            let previous = text.unicodeScalars.last
+            if let previous = previous, !WordTiming.isCJK(previous), !WordTiming.isCJK(word.text.unicodeScalars.first!) {
+                text += " "
+            }
+            text += word.text
+        }
+        return TimedTranscript(text: text, words: heard)
+    }
+
+    /// Words for error counting: whitespace-separated, CJK characters one by one, no punctuation
+    private static func seamUnits(_ text: String) -> [String] {
+        var units: [String] = []
+        for token in text.lowercased().split(whereSeparator: { $0.isWhitespace }) {
+            var word = ""
+            for scalar in token.unicodeScalars where !scalar.properties.generalCategory.isPunctuation {
+                if WordTiming.isCJK(scalar) {
+                    if !word.isEmpty { units.append(word) }
+                    units.append(String(scalar))
+                    word = ""
+                } else {
+                    word.unicodeScalars.append(scalar)
+                }
+            }
+            if !word.isEmpty { units.append(word) }
+        }
+        return units
+    }
+
+    private static func editDistance(_ a: [String], _ b: [String]) -> Int {
+        guard !a.isEmpty else { return b.count }
+        var row = Array(0...b.count)
+        for i in 1...a.count {
+            var diagonal = row[0]
+            row[0] = i
+            for j in stride(from: 1, through: b.count, by: 1) {
+                let above = row[j]
+                row[j] = min(above + 1, row[j - 1] + 1, diagonal + (a[i - 1] == b[j - 1] ? 0 : 1))
+                diagonal = above
+            }
+        }
+        return row[b.count]
+    }
+
+    // MARK: - Audio Front-End
+
+    /// CPU cost of the front-end, and what it saves downstream: speech segments cut from
+    /// 60 s of speech bursts in pink noise at several input levels, raw vs cleaned. A call
+    /// holding no speech is wasted ASR work. With a directory of speech clips (used as the
+    /// speech) the segments are also transcribed and empty results counted.
+    private static func benchmarkFrontEnd(clipDir: String?, modelDir: String, assetsDir: String) {
+        print("── Audio front-end ────────────────────")
+
+        var random = SystemRandomNumberGenerator()
+        var clips: [[Float]] = []
+        if let dir = clipDir, let names = try? FileManager.default.contentsOfDirectory(atPath: dir) {
+            clips = names.sorted()
+                .filter { ["wav", "m4a", "mp3", "caf"].contains(($0 as NSString).pathExtension.lowercased()) }
+                .compactMap { Transcriber.loadAudioFile(url: URL(fileURLWithPath: dir).appendingPathComponent($0)) }
+        }
+        let transcriber = clips.isEmpty ? nil
+            : Transcriber(models: ModelRegistry(modelDir: modelDir, assetsDir: assetsDir, initial: .senseVoice))
+
+        let sampleRate = 16000
+        let block = 1600  // 100 ms, about one tap buffer
+        let scenarios: [(name: String, speech: Float, noise: Float)] = [
+            ("Quiet room", 0.05, 0.005),
+            ("Noisy room", 0.05, 0.03),
+            ("Quiet mic", 0.012, 0.003),
+            ("Hot mic", 0.3, 0.05),
+        ]
+
+        var cpuMs = 0.0
+        var cpuSeconds = 0.0
+        for scenario in scenarios {
+            // Bursts of speech separated by 1.5–3 s pauses, over pink noise
+            let total = 60 * sampleRate
+            var signal = pinkNoise(count: total, random: &random).map { $0 * scenario.noise }
+            var isSpeech = [Bool](repeating: false, count: total)
+            var position = 3 * sampleRate / 2
+            var clipIndex = 0
+            while position < total - 4 * sampleRate {
+                let burst = clips.isEmpty
+                    ? voicedBurst(count: Int(Double.random(in: 1.5...4, using: &random) * Double(sampleRate)))
+                    : clips[clipIndex % clips.count]
+                clipIndex += 1
+                let length = min(burst.count, total - position)
+                let rms = (burst.reduce(0) { $0 + $1 * $1 } / Float(max(burst.count, 1))).squareRoot()
+                let scale = rms > 0 ? scenario.speech / rms : 0
+                for i in 0..<length {
+                    signal[position + i] += burst[i] * scale
+                    isSpeech[position + i] = true
+                }
+                position += length + Int(Double.random(in: 1.5...3, using: &random) * Double(sampleRate))
+            }
+
+            var cleaned: [Float] = []
+            cleaned.reserveCapacity(total + 2 * AudioFrontEnd.hopSize)
+            let frontEnd = AudioFrontEnd()
+            cpuMs += measureMs {
+                for start in stride(from: 0, to: total, by: block) {
+                    frontEnd.process(Array(signal[start..<min(start + block, total)]), into: &cleaned)
+                }
+                frontEnd.flush(into: &cleaned)
+            }
+            cpuSeconds += Double(total) / Double(sampleRate)
+            cleaned = Array(cleaned[AudioFrontEnd.latency..<(AudioFrontEnd.latency + total)])
+
+            print("\(scenario.name) (speech \(format(Double(scenario.speech))), noise \(format(Double(scenario.noise))) RMS):")
+            for (label, audio) in [("raw", signal), ("front-end", cleaned)] {
+                var segmenter = SpeechSegmenter()
+                var segments: [SpeechSegmenter.Segment] = []
+                for start in stride(from: 0, to: total, by: block) {
+                    let samples = Array(audio[start..<min(start + block, total)])
+                    let rms = (samples.reduce(0) { $0 + $1 * $1 } / Float(samples.count)).squareRoot()
+                    if let segment = segmenter.append(samples, rms: rms) {
+                        segments.append(segment)
+                    }
+                }
+                if let segment = segmenter.finish() {
+                    segments.append(segment)
+                }
+
+                var wasted = 0
+                var noiseSamples = 0
+                var coveredSpeech = 0
+                for segment in segments {
+                    let speech = isSpeech[segment.start..<(segment.start + segment.samples.count)].filter { $0 }.count
+                    wasted += speech == 0 ? 1 : 0
+                    noiseSamples += segment.samples.count - speech
+                    coveredSpeech += speech
+                }
+                var line = "  \(label.padding(toLength: 10, withPad: " ", startingAt: 0)) \(segments.count) ASR calls, "
+                    + "\(wasted) without speech, \(format(Double(noiseSamples) / Double(sampleRate))) s of noise sent, "
+                    + "\(format(100 * Double(coveredSpeech) / Double(max(isSpeech.filter { $0 }.count, 1))))% of speech covered"
+                if let transcriber = transcriber {
+                    let empty = segments.filter {
+                        (transcriber.transcribe(samples: $0.samples, chunking: .silence).text ?? "").isEmpty
+                    }.count
+                    line += ", \(empty) empty transcripts"
+                }
+                print(line)
+            }
+        }
+        print("CPU: \(format(cpuMs / cpuSeconds)) ms per second of audio (\(format(cpuSeconds * 1000 / cpuMs))× realtime)")
+    }
+
+    /// Pink noise (Kellet's economy filter) at unit RMS
+    private static func pinkNoise(count: Int, random: inout SystemRandomNumberGenerator) -> [Float] {
+        var b0: Float = 0, b1: Float = 0, b2: Float = 0
+        var noise = (0..<count).map { _ -> Float in
+            let white = Float.random(in: -1...1, using: &random) * 1.7320508  // unit variance
+            b0 = 0.99765 * b0 + white * 0.0990460
+            b1 = 0.96300 * b1 + white * 0.2965164
+            b2 = 0.57000 * b2 + white * 1.0526913
+            return b0 + b1 + b2 + white * 0.1848
+        }
+        let rms = (noise.reduce(0) { $0 + $1 * $1 } / Float(max(count, 1))).squareRoot()
+        if rms > 0 {
+            noise = noise.map { $0 / rms }
+        }
+        return noise
+    }
+
+    /// Speech-like stand-in: a gliding 140 Hz harmonic series, syllable-rate (4 Hz) envelope
+    private static func voicedBurst(count: Int) -> [Float] {
+        var phase = 0.0
+        return (0..<count).map { index in
+            let time = Double(index) / 16000
+            phase += 2 * Double.pi * (140 + 30 * sin(2 * Double.pi * 0.7 * time)) / 16000
+            var value = 0.0
+            for harmonic in 1...24 {
+                value += sin(Double(harmonic) * phase) / Double(harmonic)
+            }
+            return Float(value * max(sin(2 * Double.pi * 4 * time), 0).squareRoot())
+        }
+    }
+
+    // MARK: - Segment Confidence
+
+    /// Skipped work from confidence gating on real dictation: the history's recordings (or
+    /// `recordingsDir`) are cut into segments as during recording, each is fully decoded, and
+    /// each threshold is scored on the encoder/decoder time it would save and the segments
+    /// with text it would lose
+    private static func benchmarkConfidence(recordingsDir: String?, modelDir: String, assetsDir: String) {
+        print("── Segment confidence ─────────────────")
+
+        let dir = recordingsDir.map { URL(fileURLWithPath: $0) }
+            ?? FileManager.default.urls(for: .applicationSupportDirectory, in: .userDomainMask)[0]
+                .appendingPathComponent("Voca/recordings")
+        let names = ((try? FileManager.default.contentsOfDirectory(atPath: dir.path)) ?? [])
+            .filter { ["wav", "m4a", "mp3", "caf"].contains(($0 as NSString).pathExtension.lowercased()) }
+            .sorted()
+        guard !names.isEmpty else {
+            print("✗ No recordings in \(dir.path)")
+            return
+        }
+        guard let recognizer = HotwordRecognizer.load(modelDir: modelDir, assetsDir: assetsDir) else {
+            print("✗ SenseVoice CoreML model not available in \(modelDir)")
+            return
+        }
+        let detector = SpeechDetector.load(modelDir: modelDir)
+        if detector == nil {
+            print("(no \(SpeechDetector.modelName) in \(modelDir): CTC signal only)")
+        }
+
+        struct Measured {
+            let vadProbability: Float?
+            let nonBlankRatio: Float
+            let vadMs: Double
+            let encoderMs: Double
+            let decodeMs: Double
+            let hasText: Bool
+        }
+        var measured: [Measured] = []
+        for name in names {
+            guard let samples = Transcriber.loadAudioFile(url: dir.appendingPathComponent(name)) else { continue }
+            var segmenter = SpeechSegmenter()
+            var segments: [[Float]] = []
+            for start in stride(from: 0, to: samples.count, by: 1600) {
+                let block = Array(samples[start..<min(start + 1600, samples.count)])
+                let rms = (block.reduce(0) { $0 + $1 * $1 } / Float(block.count)).squareRoot()
+                if let segment = segmenter.append(block, rms: rms) {
+                    segments.append(segment.samples)
+                }
+            }
+            if let segment = segmenter.finish() {
+                segments.append(segment.samples)
+            }
+
+            for segment in segments {
+                var vadProbability: Float?
+                let vadMs = measureMs { vadProbability = detector?.peakProbability(segment) }
+                var logits: CTCLogits?
+                let encoderMs = measureMs { logits = recognizer.logits(for: segment) }
+                guard var output = logits else { continue }
+                let nonBlankRatio = output.nonBlankRatio(from: Int(WordTiming.queryFrames))
+                var text = ""
+                let decodeMs = measureMs {
+                    text = recognizer.decodeTimed(&output).text
+                        .replacingOccurrences(of: "<\\|[^|]+\\|>", with: "", options: .regularExpression)
+                        .trimmingCharacters(in: .whitespacesAndNewlines.union(.punctuationCharacters))
+                }
+                measured.append(Measured(vadProbability: vadProbability, nonBlankRatio: nonBlankRatio, vadMs: vadMs,
+                                         encoderMs: encoderMs, decodeMs: decodeMs, hasText: !text.isEmpty))
+            }
+        }
+
+        let fullMs = measured.reduce(0) { $0 + $1.encoderMs + $1.decodeMs }
+        let empty = measured.filter { !$0.hasText }.count
+        print("\(names.count) recordings, \(measured.count) segments, \(empty) with no text; "
+            + "encoder+decode \(format(fullMs)) ms")
+
+        for threshold: Float in [0.05, 0.1, 0.15, 0.25, 0.4] {
+            var skipped = 0, lost = 0
+            var savedMs = 0.0
+            for segment in measured {
+                savedMs -= segment.vadMs
+                if SpeechConfidence(vadProbability: segment.vadProbability).score < threshold {
+                    savedMs += segment.encoderMs + segment.decodeMs
+                } else if SpeechConfidence(vadProbability: segment.vadProbability,
+                                           nonBlankRatio: segment.nonBlankRatio).score < threshold {
+                    savedMs += segment.decodeMs
+                } else {
+                    continue
+                }
+                skipped += 1
+                lost += segment.hasText ? 1 : 0
+            }
+            print("threshold \(format(Double(threshold))): skipped \(skipped)/\(measured.count) segments "
+                + "(\(format(100 * Double(skipped) / Double(max(measured.count, 1))))%), "
+                + "work saved \(format(100 * savedMs / max(fullMs, 1)))%, segments with text lost \(lost)")
+        }
+    }
+
+    // MARK: - Tracing
+
+    /// Cost of instrumentation: per span off and on, and on the capture path (48 kHz tap
+    /// buffers through resampler and front-end, spanned as in AudioRecorder) and, with an
+    /// audio file, a full transcription
+    private static func benchmarkTrace(audioPath: String?, modelDir: String, assetsDir: String) {
+        print("── Tracing ────────────────────────────")
+        #if VOCA_NO_TRACING
+        print("(compiled out with VOCA_NO_TRACING: every call is a no-op)")
+        #endif
+        let wasEnabled = Trace.isEnabled
+        defer { if !wasEnabled { Trace.stop() } }
+
+        let iterations = 1_000_000
+        Trace.stop()
+        let offMs = measureMs { for _ in 0..<iterations { Trace.end(Trace.begin(.decode)) } }
+        Trace.start(snapshotInterval: 0)
+        let onMs = measureMs { for _ in 0..<iterations { Trace.end(Trace.begin(.decode)) } }
+        print("Span: \(format(offMs * 1e6 / Double(iterations))) ns off, \(format(onMs * 1e6 / Double(iterations))) ns on")
+
+        // 60 s of 48 kHz input in 4096-frame tap buffers
+        let input = (0..<(60 * 48000)).map { Float(sin(Double($0) * 0.05)) * 0.1 + Float.random(in: -0.01...0.01) }
+        func capture(traced: Bool) -> Double {
+            if traced { Trace.start(snapshotInterval: 0) } else { Trace.stop() }
+            let resampler = Resampler(inputRate: 48000, outputRate: 16000)
+            let frontEnd = AudioFrontEnd()
+            var resampled: [Float] = []
+            var cleaned: [Float] = []
+            return measureMs {
+                for start in stride(from: 0, to: input.count, by: 4096) {
+                    let span = Trace.begin(.capture)
+                    resampled.removeAll(keepingCapacity: true)
+                    cleaned.removeAll(keepingCapacity: true)
+                    Trace.span(.resample) {
+                        resampler.process(Array(input[start..<min(start + 4096, input.count)]), into: &resampled)
+                    }
+                    Trace.span(.frontEnd) { frontEnd.process(resampled, into: &cleaned) }
+                    Trace.end(span)
+                }
+            }
+        }
+        _ = capture(traced: false)
+        let captureOff = (0..<5).map { _ in capture(traced: false) }.min()!
+        let captureOn = (0..<5).map { _ in capture(traced: true) }.min()!
+        print("Capture path (60 s): \(format(captureOff)) ms off, \(format(captureOn)) ms on "
+            + "(\(format(100 * (captureOn - captureOff) / captureOff))% overhead)")
+
+        guard let path = audioPath, let samples = Transcriber.loadAudioFile(url: URL(fileURLWithPath: path)) else {
+            print("(pass an audio file to also measure a full transcription)")
+            return
+        }
+        let transcriber = Transcriber(models: ModelRegistry(modelDir: modelDir, assetsDir: assetsDir, initial: .senseVoice))
+        _ = transcriber.transcribe(samples: samples)
+        func transcription(traced: Bool) -> Double {
+            if traced { Trace.start(snapshotInterval: 0) } else { Trace.stop() }
+            return measureMs { _ = transcriber.transcribe(samples: samples) }
+        }
+        let transcribeOff = (0..<3).map { _ in transcription(traced: false) }.min()!
+        let transcribeOn = (0..<3).map { _ in transcription(traced: true) }.min()!
+        print("Transcription (\(format(Double(samples.count) / 16000)) s): \(format(transcribeOff)) ms off, "
+            + "\(format(transcribeOn)) ms on (\(format(100 * (transcribeOn - transcribeOff) / transcribeOff))% overhead)")
+        print(Trace.snapshot().summary)
+    }
+
+    // MARK: - Transcription Server
+
+    /// Latency and throughput of one load level
+    private struct LoadRun {
+        var segmentMs: [Double] = []
+        var finalMs: [Double] = []
+        var audioSeconds = 0.0
+        var refused = 0
+        var failed = 0
+    }
+
+    /// Load test of the transcription server: 1 to 64 clients each stream the clip in real
+    /// time (100 ms frames) over the Unix socket. Reports aggregate throughput, latency from
+    /// a segment becoming complete (its trailing silence sent) to its result, latency from
+    /// end of stream to the final transcript, batch sizes, and admission past the limit.
+    private static func benchmarkServer(audioPath: String?, modelDir: String, assetsDir: String) {
+        print("── Transcription server ───────────────")
+
+        // Without a file: speech-like bursts with pauses long enough to end each segment
+        let samples = audioPath.flatMap { Transcriber.loadAudioFile(url: URL(fileURLWithPath: $0)) }
+            ?? (0..<5).flatMap { _ in voicedBurst(count: 3 * 16000).map { $0 * 0.2 } + [Float](repeating: 0, count: 2 * 16000) }
+        let clip = Array(samples.prefix(30 * 16000))
+
+        let path = FileManager.default.temporaryDirectory.appendingPathComponent("voca-\(getpid()).sock").path
+        let models = ModelRegistry(modelDir: modelDir, assetsDir: assetsDir, initial: .senseVoice)
+        let server = TranscriptionServer(path: path, transcriber: Transcriber(models: models), models: models)
+        guard models.recognizer() != nil else {
+            print("✗ No ASR model available in \(modelDir)")
+            return
+        }
+        guard server.start() else { return }
+        defer { server.stop() }
+        print("Clip: \(format(Double(clip.count) / 16000)) s, cores: \(ProcessInfo.processInfo.activeProcessorCount)")
+
+        for streams in [1, 2, 4, 8, 16, 32, 64, server.limits.maxSessions + 8] {
+            let before = server.stats
+            var run = LoadRun()
+            let wallMs = measureMs { run = streamClients(streams, clip: clip, path: path) }
+            let after = server.stats
+            let batches = after.batches - before.batches
+            let meanBatch = batches == 0 ? 0 : Double(after.batchedSegments - before.batchedSegments) / Double(batches)
+
+            print("\(String(streams).padding(toLength: 3, withPad: " ", startingAt: 0)) streams: "
+                + "\(format(run.audioSeconds * 1000 / wallMs))× realtime, "
+                + "segment p50/p95/p99 \(format(percentile(run.segmentMs, 50)))/\(format(percentile(run.segmentMs, 95)))/"
+                + "\(format(percentile(run.segmentMs, 99))) ms, "
+                + "final p50/p99 \(format(percentile(run.finalMs, 50)))/\(format(percentile(run.finalMs, 99))) ms, "
+                + "batch \(batches == 0 ? "-" : format(meanBatch)), refused \(run.refused), failed \(run.failed)")
+        }
+    }
+
+    /// Run `count` concurrent real-time streams of `clip` to completion
+    private static func streamClients(_ count: Int, clip: [Float], path: String) -> LoadRun {
+        let frame = 1600
+        let silenceDuration = SpeechSegmenter().silenceDuration
+        let lock = NSLock()
+        var run = LoadRun()
+        let group = DispatchGroup()
+
+        for stream in 0..<count {
+            group.enter()
+            Thread {
+                defer { group.leave() }
+                // Send time of every frame, to date each result from when its segment was complete
+                var sent: [UInt64] = []
+                let sentLock = NSLock()
+                let client: TranscriptionClient
+                do {
+                    client = try TranscriptionClient(path: path) { result in
+                        let now = DispatchTime.now().uptimeNanoseconds
+                        let completeFrame = Int((result.end + silenceDuration) * 16000) / frame
+                        sentLock.lock()
+                        let completeAt = sent.isEmpty ? now : sent[min(completeFrame, sent.count - 1)]
+                        sentLock.unlock()
+                        lock.lock()
+                        run.segmentMs.append(Double(now - completeAt) / 1e6)
+                        lock.unlock()
+                    }
+                } catch TranscriptionClient.ClientError.refused {
+                    lock.lock()
+                    run.refused += 1
+                    lock.unlock()
+                    return
+                } catch {
+                    print("✗ Stream \(stream): \(error.localizedDescription)")
+                    lock.lock()
+                    run.failed += 1
+                    lock.unlock()
+                    return
+                }
+
+                let start = DispatchTime.now().uptimeNanoseconds
+                for (index, offset) in stride(from: 0, to: clip.count, by: frame).enumerated() {
+                    let due = start + UInt64(index) * 100_000_000
+                    let now = DispatchTime.now().uptimeNanoseconds
+                    if due > now {
+                        usleep(useconds_t((due - now) / 1000))
+                    }
+                    sentLock.lock()
+                    sent.append(DispatchTime.now().uptimeNanoseconds)
+                    sentLock.unlock()
+                    guard client.send(Array(clip[offset..<min(offset + frame, clip.count)])) else { break }
+                }
+
+                let ended = DispatchTime.now().uptimeNanoseconds
+                let transcript = client.finish()
+                let finalMs = Double(DispatchTime.now().uptimeNanoseconds - ended) / 1e6
+                lock.lock()
+                if let transcript = transcript {
+                    run.finalMs.append(finalMs)
+                    run.audioSeconds += transcript.end
+                } else {
+                    run.failed += 1
+                }
+                lock.unlock()
+            }.start()
+        }
+        group.wait()
+        return run
+    }
+
+    // MARK: - Streaming
+
+    /// Streaming SenseVoice fed 85 ms capture blocks: first-partial latency (audio that had
+    /// to arrive plus compute), partial cadence, compute per audio second as a 60 s utterance
+    /// grows, and the final text against a whole-utterance decode of the same clip
+    private static func benchmarkStreaming(audioPath: String?, modelDir: String, assetsDir: String) {
+        print("── Streaming ──────────────────────────")
+        guard let engine = ONNXSenseVoice.load(modelsDir: "\(modelDir)/\(ONNXSenseVoice.folderName)",
+                                               assetsDir: assetsDir, sessions: 1) else {
+            print("✗ SenseVoice ONNX model not available in \(modelDir)/\(ONNXSenseVoice.folderName)")
+            return
+        }
+        let clip = audioPath.flatMap { Transcriber.loadAudioFile(url: URL(fileURLWithPath: $0)) }
+            ?? (0..<4).flatMap { _ in voicedBurst(count: 2 * 16000).map { $0 * 0.2 } + [Float](repeating: 0, count: 16000) }
+        let block = 1365
+
+        // The clip repeated to 60 s, as one utterance
+        var long: [Float] = []
+        while long.count < 60 * 16000 {
+            long += clip
+        }
+        let stream = StreamingRecognizer(engine: engine)
+        _ = stream.append(Array(clip.prefix(16000)))
+        stream.reset()
+
+        var sliceMs = [Double](repeating: 0, count: 6)
+        var partialTimes: [Double] = []
+        var firstPartial: (audioMs: Double, computeMs: Double)?
+        for offset in stride(from: 0, to: 60 * 16000, by: block) {
+            var partial: TimedTranscript?
+            let ms = measureMs { partial = stream.append(Array(long[offset..<min(offset + block, long.count)])) }
+            sliceMs[offset / (10 * 16000)] += ms
+            if partial != nil {
+                let audioMs = Double(offset + block) / 16
+                partialTimes.append(audioMs)
+                firstPartial = firstPartial ?? (audioMs: audioMs, computeMs: ms)
+            }
+        }
+        _ = stream.finish()
+
+        if let first = firstPartial {
+            print("First partial:   \(format(first.audioMs)) ms of audio + \(format(first.computeMs)) ms compute")
+        }
+        let gaps = zip(partialTimes.dropFirst(), partialTimes).map { $0 - $1 }
+        print("Partial every:   \(format(gaps.reduce(0, +) / Double(max(gaps.count, 1)))) ms (\(partialTimes.count) partials)")
+        print("Compute per audio second, by 10 s slice: "
+            + sliceMs.map { format($0 / 10) }.joined(separator: ", ") + " ms")
+
+        // Final hypothesis against one encoder pass over the whole clip
+        let audio = KotlinFloatArray(size: Int32(clip.count))
+        for (index, sample) in clip.enumerated() {
+            audio.set(index: Int32(index), value: sample)
+        }
+        var offline: String?
+        let offlineMs = measureMs { offline = engine.transcribe(audio: audio) }
+        var streamed = ""
+        let streamedMs = measureMs {
+            for offset in stride(from: 0, to: clip.count, by: block) {
+                _ = stream.append(Array(clip[offset..<min(offset + block, clip.count)]))
+            }
+            streamed = stream.finish().text
+        }
+        let reference = seamUnits(offline ?? "")
+        let errors = editDistance(reference, seamUnits(streamed))
+        print("Whole clip:      \(format(offlineMs)) ms offline, \(format(streamedMs)) ms streamed")
+        print("Final vs offline: \(errors)/\(reference.count) units differ")
+        print("  offline:  \(offline ?? "")")
+        print("  streamed: \(streamed)")
+    }
+
+    // MARK: - Parakeet
+
+    /// Word error rate and speed of Parakeet TDT against SenseVoice on the same English clips
+    /// (`<name>.wav` with a `<name>.txt` reference, as for the hotwords test set)
+    private static func benchmarkParakeet(testSetDir: String?, modelDir: String, assetsDir: String) {
+        print("── Parakeet vs SenseVoice ─────────────")
+
+        guard let dir = testSetDir else {
+            print("Usage: --benchmark parakeet <dir with English *.wav and matching *.txt>")
+            return
+        }
+        guard let parakeet = ParakeetTDT.load(modelDir: "\(modelDir)/\(ParakeetTDT.folderName)") else {
+            print("✗ Parakeet model not available in \(modelDir)/\(ParakeetTDT.folderName)")
+            return
+        }
+        let senseVoice = ASREngine(modelDir: modelDir, assetsDir: assetsDir)
+        guard senseVoice.initialize() else {
+            print("✗ SenseVoice model not available in \(modelDir)")
+            return
+        }
+        let engines: [(name: String, recognizer: SpeechRecognizer)] = [("SenseVoice", senseVoice), ("Parakeet", parakeet)]
+
+        // Map the weights and compile both models before timing anything
+        for engine in engines {
+            _ = engine.recognizer.transcribe(audio: KotlinFloatArray(size: 16000))
+        }
+        let warmUp = parakeet.stats
+
+        let clips = ((try? FileManager.default.contentsOfDirectory(atPath: dir)) ?? [])
+            .filter { $0.hasSuffix(".wav") }
+            .sorted()
+        var audioSeconds = 0.0
+        var referenceWords = 0
+        var errors = [Int](repeating: 0, count: engines.count)
+        var ms = [Double](repeating: 0, count: engines.count)
+
+        for clip in clips {
+            let name = (clip as NSString).deletingPathExtension
+            guard let reference = try? String(contentsOfFile: "\(dir)/\(name).txt", encoding: .utf8),
+                  let samples = Transcriber.loadAudioFile(url: URL(fileURLWithPath: "\(dir)/\(clip)")) else {
+                print("⚠️ Skipping \(clip) (missing audio or reference)")
+                continue
+            }
+            let audio = KotlinFloatArray(size: Int32(samples.count))
+            for (index, sample) in samples.enumerated() {
+                audio.set(index: Int32(index), value: sample)
+            }
+            let expected = seamUnits(reference)
+            audioSeconds += Double(samples.count) / 16000
+            referenceWords += expected.count
+
+            var line = "  \(name):"
+            for (index, engine) in engines.enumerated() {
+                var text: String?
+                ms[index] += measureMs { text = engine.recognizer.transcribe(audio: audio) }
+                let clipErrors = editDistance(expected, seamUnits(text ?? ""))
+                errors[index] += clipErrors
+                line += " \(engine.name) \(clipErrors)/\(expected.count)"
+            }
+            print(line)
+        }
+
+        guard audioSeconds > 0 else {
+            print("✗ No usable clips in \(dir)")
+            return
+        }
+
+        print("Clips:              \(clips.count) (\(format(audioSeconds)) s audio, \(referenceWords) words)")
+        for (index, engine) in engines.enumerated() {
+            let rate = 100 * Double(errors[index]) / Double(max(referenceWords, 1))
+            print("\(engine.name.padding(toLength: 12, withPad: " ", startingAt: 0))WER \(format(rate))%, "
+                + "\(format(ms[index] / audioSeconds)) ms per audio second")
+        }
+        let stats = parakeet.stats
+        let frames = stats.encoderFrames - warmUp.encoderFrames
+        let jointCalls = stats.jointCalls - warmUp.jointCalls
+        print("TDT decoding:       \(format(Double(jointCalls) / Double(max(frames, 1)))) joint calls per encoder frame "
+            + "(\(jointCalls) for \(frames)), \(stats.decoderCalls - warmUp.decoderCalls) decoder calls")
+    }
+
+    // MARK: - Language Routing
+
+    /// SenseVoice alone, Whisper Turbo alone and the language router on the same clips
+    /// (`<name>.wav` with a `<name>.txt` reference; mix the languages as real traffic would)
+    private static func benchmarkRouting(testSetDir: String?, modelDir: String, assetsDir: String) {
+        print("── Language routing ───────────────────")
+
+        guard let dir = testSetDir else {
+            print("Usage: --benchmark routing <dir with *.wav and matching *.txt in mixed languages>")
+            return
+        }
+        var clips: [(name: String, samples: [Float], reference: [String])] = []
+        for clip in ((try? FileManager.default.contentsOfDirectory(atPath: dir)) ?? []).filter({ $0.hasSuffix(".wav") }).sorted() {
+            let name = (clip as NSString).deletingPathExtension
+            guard let reference = try? String(contentsOfFile: "\(dir)/\(name).txt", encoding: .utf8),
+                  let samples = Transcriber.loadAudioFile(url: URL(fileURLWithPath: "\(dir)/\(clip)")) else {
+                print("⚠️ Skipping \(clip) (missing audio or reference)")
+                continue
+            }
+            clips.append((name, samples, seamUnits(reference)))
+        }
+        guard !clips.isEmpty else {
+            print("✗ No usable clips in \(dir)")
+            return
+        }
+
+        let registry = ModelRegistry(modelDir: modelDir, assetsDir: assetsDir, initial: .senseVoice)
+        registry.prefetch(.whisperTurbo)
+        registry.waitUntilIdle()
+        let transcriber = Transcriber(models: registry)
+        let words = clips.reduce(0) { $0 + $1.reference.count }
+        print("Clips: \(clips.count), \(words) reference words")
+
+        let modes: [(name: String, model: ASRModel, routing: Bool)] = [
+            ("SenseVoice only", .senseVoice, false),
+            ("Whisper only", .whisperTurbo, false),
+            ("Routed", .senseVoice, true),
+        ]
+        for mode in modes {
+            registry.setActive(mode.model)
+            registry.waitUntilIdle()
+            transcriber.routing = mode.routing
+            // Warm up on the first clip so compilation isn't timed
+            _ = transcriber.transcribe(samples: clips[0].samples, chunking: .silence)
+            let before = transcriber.router.stats
+
+            var errors = 0
+            var modelMs = 0.0
+            for clip in clips {
+                let result = transcriber.transcribe(samples: clip.samples, chunking: .silence)
+                errors += editDistance(clip.reference, seamUnits(result.text ?? ""))
+                modelMs += result.modelTime * 1000
+            }
+            print("\(mode.name.padding(toLength: 16, withPad: " ", startingAt: 0)) error rate "
+                + "\(format(100 * Double(errors) / Double(max(words, 1))))%, \(format(modelMs / Double(clips.count))) ms per clip")
+
+            guard mode.routing else { continue }
+            let stats = transcriber.router.stats
+            for route in LanguageRouter.Route.allCases {
+                let count = (stats.counts[route] ?? 0) - (before.counts[route] ?? 0)
+                print("  \(route.rawValue.padding(toLength: 18, withPad: " ", startingAt: 0)) \(count)")
+            }
+            print("  Whisper failures   \(stats.whisperFailures - before.whisperFailures)")
+        }
+    }
+
+    // MARK: - Transcript Cache
+
+    /// Cold vs cached re-transcription of one recording, then LRU behaviour under a budget
+    /// smaller than the working set
+    private static func benchmarkCache(audioPath: String?, modelDir: String, assetsDir: String) {
+        print("── Transcript cache ───────────────────")
+
+        guard let path = audioPath, let samples = Transcriber.loadAudioFile(url: URL(fileURLWithPath: path)) else {
+            print("Usage: --benchmark cache <audio file, ideally a few minutes long>")
+            return
+        }
+        let directory = FileManager.default.temporaryDirectory.appendingPathComponent("voca-bench-\(UUID().uuidString)")
+        defer { try? FileManager.default.removeItem(at: directory) }
+        let cache = TranscriptCache(directory: directory)
+        let transcriber = Transcriber(models: ModelRegistry(modelDir: modelDir, assetsDir: assetsDir, initial: .senseVoice))
+        _ = transcriber.transcribe(samples: Array(samples.prefix(16000)))
+
+        var cold: TranscriptionResult?
+        var warm: TranscriptionResult?
+        let coldMs = measureMs { cold = transcriber.transcribe(samples: samples, cache: cache) }
+        let warmMs = measureMs { warm = transcriber.transcribe(samples: samples, cache: cache) }
+        var stats = cache.stats
+        print("Audio:           \(format(Double(samples.count) / 16000)) s")
+        print("Cold:            \(format(coldMs)) ms")
+        print("Cached:          \(format(warmMs)) ms (\(format(coldMs / max(warmMs, 0.001)))× faster)")
+        print("Same text:       \(cold?.text == warm?.text ? "yes" : "NO")")
+        print("Hit rate:        \(format(stats.hitRate * 100))% (\(stats.hits) hits, \(stats.misses) misses, "
+            + "\(stats.entries) entries, \(stats.bytes) bytes)")
+
+        // A budget of half the entries: replaying the recording evicts as it goes
+        cache.maxBytes = stats.bytes / 2
+        _ = transcriber.transcribe(samples: samples, cache: cache)
+        let before = cache.stats
+        _ = transcriber.transcribe(samples: samples, cache: cache)
+        stats = cache.stats
+        let hits = stats.hits - before.hits
+        let lookups = hits + stats.misses - before.misses
+        print("Half budget:     \(stats.entries) entries, \(stats.bytes) bytes, \(stats.evictions) evicted, "
+            + "replay hit rate \(format(100 * Double(hits) / Double(max(lookups, 1))))%")
+    }
+
+    // MARK: - Half-Precision Logits
+
+    /// Accuracy parity and cost of fp16 logits: every clip is decoded from float32 logits
+    /// and from the same logits stored as fp16, greedy and (with `hotwords.txt`) biased
+    private static func benchmarkHalfPrecision(clipDir: String?, modelDir: String, assetsDir: String) {
+        print("── Half-precision logits ──────────────")
+
+        guard let dir = clipDir else {
+            print("Usage: --benchmark halfprecision <dir with *.wav, optionally hotwords.txt>")
+            return
+        }
+        guard let recognizer = HotwordRecognizer.load(modelDir: modelDir, assetsDir: assetsDir) else {
+            print("✗ SenseVoice model not available in \(modelDir)")
+            return
+        }
+        let hotwords = ((try? String(contentsOfFile: "\(dir)/hotwords.txt", encoding: .utf8)) ?? "")
+            .split(whereSeparator: \.isNewline)
+            .map { $0.trimmingCharacters(in: .whitespaces) }
+            .filter { !$0.isEmpty }
+        recognizer.setHotwords(hotwords)
+        recognizer.precision = .single
+        let beamWidth = recognizer.decoder.beamWidth
+
+        let clips = ((try? FileManager.default.contentsOfDirectory(atPath: dir)) ?? [])
+            .filter { $0.hasSuffix(".wav") }
+            .sorted()
+
+        var audioSeconds = 0.0
+        var decodes = 0
+        var changed = 0
+        var unitErrors = 0
+        var units = 0
+        var singleBytes = 0
+        var halfBytes = 0
+        var singleMs = 0.0
+        var halfMs = 0.0
+        var conversionMs = 0.0
+
+        for clip in clips {
+            guard let samples = Transcriber.loadAudioFile(url: URL(fileURLWithPath: "\(dir)/\(clip)")),
+                  let single = recognizer.logits(for: samples) else {
+                print("⚠️ Skipping \(clip)")
+                continue
+            }
+            audioSeconds += Double(samples.count) / 16000
+            var half = single
+            conversionMs += measureMs { half = single.converted(to: .half) }
+            singleBytes += single.storedBytes
+            halfBytes += half.storedBytes
+
+            for width in hotwords.isEmpty ? [1] : [1, beamWidth] {
+                recognizer.decoder.beamWidth = width
+                var singleLogits = single
+                var halfLogits = half
+                var singleText = ""
+                var halfText = ""
+                singleMs += measureMs { singleText = recognizer.decode(&singleLogits) }
+                halfMs += measureMs { halfText = recognizer.decode(&halfLogits) }
+
+                decodes += 1
+                let reference = seamUnits(singleText)
+                units += reference.count
+                guard singleText != halfText else { continue }
+                changed += 1
+                unitErrors += editDistance(reference, seamUnits(halfText))
+                print("  \(clip) (width \(width)): \(singleText)")
+                print("  \(String(repeating: " ", count: clip.count))→ \(halfText)")
+            }
+        }
+        recognizer.decoder.beamWidth = beamWidth
+
+        guard audioSeconds > 0 else {
+            print("✗ No usable clips in \(dir)")
+            return
+        }
+
+        print("Clips:            \(clips.count) (\(format(audioSeconds)) s audio, \(hotwords.count) hotwords)")
+        print("Changed decodes:  \(changed)/\(decodes) (\(unitErrors) edits over \(units) units, "
+            + "\(format(100 * Double(unitErrors) / Double(max(units, 1))))%)")
+        print("Logits size:      \(singleBytes >> 10) KB float32 → \(halfBytes >> 10) KB fp16 "
+            + "(\(format(Double(singleBytes) / Double(max(halfBytes, 1))))× smaller)")
+        print("Decode float32:   \(format(singleMs / audioSeconds)) ms per audio second")
+        print("Decode fp16:      \(format(halfMs / audioSeconds)) ms per audio second "
+            + "(+ \(format(conversionMs / audioSeconds)) ms converting)")
+    }
+
+    // MARK: - Helpers
+
+    static func measureMs(_ block: () -> Void) -> Double {
+        let start = DispatchTime.now().uptimeNanoseconds
+        block()
+        return Double(DispatchTime.now().uptimeNanoseconds - start) / 1_000_000
+    }
+
+    static func format(_ value: Double) -> String {
+        String(format: "%.2f", value)
+    }
+
+    /// Nearest-rank percentile (0 for no values)
+    static func percentile(_ values: [Double], _ p: Double) -> Double {
+        guard !values.isEmpty else { return 0 }
+        let sorted = values.sorted()
+        return sorted[min(sorted.count - 1, max(0, Int((p / 100 * Double(sorted.count)).rounded(.up)) - 1))]
+    }
+}
+#endif
@@ -0,0 +1,165 @@
+import Foundation
+import Network
+
+/// Minimal HTTP/1.1 server on 127.0.0.1 that stands in for the model release host in the
+/// download benchmark. Serves in-memory files to GET requests, honours `Range: bytes=N-`
+/// and `If-Range`, and can drop a response part-way to exercise resume.
+final class LocalHTTPServer {
+    private let listener: NWListener
+    private let queue = DispatchQueue(label: "com.voca.bench.http")
+    private var files: [String: Data] = [:]
+    private var pendingDrop: (path: String, bytes: Int)?
+    private var served = 0
+    private var requests = 0
+
+    private(set) var port: UInt16 = 0
+
+    var baseURL: URL { URL(string: "http://127.0.0.1:\(port)")! }
+
+    /// Body bytes written to sockets so far, across all responses
+    var bytesServed: Int { queue.sync { served } }
+    var requestCount: Int { queue.sync { requests } }
+
+    init?() {
+        let parameters = NWParameters.tcp
+        parameters.requiredLocalEndpoint = .hostPort(host: "127.0.0.1", port: .any)
+        guard let listener = try? NWListener(using: parameters) else { return nil }
+        self.listener = listener
+    }
+
+    func serve(_ data: Data, at path: String) {
+        queue.sync { files[path] = data }
+    }
+
+    /// Close the next response for `path` after `bytes` body bytes
+    func dropNextResponse(to path: String, after bytes: Int) {
+        queue.sync { pendingDrop = (path, bytes) }
+    }
+
+    /// Start listening on an ephemeral port; blocks until ready
+    func start() -> Bool {
+        let ready = DispatchSemaphore(value: 0)
+        var started = false
+        listener.stateUpdateHandler = { [weak self] state in
+            switch state {
+            case .ready:
+                self?.port = self?.listener.port?.rawValue ?? 0
+                started = true
+                ready.signal()
+            case .failed:
+                ready.signal()
+            default:
+                break
+            }
+        }
+        listener.newConnectionHandler = { [weak self] connection in
+            self?.accept(connection)
+        }
+        listener.start(queue: queue)
+        _ = ready.wait(timeout: .now() + 5)
+        return started
+    }
+
+    func stop() {
+        listener.cancel()
+    }
+
+    // MARK: - Connections
+
+    private func accept(_ connection: NWConnection) {
+        connection.start(queue: queue)
+        readRequest(connection, buffer: Data())
+    }
+
+    private func readRequest(_ connection: NWConnection, buffer: Data) {
+        connection.receive(minimumIncompleteLength: 1, maximumLength: 16 * 1024) { [weak self] data, _, isComplete, error in
+            guard let self = self else { return }
+            var buffer = buffer
+            if let data = data { buffer.append(data) }
+
+            if let end = buffer.range(of: Data("\r\n\r\n".utf8)) {
+                self.respond(to: String(decoding: buffer[..<end.lowerBound], as: UTF8.self), on: connection)
+            } else if isComplete || error != nil {
+                connection.cancel()
+            } else {
+                self.readRequest(connection, buffer: buffer)
+            }
+        }
+    }
+
+    private func respond(to request: String, on connection: NWConnection) {
+        requests += 1
+        let lines = request.components(separatedBy: "\r\n")
+        let parts = lines.first?.split(separator: " ") ?? []
+        var headers: [String: String] = [:]
+        for line in lines.dropFirst() {
+            guard let colon = line.firstIndex(of: ":") else { continue }
+            headers[line[..<colon].lowercased()] = line[line.index(after: colon)...].trimmingCharacters(in: .whitespaces)
+        }
+
+        let path = parts.count >= 2 ? String(parts[1]) : ""
+        guard parts.first == "GET", let body = files[path] else {
+            send(status: "404 Not Found", headers: [:], body: Data(), on: connection)
+            return
+        }
+
+        var limit = body.count
+        if let drop = pendingDrop, drop.path == path {
+            limit = drop.bytes
+            pendingDrop = nil
+        }
+
+        let etag = "\"\(body.count)\""
+        var start = 0
+        if let range = headers["range"], range.hasPrefix("bytes="),
+           headers["if-range"].map({ $0 == etag }) ?? true,
+           let first = Int(range.dropFirst("bytes=".count).split(separator: "-").first ?? ""),
+           first < body.count {
+            start = first
+        }
+
+        var responseHeaders = ["ETag": etag, "Accept-Ranges": "bytes"]
+        let status: String
+        if start > 0 {
+            status = "206 Partial Content"
+            responseHeaders["Content-Range"] = "bytes \(start)-\(body.count - 1)/\(body.count)"
+        } else {
+            status = "200 OK"
+        }
+        send(status: status, headers: responseHeaders, body: body[start...], on: connection, limit: limit)
+    }
+
+    private func send(status: String, headers: [String: String], body: Data, on connection: NWConnection,
+                      limit: Int = .max) {
+        var head = "HTTP/1.1 \(status)\r\nContent-Length: \(body.count)\r\nConnection: close\r\n"
+        for (name, value) in headers {
+            head += "\(name): \(value)\r\n"
+        }
+        head += "\r\n"
+
+        connection.send(content: Data(head.utf8), completion: .contentProcessed { _ in })
+        sendBody(body.prefix(limit), on: connection, dropAfterwards: limit < body.count)
+    }
+
+    /// Write the body in 64 KB pieces, then close (abruptly when simulating a drop)
+    private func sendBody(_ body: Data, on connection: NWConnection, dropAfterwards: Bool) {
+        guard !body.isEmpty else {
+            if dropAfterwards {
+                connection.forceCancel()
+            } else {
+                connection.send(content: nil, contentContext: .finalMessage, isComplete: true,
+                                completion: .contentProcessed { _ in connection.cancel() })
+            }
+            return
+        }
+        let piece = body.prefix(64 * 1024)
+        connection.send(content: piece, completion: .contentProcessed { [weak self] error in
+            guard let self = self, error == nil else {
+                connection.cancel()
+                return
+            }
+            self.served += piece.count
+            self.sendBody(body.dropFirst(piece.count), on: connection, dropAfterwards: dropAfterwards)
+        })
+    }
+}
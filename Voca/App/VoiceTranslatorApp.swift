@@ -23,7 +23,8 @@ class AppDelegate: NSObject, NSApplicationDelegate {
     private var transcriber: Transcriber!
     private var historyManager: HistoryManager { HistoryManager.shared }
     private var recordingOverlay: RecordingOverlay!
-    private var asrEngine: ASREngine!
+    private var models: ModelRegistry!
+    private var server: TranscriptionServer?
 
     // Sparkle updater
     private var updaterController: SPUStandardUpdaterController!
@@ -34,12 +35,17 @@ class AppDelegate: NSObject, NSApplicationDelegate {
     private var transcriptionTimeoutTask: DispatchWorkItem?
     private let transcriptionTimeoutSeconds: TimeInterval = 30
     private var currentAudioURL: URL?  // Track audio URL for history
+    private lazy var transcriptCache = TranscriptCache()  // Chunk transcripts for re-transcription
 
     // Incremental transcription state
-    private var incrementalText: [String] = []  // Accumulated text from speech segments
+    private let incrementalText = TextPostProcessor()  // Accumulated, post-processed speech segments
     private var isIncrementalMode = false
     private var pendingSegments = 0  // Track in-flight transcriptions
 
+    // Live partials: streaming recognizer fed on its own serial queue while recording
+    private var stream: StreamingRecognizer?
+    private let streamQueue = DispatchQueue(label: "com.voca.stream", qos: .userInitiated)
+
     // Model paths - CoreML models downloaded to Application Support, assets bundled
     private var modelDir: String {
         let appSupport = FileManager.default.urls(for: .applicationSupportDirectory, in: .userDomainMask).first!
@@ -74,19 +80,33 @@ class AppDelegate: NSObject, NSApplicationDelegate {
         // Set app icon (waveform.circle.fill)
         setAppIcon()
 
-        // Initialize ASR engine (loads CoreML models once at startup)
-        print("Loading ASR models...")
-        let loadStart = Date()
-        asrEngine = ASREngine(modelDir: modelDir, assetsDir: assetsDir)
-        if asrEngine.initialize() {
-            let loadTime = Int(Date().timeIntervalSince(loadStart) * 1000)
-            print("ASR engine initialized in \(loadTime)ms")
-        } else {
-            print("WARNING: ASR engine failed to initialize")
+        // `--trace <file.json>`: record pipeline spans, written out at quit
+        Trace.startFromArguments()
+
+        // Headless micro-benchmarks (e.g. `Voca --benchmark tokenizer`; debug builds only)
+        #if DEBUG
+        if Benchmarks.runIfRequested(modelDir: modelDir, assetsDir: assetsDir) {
+            NSApp.terminate(nil)
+            return
+        }
+        #endif
+
+        // Headless transcription daemon for other tools (`Voca --serve /tmp/voca.sock`)
+        if ProcessInfo.processInfo.arguments.contains("--serve") {
+            server = TranscriptionServer.startFromArguments(modelDir: modelDir, assetsDir: assetsDir)
+            if server == nil {
+                NSApp.terminate(nil)
+            }
+            return
         }
 
-        transcriber = Transcriber(engine: asrEngine)
+        // ASR models load on first use; the selected one is warmed up in the background below
+        models = ModelRegistry(modelDir: modelDir, assetsDir: assetsDir, initial: AppSettings.shared.selectedModel)
+        transcriber = Transcriber(models: models)
         audioRecorder = AudioRecorder()
+        DispatchQueue.global(qos: .utility).async {
+            Resampler.precomputeCommonTables()
+        }
         recordingOverlay = RecordingOverlay()
 
         // Initialize Sparkle updater
@@ -112,6 +132,12 @@ class AppDelegate: NSObject, NSApplicationDelegate {
             }
         )
 
+        NotificationCenter.default.addObserver(forName: .retranscribeRequested, object: nil, queue: .main) { [weak self] notification in
+            if let id = notification.object as? NSNumber {
+                self?.retranscribe(historyID: id.uint64Value)
+            }
+        }
+
         let settings = AppSettings.shared
         transcriber.setModel(settings.selectedModel)
 
@@ -192,7 +218,7 @@ class AppDelegate: NSObject, NSApplicationDelegate {
         recordingOverlay.show()
 
         // Reset incremental transcription state
-        incrementalText = []
+        incrementalText.reset()
         isIncrementalMode = true
         pendingSegments = 0
 
@@ -206,6 +232,21 @@ class AppDelegate: NSObject, NSApplicationDelegate {
             self?.handleSpeechSegment(samples)
         }
 
+        // Partials while speaking; each segment's endpoint then finalizes the stream
+        stream = AppSettings.shared.livePartials ? transcriber.makeStream() : nil
+        if let stream = stream {
+            audioRecorder.onSamples = { [weak self] samples in
+                self?.streamQueue.async {
+                    guard let partial = stream.append(samples), !partial.text.isEmpty else { return }
+                    DispatchQueue.main.async {
+                        guard let self = self, self.isIncrementalMode else { return }
+                        let committed = self.incrementalText.text
+                        self.recordingOverlay.updateTranscription(committed.isEmpty ? partial.text : committed + " " + partial.text)
+                    }
+                }
+            }
+        }
+
         audioRecorder.startRecording()
     }
 
@@ -213,106 +254,57 @@ class AppDelegate: NSObject, NSApplicationDelegate {
         guard isIncrementalMode else { return }
 
         pendingSegments += 1
+        Trace.gauge(.pendingSegments, pendingSegments)
         print("📝 Transcribing segment (\(samples.count) samples)...")
 
-        transcriber.transcribeSamples(samples) { [weak self] result in
-            DispatchQueue.main.async {
-                guard let self = self else { return }
-
-                self.pendingSegments -= 1
-
-                if let text = result, !text.isEmpty {
-                    // Clean up model artifacts
-                    let cleanedText = text
-                        .replacingOccurrences(of: "<\\|[^|]+\\|>", with: "", options: .regularExpression)
-                        .trimmingCharacters(in: .whitespaces)
-
-                    if !cleanedText.isEmpty {
-                        // Strip leading punctuation from segment (ASR often adds it)
-                        let strippedText = cleanedText.replacingOccurrences(
-                            of: "^[。.，,？?！!、]+\\s*",
-                            with: "",
-                            options: .regularExpression
-                        )
-                        guard !strippedText.isEmpty else { return }
-                        self.incrementalText.append(strippedText)
-
-                        // Combine all segments and apply post-processing
-                        let combinedText = self.incrementalText.joined(separator: " ")
-                        let processedText = self.postProcessText(combinedText)
-
-                        print("✓ Incremental: \(cleanedText) → Full: \(processedText)")
-
-                        // Show in overlay as preview (don't paste yet)
-                        self.recordingOverlay.updateTranscription(processedText)
-                    }
+        if let stream = stream {
+            // The stream has already decoded the segment; finish its hypothesis
+            streamQueue.async { [weak self] in
+                let text = stream.finish().text
+                DispatchQueue.main.async {
+                    self?.appendSegment(text)
+                }
+            }
+        } else {
+            transcriber.transcribeSamples(samples) { [weak self] result in
+                DispatchQueue.main.async {
+                    self?.appendSegment(result)
                 }
             }
         }
     }
 
-    /// Post-process transcribed text: filler removal and formatting
-    private func postProcessText(_ text: String) -> String {
-        var result = text
-
-        // 1. Remove basic filler words (multiple languages)
-        // English: um, uh, er, ah, hmm
-        // Chinese: 呃, 嗯, 啊, 那个
-        // Japanese: えーと, あの, えー
-        // Korean: 음, 어
-        let fillerWords = ["um", "uh", "er", "ah", "hmm", "呃", "嗯", "啊", "那个", "えーと", "あの", "えー", "음", "어"]
-        for filler in fillerWords {
-            // Remove filler surrounded by spaces
-            result = result.replacingOccurrences(of: " \(filler) ", with: " ", options: .caseInsensitive)
-            // Remove filler at start
-            result = result.replacingOccurrences(of: "^\(filler) ", with: "", options: [.caseInsensitive, .regularExpression])
-            // Remove filler followed by comma
-            result = result.replacingOccurrences(of: " \(filler),", with: ",", options: .caseInsensitive)
-        }
-
-        // 2. Fix spacing and punctuation
-        result = result.replacingOccurrences(of: "  +", with: " ", options: .regularExpression)  // Multiple spaces
-        result = result.replacingOccurrences(of: " ,", with: ",")  // Space before comma
-        result = result.replacingOccurrences(of: " \\.", with: ".", options: .regularExpression)  // Space before period
-
-        // 3. Clean up duplicate/mixed punctuation
-        // Detect if text is primarily Chinese (contains CJK characters)
-        let isChinese = result.range(of: "\\p{Han}", options: .regularExpression) != nil
-
-        if isChinese {
-            // Chinese text: normalize to Chinese punctuation
-            // Handle mixed punctuation with optional spaces: ... 。 or 。 . or 。。. etc.
-            result = result.replacingOccurrences(of: "[。.\\s]*[。.][。.\\s]*", with: "。", options: .regularExpression)
-            result = result.replacingOccurrences(of: "[，,\\s]*[，,][，,\\s]*", with: "，", options: .regularExpression)
-            result = result.replacingOccurrences(of: "[？?\\s]*[？?][？?\\s]*", with: "？", options: .regularExpression)
-            result = result.replacingOccurrences(of: "[！!\\s]*[！!][！!\\s]*", with: "！", options: .regularExpression)
-            // Remove comma before period: ，。 → 。
-            result = result.replacingOccurrences(of: "，。", with: "。")
-            result = result.replacingOccurrences(of: "。，", with: "。")
-            // Remove period after question/exclamation: ？。 → ？, ！。 → ！
-            result = result.replacingOccurrences(of: "？[。.]", with: "？", options: .regularExpression)
-            result = result.replacingOccurrences(of: "！[。.]", with: "！", options: .regularExpression)
-            result = result.replacingOccurrences(of: "\\?[。.]", with: "？", options: .regularExpression)
-            result = result.replacingOccurrences(of: "![。.]", with: "！", options: .regularExpression)
-        } else {
-            // English text: normalize to English punctuation
-            result = result.replacingOccurrences(of: "[.\\s]*\\.[.\\s]*", with: ". ", options: .regularExpression)
-            result = result.replacingOccurrences(of: ",+", with: ",", options: .regularExpression)
-            result = result.replacingOccurrences(of: ",\\s*\\.", with: ".", options: .regularExpression)  // Comma before period → period
-            result = result.replacingOccurrences(of: "\\.\\s*,", with: ",", options: .regularExpression)  // Period before comma → comma
-            result = result.replacingOccurrences(of: "\\?+", with: "?", options: .regularExpression)
-            result = result.replacingOccurrences(of: "!+", with: "!", options: .regularExpression)
-        }
+    /// Add a transcribed segment to the incremental text (main thread)
+    private func appendSegment(_ result: String?) {
+        pendingSegments -= 1
+        Trace.gauge(.pendingSegments, pendingSegments)
+        let span = Trace.begin(.postProcess)
+        defer { Trace.end(span) }
 
-        // Clean up any remaining multiple spaces
-        result = result.replacingOccurrences(of: "\\s{2,}", with: " ", options: .regularExpression)
+        if let text = result, !text.isEmpty {
+            // Clean up model artifacts
+            let cleanedText = text
+                .replacingOccurrences(of: "<\\|[^|]+\\|>", with: "", options: .regularExpression)
+                .trimmingCharacters(in: .whitespaces)
 
-        // 4. Capitalize first letter (for English text)
-        if let first = result.first {
-            result = first.uppercased() + result.dropFirst()
+            if !cleanedText.isEmpty {
+                // Strip leading punctuation from segment (ASR often adds it)
+                let strippedText = cleanedText.replacingOccurrences(
+                    of: "^[。.，,？?！!、]+\\s*",
+                    with: "",
+                    options: .regularExpression
+                )
+                guard !strippedText.isEmpty else { return }
+                // Corrections and post-processing only touch the newly appended segment
+                incrementalText.append(WordCorrector.shared.apply(strippedText))
+                let processedText = incrementalText.text
+
+                print("✓ Incremental: \(cleanedText) → Full: \(processedText)")
+
+                // Show in overlay as preview (don't paste yet)
+                recordingOverlay.updateTranscription(processedText)
+            }
         }
-
-        return result.trimmingCharacters(in: .whitespaces)
     }
 
     private func stopRecordingAndTranscribe() {
@@ -328,6 +320,8 @@ class AppDelegate: NSObject, NSApplicationDelegate {
 
             // Now clear the callback after stopRecording has flushed the buffer
             self.audioRecorder.onSpeechSegment = nil
+            self.audioRecorder.onSamples = nil
+            self.stream = nil
             self.isIncrementalMode = false
 
             // If we got incremental results, use those instead of re-transcribing
@@ -363,13 +357,15 @@ class AppDelegate: NSObject, NSApplicationDelegate {
         // Restore the original system default input device
         AudioInputManager.shared.restoreSavedDefault()
 
-        let combinedText = incrementalText.joined(separator: " ")
-        let processedText = postProcessText(combinedText)
+        let processedText = incrementalText.text
         let totalTime = totalStartTime.map { Date().timeIntervalSince($0) } ?? 0
 
         if !processedText.isEmpty {
             print("✓ Final: \(processedText)")
             print("  ⏱ total: \(Int(totalTime * 1000))ms (incremental)")
+            let stats = transcriber.segmentStats
+            print("  ⏭️ segments skipped: \(stats.skippedBeforeModel + stats.skippedDecoding)/\(stats.segments) "
+                + "(\(Int(stats.skippedRatio * 100))%) so far")
             historyManager.add(processedText, audioURL: audioURL)
             // Paste final text only once at the end
             pasteText(processedText)
@@ -378,8 +374,8 @@ class AppDelegate: NSObject, NSApplicationDelegate {
         }
 
         // Clean up
-        incrementalText = []
-        asrEngine.collectGarbage()
+        incrementalText.reset()
+        models.collectGarbage()
     }
 
     private func startTranscription(audioURL: URL) {
@@ -402,7 +398,8 @@ class AppDelegate: NSObject, NSApplicationDelegate {
         transcriptionTimeoutTask = timeoutTask
         DispatchQueue.main.asyncAfter(deadline: .now() + transcriptionTimeoutSeconds, execute: timeoutTask)
 
-        transcriber.transcribe(audioURL: audioURL) { [weak self] result in
+        // Fill the cache now, so transcribing the saved recording again can reuse the chunks
+        transcriber.transcribe(audioURL: audioURL, cache: transcriptCache) { [weak self] result in
             DispatchQueue.main.async {
                 guard let self = self, self.isTranscribing else { return }
                 self.transcriptionTimeoutTask?.cancel()
@@ -423,7 +420,7 @@ class AppDelegate: NSObject, NSApplicationDelegate {
         // Restore the original system default input device
         AudioInputManager.shared.restoreSavedDefault()
         // Clean up any partial memory allocations
-        asrEngine.collectGarbage()
+        models.collectGarbage()
         print("✗ Cancelled")
     }
 
@@ -436,16 +433,13 @@ class AppDelegate: NSObject, NSApplicationDelegate {
         AudioInputManager.shared.restoreSavedDefault()
 
         // Clean up Kotlin/Native memory after transcription
-        asrEngine.collectGarbage()
+        models.collectGarbage()
 
         let totalTime = totalStartTime.map { Date().timeIntervalSince($0) } ?? 0
         let modelTime = result.modelTime
 
         if let text = result.text, !text.isEmpty {
-            // Clean up model artifacts (tags like <|EMO_UNKNOWN|>, <|jp|>, <|en|>, etc.)
-            let cleanedText = text
-                .replacingOccurrences(of: "<\\|[^|]+\\|>", with: "", options: .regularExpression)
-                .trimmingCharacters(in: .whitespaces)
+            let cleanedText = postProcess(text)
 
             guard !cleanedText.isEmpty else {
                 print("✗ Empty after cleanup")
@@ -457,7 +451,7 @@ class AppDelegate: NSObject, NSApplicationDelegate {
             let totalMs = Int(totalTime * 1000)
             print("✓ \(cleanedText)")
             print("  ⏱ model: \(modelMs)ms | total: \(totalMs)ms")
-            historyManager.add(cleanedText, audioURL: currentAudioURL)
+            historyManager.add(cleanedText, audioURL: currentAudioURL, words: result.words)
             currentAudioURL = nil
             pasteText(cleanedText)
         } else {
@@ -467,6 +461,47 @@ class AppDelegate: NSObject, NSApplicationDelegate {
         statusBarController.setState(.idle)
     }
 
+    private func postProcess(_ text: String) -> String {
+        Trace.span(.postProcess) { () -> String in
+            // Clean up model artifacts (tags like <|EMO_UNKNOWN|>, <|jp|>, <|en|>, etc.)
+            let strippedText = text
+                .replacingOccurrences(of: "<\\|[^|]+\\|>", with: "", options: .regularExpression)
+                .trimmingCharacters(in: .whitespaces)
+            // Word mappings and phonetic custom-word corrections
+            return WordCorrector.shared.apply(strippedText)
+        }
+    }
+
+    /// Transcribe a history recording again with the current model and settings. Chunks
+    /// whose recognition inputs are unchanged come from the cache, so e.g. new word
+    /// mappings only rerun post-processing. The result replaces the item's transcript (it
+    /// keeps its recording, so it can be transcribed again) and is copied.
+    private func retranscribe(historyID: UInt64) {
+        guard let audioURL = historyManager.item(id: historyID)?.audioURL else {
+            print("✗ Re-transcription: no recording for history item \(historyID)")
+            return
+        }
+        let cache = transcriptCache
+        transcriber.transcribe(audioURL: audioURL, cache: cache) { [weak self] result in
+            DispatchQueue.main.async {
+                guard let self = self else { return }
+                self.models.collectGarbage()
+                let text = result.text.map(self.postProcess) ?? ""
+                guard !text.isEmpty else {
+                    print("✗ Re-transcription: no result")
+                    return
+                }
+                let stats = cache.stats
+                print("✓ Re-transcribed: \(text)")
+                print("  ⏱ model: \(Int(result.modelTime * 1000))ms | 📊 cache: \(Int(stats.hitRate * 100))% hits, "
+                    + "\(stats.entries) entries, \(stats.bytes >> 10) KB, \(stats.evictions) evicted")
+                self.historyManager.update(id: historyID, text: text, words: result.words)
+                NSPasteboard.general.clearContents()
+                NSPasteboard.general.setString(text, forType: .string)
+            }
+        }
+    }
+
     private func removeEscMonitor() {
         if let monitor = escMonitor {
             NSEvent.removeMonitor(monitor)
@@ -538,6 +573,8 @@ class AppDelegate: NSObject, NSApplicationDelegate {
     func applicationWillTerminate(_ notification: Notification) {
         transcriptionTimeoutTask?.cancel()
         removeEscMonitor()
+        server?.stop()
+        Trace.finishFromArguments()
     }
 
     private func setAppIcon() {
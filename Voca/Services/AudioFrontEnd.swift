@@ -0,0 +1,293 @@
+import Foundation
+import Accelerate
+
+/// Streaming clean-up of 16kHz mono audio ahead of the VAD and ASR: high-pass filter,
+/// spectral noise suppression and automatic gain control.
+///
+/// - High-pass: 2nd-order Butterworth at 80 Hz removes DC, rumble and handling noise.
+/// - Noise suppression: 32 ms frames, 50% overlap, √Hann analysis/synthesis windows. The
+///   per-bin noise floor starts from the previous recording's (or a low fixed floor) and is
+///   tracked by minimum statistics: it drops to any quieter smoothed power at once and rises
+///   only to the quietest level of the last ~1.5 s, so speech from the first sample is never
+///   taken for noise. A decision-directed Wiener gain, floored at −20 dB, attenuates each bin.
+/// - AGC: brings speech to `targetRMS`; the gain only adapts on frames well above the noise
+///   floor and above −40 dBFS, so silence is never pumped up.
+///
+/// Buffers are allocated once, so `process` does no allocation beyond growing `output`
+/// (reserve capacity for real-time use). Output lags input by `latency` samples.
+final class AudioFrontEnd {
+    static let sampleRate = 16000
+    static let frameSize = 512
+    static let hopSize = 256
+    /// Samples of delay between input and output
+    static let latency = frameSize - hopSize
+
+    /// RMS level speech is normalized to (−20 dBFS)
+    var targetRMS: Float = 0.1
+    /// Gain limits for AGC (+20 dB / −12 dB)
+    var maxGain: Float = 10
+    var minGain: Float = 0.25
+    /// Per-bin suppression floor (−20 dB)
+    var suppressionFloor: Float = 0.1
+
+    /// Current AGC gain
+    private(set) var gain: Float = 1
+    /// Whether the most recent frame was classified as speech
+    private(set) var isSpeech = false
+    /// Per-bin noise power, to seed the front-end of the next recording
+    var noiseFloor: [Float] { noise }
+
+    private static let log2n = vDSP_Length(9)
+    private static let bins = frameSize / 2 + 1
+    /// Minimum-statistics window: sub-windows of frames (4 × 24 frames ≈ 1.5 s)
+    private static let subWindows = 4
+    private static let subWindowFrames = 24
+    /// The minimum of smoothed noise power sits below its mean by about this factor
+    private static let minimumBias: Float = 2
+    /// Seed floor: white noise at −60 dBFS
+    private static let seedNoise = binPower(rms: 0.001)
+    /// Frames quieter than −40 dBFS are never speech
+    private static let speechPower = Float(bins) * binPower(rms: 0.01)
+
+    private let fft: FFTSetup
+    private let window: [Float]
+    private var input: [Float]
+    private var pending = 0
+    private var overlap: [Float]
+    private var frame: [Float]
+    private var real: [Float]
+    private var imag: [Float]
+    private var power: [Float]
+    private var noise: [Float]
+    /// Per-bin power smoothed over a few frames, its minimum in the current sub-window, and
+    /// the minima of the last `subWindows` sub-windows
+    private var smoothed: [Float]
+    private var subWindowMinimum: [Float]
+    private var minima: [Float]
+    /// |clean|² of the previous frame, for the decision-directed SNR estimate
+    private var previousClean: [Float]
+    private var gains: [Float]
+    private var subWindowFrame = 0
+    private var subWindowIndex = 0
+
+    // High-pass biquad (transposed direct form II)
+    private let b0: Float, b1: Float, b2: Float, a1: Float, a2: Float
+    private var z1: Float = 0
+    private var z2: Float = 0
+
+    // AGC envelope of speech frames
+    private var envelope: Float = 0
+
+    /// `noiseFloor` carries the estimate over from an earlier front-end
+    init(highPassHz: Double = 80, noiseFloor: [Float]? = nil) {
+        fft = vDSP_create_fftsetup(Self.log2n, FFTRadix(kFFTRadix2))!
+        let n = Self.frameSize
+        window = (0..<n).map { Float((0.5 - 0.5 * cos(2 * Double.pi * Double($0) / Double(n))).squareRoot()) }
+        input = [Float](repeating: 0, count: n)
+        pending = Self.latency
+        overlap = [Float](repeating: 0, count: n)
+        frame = [Float](repeating: 0, count: n)
+        real = [Float](repeating: 0, count: n / 2)
+        imag = [Float](repeating: 0, count: n / 2)
+        power = [Float](repeating: 0, count: Self.bins)
+        let seed = noiseFloor.flatMap { $0.count == Self.bins ? $0 : nil }
+            ?? [Float](repeating: Self.seedNoise, count: Self.bins)
+        noise = seed
+        let minimum = seed.map { $0 / Self.minimumBias }
+        smoothed = minimum
+        subWindowMinimum = minimum
+        minima = [Float]((0..<Self.subWindows).map { _ in minimum }.joined())
+        previousClean = [Float](repeating: 0, count: Self.bins)
+        gains = [Float](repeating: 1, count: Self.bins)
+
+        // Bilinear-transform Butterworth high-pass
+        let omega = tan(Double.pi * highPassHz / Double(Self.sampleRate))
+        let q = 1 / 2.0.squareRoot()
+        let norm = 1 / (1 + omega / q + omega * omega)
+        b0 = Float(norm)
+        b1 = Float(-2 * norm)
+        b2 = Float(norm)
+        a1 = Float(2 * (omega * omega - 1) * norm)
+        a2 = Float((1 - omega / q + omega * omega) * norm)
+    }
+
+    deinit {
+        vDSP_destroy_fftsetup(fft)
+    }
+
+    /// Clean a block, appending every finished output sample to `output`
+    func process(_ samples: [Float], into output: inout [Float]) {
+        for sample in samples {
+            // High-pass
+            let filtered = b0 * sample + z1
+            z1 = b1 * sample - a1 * filtered + z2
+            z2 = b2 * sample - a2 * filtered
+
+            input[pending] = filtered
+            pending += 1
+            if pending == Self.frameSize {
+                processFrame(into: &output)
+            }
+        }
+    }
+
+    /// Push out the samples still inside the frame delay
+    func flush(into output: inout [Float]) {
+        process([Float](repeating: 0, count: Self.hopSize + Self.latency), into: &output)
+    }
+
+    // MARK: - Frames
+
+    private func processFrame(into output: inout [Float]) {
+        let n = Self.frameSize
+        let hop = Self.hopSize
+
+        vDSP_vmul(input, 1, window, 1, &frame, 1, vDSP_Length(n))
+        forwardFFT()
+        updateNoiseAndGains()
+        inverseFFT()
+
+        // Overlap-add the windowed frame; the first hop is finished
+        overlap.withUnsafeMutableBufferPointer { sum in
+            vDSP_vma(frame, 1, window, 1, sum.baseAddress!, 1, sum.baseAddress!, 1, vDSP_Length(n))
+        }
+        applyGain(to: &overlap, count: hop)
+        output.append(contentsOf: overlap[0..<hop])
+
+        // Slide both buffers by one hop
+        overlap.withUnsafeMutableBufferPointer { buffer in
+            let base = buffer.baseAddress!
+            base.update(from: base + hop, count: n - hop)
+            (base + n - hop).update(repeating: 0, count: hop)
+        }
+        input.withUnsafeMutableBufferPointer { buffer in
+            let base = buffer.baseAddress!
+            base.update(from: base + hop, count: n - hop)
+        }
+        pending = n - hop
+    }
+
+    private func forwardFFT() {
+        real.withUnsafeMutableBufferPointer { realBuffer in
+            imag.withUnsafeMutableBufferPointer { imagBuffer in
+                var split = DSPSplitComplex(realp: realBuffer.baseAddress!, imagp: imagBuffer.baseAddress!)
+                frame.withUnsafeBufferPointer { frameBuffer in
+                    frameBuffer.baseAddress!.withMemoryRebound(to: DSPComplex.self, capacity: Self.frameSize / 2) {
+                        vDSP_ctoz($0, 2, &split, 1, vDSP_Length(Self.frameSize / 2))
+                    }
+                }
+                vDSP_fft_zrip(fft, &split, 1, Self.log2n, FFTDirection(FFT_FORWARD))
+            }
+        }
+
+        // Packed layout: DC in real[0], Nyquist in imag[0]
+        let half = Self.frameSize / 2
+        power[0] = real[0] * real[0]
+        power[half] = imag[0] * imag[0]
+        for k in 1..<half {
+            power[k] = real[k] * real[k] + imag[k] * imag[k]
+        }
+    }
+
+    private func updateNoiseAndGains() {
+        let bins = Self.bins
+
+        var framePower: Float = 0
+        var noisePower: Float = 0
+        vDSP_sve(power, 1, &framePower, vDSP_Length(bins))
+        vDSP_sve(noise, 1, &noisePower, vDSP_Length(bins))
+        isSpeech = framePower > 4 * noisePower && framePower > Self.speechPower
+
+        // Minimum statistics: anything quieter than the floor lowers it now; at the end of
+        // each sub-window the floor becomes the quietest level of the whole window
+        for k in 0..<bins {
+            smoothed[k] = 0.7 * smoothed[k] + 0.3 * power[k]
+            subWindowMinimum[k] = min(subWindowMinimum[k], smoothed[k])
+            noise[k] = min(noise[k], Self.minimumBias * smoothed[k])
+        }
+        subWindowFrame += 1
+        if subWindowFrame == Self.subWindowFrames {
+            subWindowFrame = 0
+            for k in 0..<bins {
+                minima[subWindowIndex * bins + k] = subWindowMinimum[k]
+                var minimum = minima[k]
+                for window in 1..<Self.subWindows {
+                    minimum = min(minimum, minima[window * bins + k])
+                }
+                noise[k] = Self.minimumBias * minimum
+                subWindowMinimum[k] = smoothed[k]
+            }
+            subWindowIndex = (subWindowIndex + 1) % Self.subWindows
+        }
+
+        // Decision-directed a-priori SNR and Wiener gain
+        for k in 0..<bins {
+            let floor = max(noise[k], 1e-10)
+            let posterior = power[k] / floor
+            let prior = 0.98 * previousClean[k] / floor + 0.02 * max(posterior - 1, 0)
+            let gain = max(prior / (1 + prior), suppressionFloor)
+            gains[k] = gain
+            previousClean[k] = gain * gain * power[k]
+        }
+
+        let half = Self.frameSize / 2
+        real[0] *= gains[0]
+        imag[0] *= gains[half]
+        for k in 1..<half {
+            real[k] *= gains[k]
+            imag[k] *= gains[k]
+        }
+    }
+
+    /// Expected power in one bin for white noise of this RMS (√Hann window, vDSP's ×2 FFT)
+    private static func binPower(rms: Float) -> Float {
+        2 * Float(frameSize) * rms * rms
+    }
+
+    private func inverseFFT() {
+        real.withUnsafeMutableBufferPointer { realBuffer in
+            imag.withUnsafeMutableBufferPointer { imagBuffer in
+                var split = DSPSplitComplex(realp: realBuffer.baseAddress!, imagp: imagBuffer.baseAddress!)
+                vDSP_fft_zrip(fft, &split, 1, Self.log2n, FFTDirection(FFT_INVERSE))
+                frame.withUnsafeMutableBufferPointer { frameBuffer in
+                    frameBuffer.baseAddress!.withMemoryRebound(to: DSPComplex.self, capacity: Self.frameSize / 2) {
+                        vDSP_ztoc(&split, 1, $0, 2, vDSP_Length(Self.frameSize / 2))
+                    }
+                }
+            }
+        }
+        // Forward scales by 2, inverse by N
+        var scale = 1 / Float(2 * Self.frameSize)
+        frame.withUnsafeMutableBufferPointer { buffer in
+            vDSP_vsmul(buffer.baseAddress!, 1, &scale, buffer.baseAddress!, 1, vDSP_Length(Self.frameSize))
+        }
+    }
+
+    /// AGC over one finished hop: adapt on speech, ramp the gain across the hop, soft-limit peaks
+    private func applyGain(to samples: inout [Float], count: Int) {
+        var meanSquare: Float = 0
+        vDSP_measqv(samples, 1, &meanSquare, vDSP_Length(count))
+        let rms = meanSquare.squareRoot()
+
+        var target = gain
+        if isSpeech {
+            // Fast attack, slow release
+            envelope += (rms - envelope) * (rms > envelope ? 0.3 : 0.05)
+            if envelope > 0 {
+                let desired = min(max(targetRMS / envelope, minGain), maxGain)
+                target = gain + (desired - gain) * 0.1
+            }
+        }
+
+        let step = (target - gain) / Float(count)
+        for i in 0..<count {
+            var value = samples[i] * (gain + step * Float(i + 1))
+            let magnitude = abs(value)
+            if magnitude > 0.95 {
+                value = (0.95 + 0.05 * tanh((magnitude - 0.95) / 0.05)) * (value < 0 ? -1 : 1)
+            }
+            samples[i] = value
+        }
+        gain = target
+    }
+}
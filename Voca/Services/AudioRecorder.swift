@@ -8,6 +8,22 @@ class AudioRecorder {
     private var isRecording = false
     private var tempURL: URL?
 
+    // Capture-rate → 16kHz conversion, carried across tap buffers
+    private var resampler: Resampler?
+    private var monoScratch: [Float] = []
+    private var resampledScratch: [Float] = []
+
+    // Noise suppression and gain control ahead of segmentation and the file
+    private var frontEnd: AudioFrontEnd?
+    private var cleanScratch: [Float] = []
+    /// Front-end delay still to trim from the start of the output
+    private var frontEndSkip = 0
+    /// Noise floor the last recording ended with, so the next one starts from it
+    private var noiseFloor: [Float]?
+
+    /// Where the next tap buffer should start, to spot frames the tap never delivered
+    private var expectedSampleTime: AVAudioFramePosition?
+
     private let sampleRate: Double = 16000
     private let channels: AVAudioChannelCount = 1
 
@@ -17,16 +33,11 @@ class AudioRecorder {
     // Speech segment callback for incremental transcription
     var onSpeechSegment: (([Float]) -> Void)?
 
-    // Silence detection parameters
-    private let silenceThreshold: Float = 0.02  // RMS threshold for silence (increased for mic noise floor)
-    private let silenceDuration: Double = 1.2   // Seconds of silence to trigger segment end (longer to avoid breaking natural pauses)
-    private let minSpeechDuration: Double = 1.0 // Minimum speech duration to process
+    // 16kHz samples as they are captured, for streaming recognition (called on the audio thread)
+    var onSamples: (([Float]) -> Void)?
 
     // Speech segment tracking
-    private var sampleBuffer: [Float] = []
-    private var silenceStartTime: Date?
-    private var speechStartTime: Date?
-    private var isSpeaking = false
+    private var segmenter = SpeechSegmenter()
 
     // Smoothed RMS for stable visualization
     private var smoothedRMS: Float = 0
@@ -36,11 +47,11 @@ class AudioRecorder {
         guard !isRecording else { return }
 
         // Reset state
-        sampleBuffer = []
-        silenceStartTime = nil
-        speechStartTime = nil
-        isSpeaking = false
+        segmenter.reset()
         smoothedRMS = 0
+        expectedSampleTime = nil
+        frontEnd = AppSettings.shared.audioFrontEnd ? AudioFrontEnd(noiseFloor: noiseFloor) : nil
+        frontEndSkip = frontEnd == nil ? 0 : AudioFrontEnd.latency
 
         do {
             let engine = AVAudioEngine()
@@ -53,6 +64,11 @@ class AudioRecorder {
 
             // Get input format and create output format (16kHz mono)
             let inputFormat = inputNode.outputFormat(forBus: 0)
+            // No input device (or no microphone access) reports a 0 Hz, 0-channel format
+            guard inputFormat.sampleRate > 0, inputFormat.channelCount > 0 else {
+                print("Failed to start recording: no usable input device (\(inputFormat))")
+                return
+            }
             let outputFormat = AVAudioFormat(
                 commonFormat: .pcmFormatFloat32,
                 sampleRate: sampleRate,
@@ -68,15 +84,13 @@ class AudioRecorder {
                 interleaved: false
             )
 
-            // Create converter for resampling
-            guard let converter = AVAudioConverter(from: inputFormat, to: outputFormat) else {
-                print("Failed to create audio converter")
-                return
-            }
+            // Polyphase resampler for the device rate (tables are shared across sessions)
+            let resampler = Resampler(inputRate: Int(inputFormat.sampleRate), outputRate: Int(sampleRate))
+            self.resampler = resampler
 
             // Install tap on input
-            inputNode.installTap(onBus: 0, bufferSize: 4096, format: inputFormat) { [weak self] buffer, _ in
-                self?.processAudioBuffer(buffer, converter: converter, outputFormat: outputFormat)
+            inputNode.installTap(onBus: 0, bufferSize: 4096, format: inputFormat) { [weak self] buffer, when in
+                self?.processAudioBuffer(buffer, at: when, resampler: resampler, outputFormat: outputFormat)
             }
 
             try engine.start()
@@ -98,15 +112,27 @@ class AudioRecorder {
         audioEngine?.inputNode.removeTap(onBus: 0)
         audioEngine?.stop()
         audioEngine = nil
+
+        // Drain the last few milliseconds still inside the resampler's and front-end's delay
+        var tail: [Float] = []
+        if let resampler = resampler, let format = audioFile?.processingFormat {
+            resampledScratch.removeAll(keepingCapacity: true)
+            resampler.flush(into: &resampledScratch)
+            tail = clean(resampledScratch, flush: true)
+            write(tail, format: format)
+        }
+        resampler = nil
+        noiseFloor = frontEnd?.noiseFloor ?? noiseFloor
+        frontEnd = nil
         audioFile = nil
         isRecording = false
 
+        onSamples?(tail)
+
         // Process any remaining speech in buffer (call synchronously so it runs before completion)
-        if !sampleBuffer.isEmpty && sampleBuffer.count > Int(sampleRate * minSpeechDuration) {
-            let segment = sampleBuffer
-            sampleBuffer = []
-            print("📝 Flushing final segment: \(segment.count) samples")
-            onSpeechSegment?(segment)
+        if let segment = segmenter.finish(tail: tail) {
+            print("📝 Flushing final segment: \(segment.samples.count) samples")
+            onSpeechSegment?(segment.samples)
         }
 
         print("Recording stopped")
@@ -114,108 +140,114 @@ class AudioRecorder {
     }
 
     private func processAudioBuffer(_ buffer: AVAudioPCMBuffer,
-                                     converter: AVAudioConverter,
+                                     at time: AVAudioTime,
+                                     resampler: Resampler,
                                      outputFormat: AVAudioFormat) {
-        // Calculate output buffer size based on sample rate ratio
-        let ratio = outputFormat.sampleRate / buffer.format.sampleRate
-        let outputFrameCount = AVAudioFrameCount(Double(buffer.frameLength) * ratio)
-
-        guard let outputBuffer = AVAudioPCMBuffer(
-            pcmFormat: outputFormat,
-            frameCapacity: outputFrameCount
-        ) else { return }
-
-        var error: NSError?
-        let status = converter.convert(to: outputBuffer, error: &error) { _, outStatus in
-            outStatus.pointee = .haveData
-            return buffer
+        let span = Trace.begin(.capture)
+        defer { Trace.end(span) }
+
+        if time.isSampleTimeValid {
+            if let expected = expectedSampleTime, time.sampleTime > expected {
+                Trace.count(.droppedFrames, by: Int(time.sampleTime - expected))
+            }
+            expectedSampleTime = time.sampleTime + AVAudioFramePosition(buffer.frameLength)
         }
 
-        guard status != .error, error == nil else {
-            print("Conversion error: \(error?.localizedDescription ?? "unknown")")
-            return
+        monoScratch.removeAll(keepingCapacity: true)
+        buffer.appendMono(to: &monoScratch)
+        resampledScratch.removeAll(keepingCapacity: true)
+        Trace.span(.resample) {
+            resampler.process(monoScratch, into: &resampledScratch)
         }
+        let samples = Trace.span(.frontEnd) { clean(resampledScratch, flush: false) }
+        guard !samples.isEmpty else { return }
 
         // Write to file
-        do {
-            try audioFile?.write(from: outputBuffer)
-        } catch {
-            print("Failed to write audio: \(error)")
+        write(samples, format: outputFormat)
+        onSamples?(samples)
+
+        // Calculate RMS from the cleaned 16kHz buffer (consistent for VAD and visualization)
+        var sum: Float = 0
+        for sample in samples {
+            sum += sample * sample
         }
+        let rms = sqrt(sum / Float(samples.count))
 
-        // Calculate RMS from converted 16kHz buffer (consistent for VAD and visualization)
-        var rms: Float = 0
-        if let channelData = outputBuffer.floatChannelData?[0] {
-            let frameLength = Int(outputBuffer.frameLength)
-            var sum: Float = 0
-            for i in 0..<frameLength {
-                let sample = channelData[i]
-                sum += sample * sample
-                sampleBuffer.append(sample)  // Accumulate for speech segments
-            }
-            rms = sqrt(sum / Float(frameLength))
+        // Apply smoothing for stable visualization
+        smoothedRMS = smoothedRMS * (1 - smoothingFactor) + rms * smoothingFactor
 
-            // Apply smoothing for stable visualization
-            smoothedRMS = smoothedRMS * (1 - smoothingFactor) + rms * smoothingFactor
+        // Convert to 0-1 range with amplification for visualization
+        let level = min(1.0, smoothedRMS * 5.0)
+        DispatchQueue.main.async { [weak self] in
+            self?.onAudioLevel?(level)
+        }
 
-            // Convert to 0-1 range with amplification for visualization
-            let level = min(1.0, smoothedRMS * 5.0)
+        // Speech/silence detection using raw RMS (not smoothed, for accurate timing)
+        let wasSpeaking = segmenter.isSpeaking
+        let segment = segmenter.append(samples, rms: rms)
+        if segmenter.isSpeaking && !wasSpeaking {
+            print("🎤 Speech started")
+        }
+        if let segment = segment {
+            print("📝 Speech segment: \(segment.samples.count) samples (\(Double(segment.samples.count) / sampleRate)s)")
             DispatchQueue.main.async { [weak self] in
-                self?.onAudioLevel?(level)
+                self?.onSpeechSegment?(segment.samples)
             }
         }
+    }
 
-        // Speech/silence detection using raw RMS (not smoothed, for accurate timing)
-        detectSpeechSegment(rms: rms)
+    /// Run resampled audio through the front-end (if enabled), trimming its start-up delay
+    private func clean(_ samples: [Float], flush: Bool) -> [Float] {
+        guard let frontEnd = frontEnd else { return samples }
+        cleanScratch.removeAll(keepingCapacity: true)
+        frontEnd.process(samples, into: &cleanScratch)
+        if flush {
+            frontEnd.flush(into: &cleanScratch)
+        }
+        if frontEndSkip > 0 {
+            let skipped = min(frontEndSkip, cleanScratch.count)
+            cleanScratch.removeFirst(skipped)
+            frontEndSkip -= skipped
+        }
+        return cleanScratch
     }
 
-    private func detectSpeechSegment(rms: Float) {
-        let now = Date()
+    private func write(_ samples: [Float], format: AVAudioFormat) {
+        guard !samples.isEmpty,
+              let buffer = AVAudioPCMBuffer(pcmFormat: format, frameCapacity: AVAudioFrameCount(samples.count)),
+              let channel = buffer.floatChannelData?[0] else { return }
+        samples.withUnsafeBufferPointer { channel.update(from: $0.baseAddress!, count: samples.count) }
+        buffer.frameLength = AVAudioFrameCount(samples.count)
+
+        do {
+            try audioFile?.write(from: buffer)
+        } catch {
+            print("Failed to write audio: \(error)")
+        }
+    }
+}
 
-        if rms > silenceThreshold {
-            // Sound detected
-            silenceStartTime = nil
+extension AVAudioPCMBuffer {
+    /// Append the float samples averaged across channels (interleaved or not)
+    func appendMono(to output: inout [Float]) {
+        guard let channels = floatChannelData else { return }
+        let frames = Int(frameLength)
+        let channelCount = Int(format.channelCount)
+        if channelCount == 1 {
+            output.append(contentsOf: UnsafeBufferPointer(start: channels[0], count: frames))
+            return
+        }
 
-            if !isSpeaking {
-                // Speech started
-                isSpeaking = true
-                speechStartTime = now
-                print("🎤 Speech started")
-            }
-        } else {
-            // Silence detected
-            if isSpeaking {
-                if silenceStartTime == nil {
-                    silenceStartTime = now
-                } else if let silenceStart = silenceStartTime,
-                          now.timeIntervalSince(silenceStart) >= silenceDuration {
-                    // Silence duration exceeded - segment complete
-
-                    // Check minimum speech duration
-                    if let speechStart = speechStartTime,
-                       now.timeIntervalSince(speechStart) >= minSpeechDuration + silenceDuration {
-
-                        // Remove trailing silence from buffer (approximate)
-                        let silenceSamples = Int(silenceDuration * sampleRate)
-                        let segmentEnd = max(0, sampleBuffer.count - silenceSamples)
-
-                        if segmentEnd > Int(sampleRate * minSpeechDuration) {
-                            let segment = Array(sampleBuffer[0..<segmentEnd])
-                            print("📝 Speech segment: \(segment.count) samples (\(Double(segment.count) / sampleRate)s)")
-
-                            // Keep some overlap for context, but start fresh for next segment
-                            sampleBuffer = Array(sampleBuffer[segmentEnd...])
-
-                            DispatchQueue.main.async { [weak self] in
-                                self?.onSpeechSegment?(segment)
-                            }
-                        }
-                    }
-
-                    // Reset for next segment
-                    isSpeaking = false
-                    speechStartTime = nil
-                    silenceStartTime = nil
+        let scale = 1 / Float(channelCount)
+        let start = output.count
+        output.append(contentsOf: repeatElement(0, count: frames))
+        output.withUnsafeMutableBufferPointer { mono in
+            for channel in 0..<channelCount {
+                // Interleaved data lives in the first pointer with `stride` samples per frame
+                let source = format.isInterleaved ? channels[0] + channel : channels[channel]
+                let step = format.isInterleaved ? stride : 1
+                for frame in 0..<frames {
+                    mono[start + frame] += source[frame * step] * scale
                 }
             }
         }
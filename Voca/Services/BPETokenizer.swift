@@ -0,0 +1,433 @@
+import Foundation
+
+/// SentencePiece BPE tokenizer for the SenseVoice vocabulary.
+///
+/// The `.bpe.model` protobuf is compiled once into a flat binary (offset table, scores,
+/// piece types, UTF-8 blob) that later launches `mmap` directly, so loading does no
+/// JSON or protobuf parsing. Decoding writes straight into the result string's UTF-8
+/// storage; encoding (for prompts and hotwords) merges pieces through a byte trie.
+final class BPETokenizer {
+    // Flat file layout (little endian):
+    //   magic u32 | version u32 | count u32 | blobSize u32 | sourceSize u64 | sourceModified u64
+    //   offsets u32 × (count + 1) | scores f32 × count | types u8 × count | blob
+    private static let magic: UInt32 = 0x45504256  // "VBPE"
+    private static let formatVersion: UInt32 = 2
+    private static let headerSize = 32
+
+    // SentencePiece piece types (sentencepiece_model.proto)
+    private static let typeNormal: UInt8 = 1
+    private static let typeUnknown: UInt8 = 2
+
+    /// "▁" (U+2581), SentencePiece's word-boundary marker
+    private static let spaceMarker: [UInt8] = [0xE2, 0x96, 0x81]
+
+    private let base: UnsafeMutableRawPointer
+    private let mappedSize: Int
+    private let offsets: UnsafePointer<UInt32>
+    private let scores: UnsafePointer<Float32>
+    private let types: UnsafePointer<UInt8>
+    private let blob: UnsafePointer<UInt8>
+
+    let vocabularySize: Int
+    private(set) var unknownId: Int32 = 0
+
+    // Trie for encoding, built on first use (decode-only callers never pay for it)
+    private var trie: PieceTrie?
+    private let trieLock = NSLock()
+
+    static var defaultCacheDirectory: URL {
+        let appSupport = FileManager.default.urls(for: .applicationSupportDirectory, in: .userDomainMask).first!
+        return appSupport.appendingPathComponent("Voca/cache")
+    }
+
+    /// Size and modification time (ns since 1970) of the `.bpe.model` a cache was compiled
+    /// from; a replaced model differs in one or the other even when its size is unchanged
+    private struct Source: Equatable {
+        let size: UInt64
+        let modified: UInt64
+    }
+
+    /// Load the tokenizer for a `.bpe.model` file, compiling it into the cache on first use
+    static func load(modelPath: String, cacheDir: URL = defaultCacheDirectory) -> BPETokenizer? {
+        guard let attributes = try? FileManager.default.attributesOfItem(atPath: modelPath),
+              let size = (attributes[.size] as? NSNumber)?.uint64Value,
+              let modified = attributes[.modificationDate] as? Date else {
+            print("BPE model not found: \(modelPath)")
+            return nil
+        }
+        let source = Source(size: size, modified: UInt64(max(0, modified.timeIntervalSince1970 * 1e9)))
+
+        let name = URL(fileURLWithPath: modelPath).deletingPathExtension().lastPathComponent
+        let cacheURL = cacheDir.appendingPathComponent("\(name).bin")
+
+        if let tokenizer = BPETokenizer(mappedPath: cacheURL.path, source: source) {
+            return tokenizer
+        }
+
+        // Cache missing or stale - compile from the protobuf model
+        guard let compiled = compile(modelPath: modelPath, source: source) else {
+            print("Failed to parse BPE model: \(modelPath)")
+            return nil
+        }
+
+        do {
+            try FileManager.default.createDirectory(at: cacheDir, withIntermediateDirectories: true)
+            try compiled.write(to: cacheURL, options: .atomic)
+        } catch {
+            print("Failed to write tokenizer cache: \(error)")
+            return nil
+        }
+
+        return BPETokenizer(mappedPath: cacheURL.path, source: source)
+    }
+
+    private init?(mappedPath path: String, source: Source) {
+        let fd = open(path, O_RDONLY)
+        guard fd >= 0 else { return nil }
+        defer { close(fd) }
+
+        var info = stat()
+        guard fstat(fd, &info) == 0, Int(info.st_size) >= Self.headerSize else { return nil }
+        let size = Int(info.st_size)
+
+        guard let pointer = mmap(nil, size, PROT_READ, MAP_PRIVATE, fd, 0),
+              pointer != UnsafeMutableRawPointer(bitPattern: -1) else { return nil }
+
+        let count = Int(pointer.load(fromByteOffset: 8, as: UInt32.self))
+        let blobSize = Int(pointer.load(fromByteOffset: 12, as: UInt32.self))
+        let offsetsStart = Self.headerSize
+        let scoresStart = offsetsStart + (count + 1) * 4
+        let typesStart = scoresStart + count * 4
+        let blobStart = typesStart + count
+
+        guard pointer.load(as: UInt32.self) == Self.magic,
+              pointer.load(fromByteOffset: 4, as: UInt32.self) == Self.formatVersion,
+              Source(size: pointer.load(fromByteOffset: 16, as: UInt64.self),
+                     modified: pointer.load(fromByteOffset: 24, as: UInt64.self)) == source,
+              blobStart + blobSize == size else {
+            munmap(pointer, size)
+            return nil
+        }
+
+        base = pointer
+        mappedSize = size
+        vocabularySize = count
+        offsets = UnsafePointer(pointer.advanced(by: offsetsStart).assumingMemoryBound(to: UInt32.self))
+        scores = UnsafePointer(pointer.advanced(by: scoresStart).assumingMemoryBound(to: Float32.self))
+        types = UnsafePointer(pointer.advanced(by: typesStart).assumingMemoryBound(to: UInt8.self))
+        blob = UnsafePointer(pointer.advanced(by: blobStart).assumingMemoryBound(to: UInt8.self))
+
+        if let unk = (0..<count).first(where: { types[$0] == Self.typeUnknown }) {
+            unknownId = Int32(unk)
+        }
+    }
+
+    deinit {
+        munmap(base, mappedSize)
+    }
+
+    // MARK: - Decode
+
+    /// Decode token IDs to text, replacing "▁" with spaces and dropping control tokens
+    func decode(_ tokenIds: [Int32]) -> String {
+        // Upper bound: "▁" (3 bytes) only ever shrinks to a single space
+        var capacity = 0
+        for id in tokenIds where isText(id) {
+            capacity += Int(offsets[Int(id) + 1] - offsets[Int(id)])
+        }
+        guard capacity > 0 else { return "" }
+
+        return String(unsafeUninitializedCapacity: capacity) { buffer in
+            var count = 0
+            for id in tokenIds where isText(id) {
+                var i = Int(offsets[Int(id)])
+                let end = Int(offsets[Int(id) + 1])
+                while i < end {
+                    if blob[i] == 0xE2 && i + 2 < end && blob[i + 1] == 0x96 && blob[i + 2] == 0x81 {
+                        // Word boundary - skip leading spaces
+                        if count > 0 {
+                            buffer[count] = 0x20
+                            count += 1
+                        }
+                        i += 3
+                    } else {
+                        buffer[count] = blob[i]
+                        count += 1
+                        i += 1
+                    }
+                }
+            }
+            // Trim trailing spaces
+            while count > 0 && buffer[count - 1] == 0x20 {
+                count -= 1
+            }
+            return count
+        }
+    }
+
+    /// Raw piece for a token ID (with "▁" markers), or nil if out of range
+    func piece(for tokenId: Int32) -> String? {
+        guard tokenId >= 0 && Int(tokenId) < vocabularySize else { return nil }
+        let start = Int(offsets[Int(tokenId)])
+        let end = Int(offsets[Int(tokenId) + 1])
+        return String(decoding: UnsafeBufferPointer(start: blob + start, count: end - start), as: UTF8.self)
+    }
+
+    private func isText(_ id: Int32) -> Bool {
+        id >= 0 && Int(id) < vocabularySize && types[Int(id)] == Self.typeNormal
+    }
+
+    // MARK: - Encode
+
+    /// Encode text to token IDs using SentencePiece BPE (highest-scoring merge first).
+    /// With `wordStart` false the first word gets no "▁" prefix, matching how it
+    /// tokenizes mid-sentence in unspaced (CJK) text.
+    func encode(_ text: String, wordStart: Bool = true) -> [Int32] {
+        let trie = pieceTrie()
+        var ids: [Int32] = []
+
+        // SentencePiece normalization: each whitespace-separated word gets a "▁" prefix
+        for (index, word) in text.split(whereSeparator: { $0.isWhitespace }).enumerated() {
+            var bytes = (index == 0 && !wordStart) ? [] : Self.spaceMarker
+            bytes.append(contentsOf: word.utf8)
+            encodeWord(bytes, trie: trie, into: &ids)
+        }
+        return ids
+    }
+
+    private func encodeWord(_ bytes: [UInt8], trie: PieceTrie, into ids: inout [Int32]) {
+        // Start from one symbol per Unicode scalar
+        var symbols: [Range<Int>] = []
+        var start = 0
+        for i in 1...bytes.count where i == bytes.count || bytes[i] & 0xC0 != 0x80 {
+            symbols.append(start..<i)
+            start = i
+        }
+
+        // Repeatedly apply the best-scoring merge among adjacent pairs
+        while symbols.count > 1 {
+            var bestIndex = -1
+            var bestScore = -Float.infinity
+            for i in 0..<(symbols.count - 1) {
+                let merged = symbols[i].lowerBound..<symbols[i + 1].upperBound
+                if let id = trie.lookup(bytes, merged), scores[Int(id)] > bestScore {
+                    bestScore = scores[Int(id)]
+                    bestIndex = i
+                }
+            }
+            guard bestIndex >= 0 else { break }
+            symbols[bestIndex] = symbols[bestIndex].lowerBound..<symbols[bestIndex + 1].upperBound
+            symbols.remove(at: bestIndex + 1)
+        }
+
+        for symbol in symbols {
+            ids.append(trie.lookup(bytes, symbol) ?? unknownId)
+        }
+    }
+
+    private func pieceTrie() -> PieceTrie {
+        trieLock.lock()
+        defer { trieLock.unlock() }
+
+        if let trie = trie { return trie }
+
+        var built = PieceTrie()
+        for id in 0..<vocabularySize where types[id] == Self.typeNormal {
+            let start = Int(offsets[id])
+            let end = Int(offsets[id + 1])
+            built.insert(UnsafeBufferPointer(start: blob + start, count: end - start), id: Int32(id))
+        }
+        trie = built
+        return built
+    }
+
+    // MARK: - Compile
+
+    /// Parse a SentencePiece ModelProto and serialize it into the flat layout
+    private static func compile(modelPath: String, source: Source) -> Data? {
+        guard let data = FileManager.default.contents(atPath: modelPath) else { return nil }
+        let bytes = [UInt8](data)
+
+        var pieceRanges: [Range<Int>] = []
+        var pieceScores: [Float32] = []
+        var pieceTypes: [UInt8] = []
+
+        var reader = ProtoReader(bytes: bytes, range: 0..<bytes.count)
+        while let tag = reader.readTag() {
+            // ModelProto.pieces = 1 (repeated SentencePiece)
+            guard tag.field == 1 && tag.wireType == 2 else {
+                guard reader.skip(wireType: tag.wireType) else { return nil }
+                continue
+            }
+            guard let pieceRange = reader.readLengthDelimited() else { return nil }
+
+            var pieceReader = ProtoReader(bytes: bytes, range: pieceRange)
+            var text: Range<Int> = 0..<0
+            var score: Float32 = 0
+            var type = typeNormal
+            while let pieceTag = pieceReader.readTag() {
+                switch (pieceTag.field, pieceTag.wireType) {
+                case (1, 2):
+                    guard let range = pieceReader.readLengthDelimited() else { return nil }
+                    text = range
+                case (2, 5):
+                    guard let bits = pieceReader.readFixed32() else { return nil }
+                    score = Float32(bitPattern: bits)
+                case (3, 0):
+                    guard let value = pieceReader.readVarint() else { return nil }
+                    type = UInt8(truncatingIfNeeded: value)
+                default:
+                    guard pieceReader.skip(wireType: pieceTag.wireType) else { return nil }
+                }
+            }
+            pieceRanges.append(text)
+            pieceScores.append(score)
+            pieceTypes.append(type)
+        }
+
+        guard !pieceRanges.isEmpty else { return nil }
+
+        let blobSize = pieceRanges.reduce(0) { $0 + $1.count }
+        var out = Data(capacity: headerSize + (pieceRanges.count + 1) * 4 + pieceRanges.count * 5 + blobSize)
+
+        func append<T: FixedWidthInteger>(_ value: T) {
+            withUnsafeBytes(of: value.littleEndian) { out.append(contentsOf: $0) }
+        }
+
+        append(magic)
+        append(formatVersion)
+        append(UInt32(pieceRanges.count))
+        append(UInt32(blobSize))
+        append(source.size)
+        append(source.modified)
+
+        var offset: UInt32 = 0
+        for range in pieceRanges {
+            append(offset)
+            offset += UInt32(range.count)
+        }
+        append(offset)
+
+        for score in pieceScores {
+            append(score.bitPattern)
+        }
+        out.append(contentsOf: pieceTypes)
+        for range in pieceRanges {
+            out.append(contentsOf: bytes[range])
+        }
+        return out
+    }
+}
+
+// MARK: - Piece Trie
+
+/// Byte trie over vocabulary pieces (first-child / next-sibling arrays)
+private struct PieceTrie {
+    private var firstChild: [Int32] = [-1]
+    private var nextSibling: [Int32] = [-1]
+    private var labels: [UInt8] = [0]
+    private var values: [Int32] = [-1]
+
+    mutating func insert(_ piece: UnsafeBufferPointer<UInt8>, id: Int32) {
+        var node = 0
+        for byte in piece {
+            if let next = child(of: node, label: byte) {
+                node = next
+            } else {
+                let next = labels.count
+                labels.append(byte)
+                values.append(-1)
+                firstChild.append(-1)
+                nextSibling.append(firstChild[node])
+                firstChild[node] = Int32(next)
+                node = next
+            }
+        }
+        values[node] = id
+    }
+
+    func lookup(_ bytes: [UInt8], _ range: Range<Int>) -> Int32? {
+        var node = 0
+        for i in range {
+            guard let next = child(of: node, label: bytes[i]) else { return nil }
+            node = next
+        }
+        return values[node] >= 0 ? values[node] : nil
+    }
+
+    private func child(of node: Int, label: UInt8) -> Int? {
+        var candidate = firstChild[node]
+        while candidate >= 0 {
+            if labels[Int(candidate)] == label { return Int(candidate) }
+            candidate = nextSibling[Int(candidate)]
+        }
+        return nil
+    }
+}
+
+// MARK: - Protobuf Reader
+
+/// Minimal protobuf wire-format reader (only what ModelProto needs)
+private struct ProtoReader {
+    let bytes: [UInt8]
+    private var index: Int
+    private let end: Int
+
+    init(bytes: [UInt8], range: Range<Int>) {
+        self.bytes = bytes
+        self.index = range.lowerBound
+        self.end = range.upperBound
+    }
+
+    mutating func readVarint() -> UInt64? {
+        var result: UInt64 = 0
+        var shift: UInt64 = 0
+        while index < end && shift < 64 {
+            let byte = bytes[index]
+            index += 1
+            result |= UInt64(byte & 0x7F) << shift
+            if byte < 0x80 { return result }
+            shift += 7
+        }
+        return nil
+    }
+
+    mutating func readTag() -> (field: Int, wireType: Int)? {
+        guard index < end, let key = readVarint() else { return nil }
+        return (Int(key >> 3), Int(key & 7))
+    }
+
+    mutating func readLengthDelimited() -> Range<Int>? {
+        guard let length = readVarint(), length <= UInt64(end - index) else { return nil }
+        let range = index..<(index + Int(length))
+        index = range.upperBound
+        return range
+    }
+
+    mutating func readFixed32() -> UInt32? {
+        guard index + 4 <= end else { return nil }
+        let value = UInt32(bytes[index])
+            | UInt32(bytes[index + 1]) << 8
+            | UInt32(bytes[index + 2]) << 16
+            | UInt32(bytes[index + 3]) << 24
+        index += 4
+        return value
+    }
+
+    mutating func skip(wireType: Int) -> Bool {
+        switch wireType {
+        case 0:
+            return readVarint() != nil
+        case 1:
+            guard index + 8 <= end else { return false }
+            index += 8
+            return true
+        case 2:
+            return readLengthDelimited() != nil
+        case 5:
+            return readFixed32() != nil
+        default:
+            return false
+        }
+    }
+}
@@ -0,0 +1,495 @@
+import Foundation
+import Accelerate
+
+/// CTC output for one utterance: row-major `[frameCount × vocabularySize]` scores.
+///
+/// Scores are stored as float32 or, in `.half` mode, as IEEE fp16 (half the resident size
+/// and memory traffic; SenseVoice's 25k-token rows are ~100 KB each in float32). Half
+/// storage is converted a frame at a time into a float32 scratch row as it is read, so
+/// consumers go through `forEachFrame` rather than the raw storage.
+struct CTCLogits {
+    enum Precision {
+        case single
+        case half
+    }
+
+    let frameCount: Int
+    let vocabularySize: Int
+    private(set) var precision: Precision
+    /// float32 scores (`.single`; may be longer than `frameCount × vocabularySize`)
+    private var values: [Float]
+    /// fp16 bit patterns (`.half`)
+    private var halves: [UInt16]
+
+    init(values: [Float], frameCount: Int, vocabularySize: Int) {
+        self.values = values
+        self.halves = []
+        self.frameCount = frameCount
+        self.vocabularySize = vocabularySize
+        self.precision = .single
+    }
+
+    /// Build frame by frame: `fill` writes one frame's float32 scores into the row it is
+    /// given, which is converted straight to `precision` (no full float32 copy in `.half`)
+    init(frameCount: Int, vocabularySize: Int, precision: Precision,
+         fill: (Int, UnsafeMutableBufferPointer<Float>) -> Void) {
+        self.frameCount = frameCount
+        self.vocabularySize = vocabularySize
+        self.precision = precision
+        let count = frameCount * vocabularySize
+
+        switch precision {
+        case .single:
+            halves = []
+            values = [Float](repeating: 0, count: count)
+            values.withUnsafeMutableBufferPointer { buffer in
+                for frame in 0..<frameCount {
+                    fill(frame, UnsafeMutableBufferPointer(rebasing: buffer[(frame * vocabularySize)..<((frame + 1) * vocabularySize)]))
+                }
+            }
+        case .half:
+            values = []
+            halves = [UInt16](repeating: 0, count: count)
+            var row = [Float](repeating: 0, count: vocabularySize)
+            halves.withUnsafeMutableBufferPointer { buffer in
+                row.withUnsafeMutableBufferPointer { scratch in
+                    for frame in 0..<frameCount {
+                        fill(frame, scratch)
+                        Self.convert(UnsafePointer(scratch.baseAddress!), toHalf: buffer.baseAddress! + frame * vocabularySize,
+                                     rows: 1, width: vocabularySize)
+                    }
+                }
+            }
+        }
+    }
+
+    /// Bytes held by the scores
+    var storedBytes: Int {
+        values.count * MemoryLayout<Float>.size + halves.count * MemoryLayout<UInt16>.size
+    }
+
+    /// The same scores stored at `precision`, converted in one pass over all frames
+    func converted(to precision: Precision) -> CTCLogits {
+        guard precision != self.precision else { return self }
+        var result = self
+        result.precision = precision
+        result.values = []
+        result.halves = []
+        let count = frameCount * vocabularySize
+        guard count > 0 else { return result }
+        switch precision {
+        case .single:
+            result.values = [Float](repeating: 0, count: count)
+            halves.withUnsafeBufferPointer { source in
+                result.values.withUnsafeMutableBufferPointer { destination in
+                    Self.convert(source.baseAddress!, toSingle: destination.baseAddress!, rows: frameCount, width: vocabularySize)
+                }
+            }
+        case .half:
+            result.halves = [UInt16](repeating: 0, count: count)
+            values.withUnsafeBufferPointer { source in
+                result.halves.withUnsafeMutableBufferPointer { destination in
+                    Self.convert(source.baseAddress!, toHalf: destination.baseAddress!, rows: frameCount, width: vocabularySize)
+                }
+            }
+        }
+        return result
+    }
+
+    /// Visit frames in order with their float32 scores (valid only inside `body`)
+    func forEachFrame(_ frames: Range<Int>? = nil, _ body: (Int, UnsafePointer<Float>) -> Void) {
+        let frames = (frames ?? 0..<frameCount).clamped(to: 0..<frameCount)
+        guard !frames.isEmpty else { return }
+
+        switch precision {
+        case .single:
+            values.withUnsafeBufferPointer { buffer in
+                for frame in frames {
+                    body(frame, buffer.baseAddress! + frame * vocabularySize)
+                }
+            }
+        case .half:
+            var row = [Float](repeating: 0, count: vocabularySize)
+            halves.withUnsafeBufferPointer { buffer in
+                row.withUnsafeMutableBufferPointer { scratch in
+                    for frame in frames {
+                        Self.convert(buffer.baseAddress! + frame * vocabularySize, toSingle: scratch.baseAddress!,
+                                     rows: 1, width: vocabularySize)
+                        body(frame, UnsafePointer(scratch.baseAddress!))
+                    }
+                }
+            }
+        }
+    }
+
+    /// Convert each frame's raw logits to log-probabilities in place
+    mutating func applyLogSoftmax() {
+        let width = vDSP_Length(vocabularySize)
+        var exps = [Float](repeating: 0, count: vocabularySize)
+        var count = Int32(vocabularySize)
+
+        func logSoftmax(_ row: UnsafeMutablePointer<Float>) {
+            var maxValue: Float = 0
+            vDSP_maxv(row, 1, &maxValue, width)
+            var shift = -maxValue
+            vDSP_vsadd(row, 1, &shift, row, 1, width)
+            vvexpf(&exps, row, &count)
+            var sum: Float = 0
+            vDSP_sve(exps, 1, &sum, width)
+            var logSum = -logf(sum)
+            vDSP_vsadd(row, 1, &logSum, row, 1, width)
+        }
+
+        let frameCount = self.frameCount
+        let vocabularySize = self.vocabularySize
+        switch precision {
+        case .single:
+            values.withUnsafeMutableBufferPointer { buffer in
+                for frame in 0..<frameCount {
+                    logSoftmax(buffer.baseAddress! + frame * vocabularySize)
+                }
+            }
+        case .half:
+            var row = [Float](repeating: 0, count: vocabularySize)
+            halves.withUnsafeMutableBufferPointer { buffer in
+                row.withUnsafeMutableBufferPointer { scratch in
+                    for frame in 0..<frameCount {
+                        let stored = buffer.baseAddress! + frame * vocabularySize
+                        Self.convert(stored, toSingle: scratch.baseAddress!, rows: 1, width: vocabularySize)
+                        logSoftmax(scratch.baseAddress!)
+                        Self.convert(scratch.baseAddress!, toHalf: stored, rows: 1, width: vocabularySize)
+                    }
+                }
+            }
+        }
+    }
+
+    // MARK: - fp16 Conversion (vImage, SIMD)
+
+    private static func convert(_ source: UnsafePointer<Float>, toHalf destination: UnsafeMutablePointer<UInt16>,
+                                rows: Int, width: Int) {
+        var src = vImage_Buffer(data: UnsafeMutableRawPointer(mutating: source), height: vImagePixelCount(rows),
+                                width: vImagePixelCount(width), rowBytes: width * MemoryLayout<Float>.size)
+        var dst = vImage_Buffer(data: destination, height: vImagePixelCount(rows),
+                                width: vImagePixelCount(width), rowBytes: width * MemoryLayout<UInt16>.size)
+        vImageConvert_PlanarFtoPlanar16F(&src, &dst, vImage_Flags(kvImageNoFlags))
+    }
+
+    private static func convert(_ source: UnsafePointer<UInt16>, toSingle destination: UnsafeMutablePointer<Float>,
+                                rows: Int, width: Int) {
+        var src = vImage_Buffer(data: UnsafeMutableRawPointer(mutating: source), height: vImagePixelCount(rows),
+                                width: vImagePixelCount(width), rowBytes: width * MemoryLayout<UInt16>.size)
+        var dst = vImage_Buffer(data: destination, height: vImagePixelCount(rows),
+                                width: vImagePixelCount(width), rowBytes: width * MemoryLayout<Float>.size)
+        vImageConvert_Planar16FtoPlanarF(&src, &dst, vImage_Flags(kvImageNoFlags))
+    }
+}
+
+/// A decoded token and the encoder frames it was emitted on (`endFrame` exclusive)
+struct CTCToken {
+    let id: Int32
+    let startFrame: Int32
+    var endFrame: Int32
+}
+
+// MARK: - Hotword Trie
+
+/// Token-level trie of hotword spellings. A beam's position in the trie is tracked
+/// by `HotwordTrie.State`; every matched token earns `boost`, which is taken back if
+/// the match breaks off before a complete hotword.
+struct HotwordTrie {
+    static let root: Int32 = 0
+
+    struct State {
+        var node: Int32 = HotwordTrie.root
+        /// Bonus locked in by completed hotwords
+        var committed: Float = 0
+        /// Depth of `node` when bonus was last committed (partial bonus counts from here)
+        var committedDepth: Int32 = 0
+    }
+
+    let boost: Float
+    private var children: [UInt64: Int32] = [:]
+    private var nextTokens: [[Int32]] = [[]]
+    private var depths: [Int32] = [0]
+    private var terminal: [Bool] = [false]
+    private(set) var count = 0
+
+    init(boost: Float = 1.5) {
+        self.boost = boost
+    }
+
+    var isEmpty: Bool { count == 0 }
+
+    mutating func insert(_ tokens: [Int32]) {
+        guard !tokens.isEmpty else { return }
+        var node = Self.root
+        for token in tokens {
+            let key = Self.key(node, token)
+            if let child = children[key] {
+                node = child
+                continue
+            }
+            let child = Int32(terminal.count)
+            children[key] = child
+            nextTokens[Int(node)].append(token)
+            nextTokens.append([])
+            depths.append(depths[Int(node)] + 1)
+            terminal.append(false)
+            node = child
+        }
+        if !terminal[Int(node)] {
+            terminal[Int(node)] = true
+            count += 1
+        }
+    }
+
+    /// Tokens that extend a partial match at `node`
+    func continuations(of node: Int32) -> [Int32] {
+        nextTokens[Int(node)]
+    }
+
+    /// Search score of a state: committed bonus plus the in-progress partial match
+    func score(_ state: State) -> Float {
+        state.committed + Float(depths[Int(state.node)] - state.committedDepth) * boost
+    }
+
+    /// Advance a state by one emitted token
+    func advance(_ state: State, with token: Int32) -> State {
+        var next = state
+        var child = children[Self.key(state.node, token)]
+        if child == nil && state.node != Self.root {
+            // Match broke off: drop the partial bonus and retry from the root
+            next.node = Self.root
+            next.committedDepth = 0
+            child = children[Self.key(Self.root, token)]
+        }
+        guard let matched = child else {
+            next.node = Self.root
+            next.committedDepth = 0
+            return next
+        }
+
+        next.node = matched
+        if terminal[Int(matched)] {
+            next.committed += Float(depths[Int(matched)] - next.committedDepth) * boost
+            if nextTokens[Int(matched)].isEmpty {
+                next.node = Self.root
+                next.committedDepth = 0
+            } else {
+                next.committedDepth = depths[Int(matched)]
+            }
+        }
+        return next
+    }
+
+    private static func key(_ node: Int32, _ token: Int32) -> UInt64 {
+        UInt64(UInt32(bitPattern: node)) << 32 | UInt64(UInt32(bitPattern: token))
+    }
+}
+
+// MARK: - Decoder
+
+/// CTC prefix beam search with hotword biasing.
+///
+/// With no hotwords the search can't beat the best path by much, so `decode` falls
+/// back to greedy decoding. Otherwise each frame only expands the top `beamWidth`
+/// tokens within `pruneThreshold` of the best one (plus tokens continuing a hotword),
+/// and near-certain blank frames skip expansion entirely.
+struct CTCBeamDecoder {
+    var beamWidth = 8
+    /// Candidate tokens must score within this many nats of the frame's best token
+    var pruneThreshold: Float = 10
+    /// Frames whose blank probability exceeds this only extend existing prefixes
+    var blankSkipProbability: Float = 0.999
+    var blankId: Int32 = 0
+
+    /// Decode log-probabilities (see `CTCLogits.applyLogSoftmax`) to token IDs
+    func decode(_ logProbs: CTCLogits, hotwords: HotwordTrie) -> [Int32] {
+        decodeAligned(logProbs, hotwords: hotwords).map(\.id)
+    }
+
+    /// Decode to tokens with the frames they were emitted on, from the search itself
+    func decodeAligned(_ logProbs: CTCLogits, hotwords: HotwordTrie) -> [CTCToken] {
+        if hotwords.isEmpty || beamWidth <= 1 {
+            return Self.greedyAlign(logProbs, blankId: blankId)
+        }
+        return beamSearch(logProbs, hotwords: hotwords)
+    }
+
+    /// Best-path decoding: per-frame argmax, collapse repeats, drop blanks
+    static func greedyDecode(_ logits: CTCLogits, blankId: Int32 = 0) -> [Int32] {
+        greedyAlign(logits, blankId: blankId).map(\.id)
+    }
+
+    /// Best-path decoding keeping each token's run of frames
+    static func greedyAlign(_ logits: CTCLogits, blankId: Int32 = 0) -> [CTCToken] {
+        var tokens: [CTCToken] = []
+        var previous: Int32 = -1
+        logits.forEachFrame { frame, row in
+            var maxValue: Float = 0
+            var maxIndex: vDSP_Length = 0
+            vDSP_maxvi(row, 1, &maxValue, &maxIndex, vDSP_Length(logits.vocabularySize))
+            let token = Int32(maxIndex)
+            if token == previous && token != blankId {
+                tokens[tokens.count - 1].endFrame = Int32(frame + 1)
+            } else if token != blankId {
+                tokens.append(CTCToken(id: token, startFrame: Int32(frame), endFrame: Int32(frame + 1)))
+            }
+            previous = token
+        }
+        return tokens
+    }
+
+    private struct Beam {
+        var prefix: Int32
+        var last: Int32
+        var blank: Float = -.infinity
+        var nonBlank: Float = -.infinity
+        var context: HotwordTrie.State
+
+        var total: Float { logAdd(blank, nonBlank) }
+    }
+
+    private func beamSearch(_ logProbs: CTCLogits, hotwords: HotwordTrie) -> [CTCToken] {
+        let vocabularySize = logProbs.vocabularySize
+        var prefixes = PrefixTable()
+        var beams = [Beam(prefix: PrefixTable.empty, last: -1, blank: 0, context: HotwordTrie.State())]
+        let blankSkip = logf(blankSkipProbability)
+        let hotwordStarts = hotwords.continuations(of: HotwordTrie.root)
+
+        var next: [Beam] = []
+        var slots: [Int32: Int] = [:]
+        var candidates: [Int32] = []
+
+        logProbs.forEachFrame { frame, row in
+            let blankScore = row[Int(blankId)]
+
+            var maxValue: Float = 0
+            vDSP_maxv(row, 1, &maxValue, vDSP_Length(vocabularySize))
+            let floor = maxValue - pruneThreshold
+
+            candidates.removeAll(keepingCapacity: true)
+            if blankScore < blankSkip {
+                topTokens(row, count: vocabularySize, floor: floor, into: &candidates)
+                for token in hotwordStarts where row[Int(token)] >= floor && !candidates.contains(token) {
+                    candidates.append(token)
+                }
+            }
+
+            next.removeAll(keepingCapacity: true)
+            slots.removeAll(keepingCapacity: true)
+
+            func slot(for prefix: Int32, last: Int32, context: HotwordTrie.State) -> Int {
+                if let index = slots[prefix] { return index }
+                next.append(Beam(prefix: prefix, last: last, context: context))
+                slots[prefix] = next.count - 1
+                return next.count - 1
+            }
+
+            for beam in beams {
+                let total = beam.total
+
+                // Blank: prefix unchanged
+                let same = slot(for: beam.prefix, last: beam.last, context: beam.context)
+                next[same].blank = logAdd(next[same].blank, total + blankScore)
+
+                // Repeated last token without a blank collapses into the same prefix
+                if beam.last >= 0 {
+                    next[same].nonBlank = logAdd(next[same].nonBlank, beam.nonBlank + row[Int(beam.last)])
+                }
+
+                var extensions = candidates
+                if beam.context.node != HotwordTrie.root && blankScore < blankSkip {
+                    for token in hotwords.continuations(of: beam.context.node)
+                    where row[Int(token)] >= floor && !extensions.contains(token) {
+                        extensions.append(token)
+                    }
+                }
+
+                for token in extensions where token != blankId {
+                    // A repeat only starts a new token after a blank
+                    let score = (token == beam.last ? beam.blank : total) + row[Int(token)]
+                    let child = prefixes.extend(beam.prefix, with: token, at: Int32(frame))
+                    let index = slot(for: child, last: token, context: hotwords.advance(beam.context, with: token))
+                    next[index].nonBlank = logAdd(next[index].nonBlank, score)
+                }
+            }
+
+            if next.count > beamWidth {
+                next.sort { $0.total + hotwords.score($0.context) > $1.total + hotwords.score($1.context) }
+                next.removeSubrange(beamWidth...)
+            }
+            swap(&beams, &next)
+        }
+
+        // Only completed hotwords count at the end
+        let best = beams.max { $0.total + $0.context.committed < $1.total + $1.context.committed }
+        return best.map { prefixes.tokens(of: $0.prefix) } ?? []
+    }
+
+    /// Up to `beamWidth` highest-scoring non-blank tokens at or above `floor`
+    private func topTokens(_ row: UnsafePointer<Float>, count: Int, floor: Float, into result: inout [Int32]) {
+        var scores: [Float] = []
+        scores.reserveCapacity(beamWidth)
+        for token in 0..<count where Int32(token) != blankId {
+            let score = row[token]
+            guard score >= floor, scores.count < beamWidth || score > scores[scores.count - 1] else { continue }
+
+            // Insertion into a short descending list
+            var position = scores.count
+            while position > 0 && scores[position - 1] < score {
+                position -= 1
+            }
+            scores.insert(score, at: position)
+            result.insert(Int32(token), at: position)
+            if scores.count > beamWidth {
+                scores.removeLast()
+                result.removeLast()
+            }
+        }
+    }
+}
+
+/// Interned token prefixes: each prefix is an index with a parent link, so beams
+/// compare and merge by integer instead of by token array. Each prefix also records
+/// the frame its last token was first emitted on.
+private struct PrefixTable {
+    static let empty: Int32 = 0
+
+    private var parents: [Int32] = [-1]
+    private var tokens: [Int32] = [-1]
+    private var frames: [Int32] = [-1]
+    private var index: [UInt64: Int32] = [:]
+
+    mutating func extend(_ prefix: Int32, with token: Int32, at frame: Int32) -> Int32 {
+        let key = UInt64(UInt32(bitPattern: prefix)) << 32 | UInt64(UInt32(bitPattern: token))
+        if let existing = index[key] { return existing }
+        let id = Int32(parents.count)
+        parents.append(prefix)
+        tokens.append(token)
+        frames.append(frame)
+        index[key] = id
+        return id
+    }
+
+    /// Tokens of a prefix, each spanning the frame it was emitted on (CTC output is peaky,
+    /// so this is close to the best path's runs)
+    func tokens(of prefix: Int32) -> [CTCToken] {
+        var result: [CTCToken] = []
+        var node = prefix
+        while node != Self.empty {
+            let frame = frames[Int(node)]
+            result.append(CTCToken(id: tokens[Int(node)], startFrame: frame, endFrame: frame + 1))
+            node = parents[Int(node)]
+        }
+        return result.reversed()
+    }
+}
+
+/// log(exp(a) + exp(b)) without overflow
+private func logAdd(_ a: Float, _ b: Float) -> Float {
+    if a == -.infinity { return b }
+    if b == -.infinity { return a }
+    return max(a, b) + log1pf(expf(-abs(a - b)))
+}
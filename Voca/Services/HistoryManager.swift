@@ -2,6 +2,7 @@ import Foundation
 import AVFoundation
 
 struct HistoryItem {
+    let id: UInt64
     let text: String
     let audioURL: URL?
     let timestamp: Date
@@ -10,10 +11,15 @@ struct HistoryItem {
 class HistoryManager {
     static let shared = HistoryManager()
 
-    private var history: [HistoryItem] = []
+    private let store = HistoryStore()
     private var currentIndex: Int = -1
-    private let maxItems = 10
+    /// Items shown in the menu/settings and cycled by the paste-history shortcut
+    private let recentItems = 10
+    /// Recordings and word timings older than this many entries are deleted (transcripts
+    /// are kept)
+    private let maxAudioItems = 100
     private var audioPlayer: AVAudioPlayer?
+    private let audioQueue = DispatchQueue(label: "com.voca.history.audio", qos: .utility)
 
     // Directory for storing audio recordings
     private lazy var recordingsDir: URL = {
@@ -23,33 +29,38 @@ class HistoryManager {
         return dir
     }()
 
-    func add(_ text: String, audioURL: URL? = nil) {
-        var savedAudioURL: URL? = nil
+    /// Total number of stored transcriptions
+    var count: Int { store?.count ?? 0 }
 
-        // Copy audio file to permanent storage if provided
-        if let sourceURL = audioURL {
-            let filename = "recording_\(Date().timeIntervalSince1970).wav"
-            let destURL = recordingsDir.appendingPathComponent(filename)
-            do {
-                try FileManager.default.copyItem(at: sourceURL, to: destURL)
-                savedAudioURL = destURL
-                print("Saved recording to: \(destURL.path)")
-            } catch {
-                print("Failed to save recording: \(error)")
+    func add(_ text: String, audioURL: URL? = nil, words: [TimedWord] = []) {
+        guard let entry = store?.append(text, hasAudio: audioURL != nil) else { return }
+
+        // Word timings (for subtitle export) live beside the recording as JSON
+        if !words.isEmpty, let data = try? JSONEncoder().encode(words) {
+            let wordsURL = self.wordsURL(for: entry.id)
+            audioQueue.async {
+                try? data.write(to: wordsURL, options: .atomic)
             }
         }
 
-        let item = HistoryItem(text: text, audioURL: savedAudioURL, timestamp: Date())
+        // Encode the recording off the calling thread
+        if let sourceURL = audioURL {
+            let destURL = recordingURL(for: entry.id)
+            audioQueue.async {
+                Self.saveRecording(from: sourceURL, to: destURL)
+            }
+        }
 
-        // Add to front, remove oldest if over limit
-        history.insert(item, at: 0)
-        if history.count > maxItems {
-            // Delete old audio file before removing
-            if let oldAudioURL = history.last?.audioURL {
-                try? FileManager.default.removeItem(at: oldAudioURL)
+        // The entry falling out of the window loses its recording and word timings
+        if count > maxAudioItems, let expired = store?.entry(at: count - 1 - maxAudioItems) {
+            let expiredURLs = [recordingURL(for: expired.id), wordsURL(for: expired.id)]
+            audioQueue.async {
+                for url in expiredURLs {
+                    try? FileManager.default.removeItem(at: url)
+                }
             }
-            history.removeLast()
         }
+
         // Reset index for cycling
         currentIndex = -1
 
@@ -59,24 +70,124 @@ class HistoryManager {
         }
     }
 
+    /// Replace an item's transcript and word timings (e.g. after transcribing its recording
+    /// again); it keeps its place, time and audio
+    func update(id: UInt64, text: String, words: [TimedWord]) {
+        guard let entry = store?.entry(id: id), store?.update(entry, text: text) != nil else { return }
+
+        let wordsURL = self.wordsURL(for: id)
+        let data = words.isEmpty ? nil : try? JSONEncoder().encode(words)
+        audioQueue.async {
+            if let data = data {
+                try? data.write(to: wordsURL, options: .atomic)
+            } else {
+                try? FileManager.default.removeItem(at: wordsURL)
+            }
+        }
+
+        DispatchQueue.main.async {
+            NotificationCenter.default.post(name: .historyDidUpdate, object: nil)
+        }
+    }
+
     func getNext() -> String? {
-        guard !history.isEmpty else { return nil }
+        let available = min(count, recentItems)
+        guard available > 0 else { return nil }
 
-        currentIndex = (currentIndex + 1) % history.count
-        return history[currentIndex].text
+        currentIndex = (currentIndex + 1) % available
+        return getItem(at: currentIndex)?.text
     }
 
     func getAll() -> [String] {
-        return history.map { $0.text }
+        return getAllItems().map { $0.text }
     }
 
+    /// The most recent items, newest first
     func getAllItems() -> [HistoryItem] {
-        return history
+        return (0..<min(count, recentItems)).compactMap { getItem(at: $0) }
     }
 
+    /// Item by recency (0 = newest); the transcript is read from disk on demand
     func getItem(at index: Int) -> HistoryItem? {
-        guard index >= 0 && index < history.count else { return nil }
-        return history[index]
+        guard let store = store, index >= 0, let entry = store.entry(at: store.count - 1 - index) else { return nil }
+        return item(for: entry)
+    }
+
+    /// Item by id, if it is still stored
+    func item(id: UInt64) -> HistoryItem? {
+        store?.entry(id: id).map(item(for:))
+    }
+
+    /// Full-text search over all stored transcripts, newest first
+    func search(_ query: String, limit: Int = 50) -> [HistoryItem] {
+        guard let store = store else { return [] }
+        return store.search(query, limit: limit).compactMap { ordinal in
+            store.entry(at: ordinal).map(item(for:))
+        }
+    }
+
+    private func item(for entry: HistoryStore.Entry) -> HistoryItem {
+        let audioURL = recordingURL(for: entry.id)
+        return HistoryItem(
+            id: entry.id,
+            text: store?.text(of: entry) ?? "",
+            audioURL: entry.hasAudio && FileManager.default.fileExists(atPath: audioURL.path) ? audioURL : nil,
+            timestamp: entry.timestamp
+        )
+    }
+
+    /// Word timings saved with an item, or empty if the model gave none
+    func words(for item: HistoryItem) -> [TimedWord] {
+        guard let data = try? Data(contentsOf: wordsURL(for: item.id)) else { return [] }
+        return (try? JSONDecoder().decode([TimedWord].self, from: data)) ?? []
+    }
+
+    private func wordsURL(for id: UInt64) -> URL {
+        recordingsDir.appendingPathComponent("\(id).words.json")
+    }
+
+    private func recordingURL(for id: UInt64) -> URL {
+        recordingsDir.appendingPathComponent("\(id).wav")
+    }
+
+    /// Re-encode a float32 recording as 16-bit PCM (half the size), falling back to a move
+    private static func saveRecording(from sourceURL: URL, to destURL: URL) {
+        let tempURL = destURL.appendingPathExtension("partial")
+        do {
+            let input = try AVAudioFile(forReading: sourceURL)
+            let format = input.processingFormat
+            let settings: [String: Any] = [
+                AVFormatIDKey: kAudioFormatLinearPCM,
+                AVSampleRateKey: format.sampleRate,
+                AVNumberOfChannelsKey: format.channelCount,
+                AVLinearPCMBitDepthKey: 16,
+                AVLinearPCMIsFloatKey: false,
+                AVLinearPCMIsBigEndianKey: false,
+            ]
+            do {
+                // Scoped so the output file is closed before the rename
+                let output = try AVAudioFile(forWriting: tempURL, settings: settings,
+                                             commonFormat: format.commonFormat, interleaved: format.isInterleaved)
+                guard let buffer = AVAudioPCMBuffer(pcmFormat: format, frameCapacity: 16384) else {
+                    throw CocoaError(.fileReadUnknown)
+                }
+                while input.framePosition < input.length {
+                    try input.read(into: buffer)
+                    guard buffer.frameLength > 0 else { break }
+                    try output.write(from: buffer)
+                }
+            }
+            try FileManager.default.moveItem(at: tempURL, to: destURL)
+            try? FileManager.default.removeItem(at: sourceURL)
+        } catch {
+            print("Failed to encode recording (\(error)), moving it instead")
+            try? FileManager.default.removeItem(at: tempURL)
+            do {
+                try FileManager.default.moveItem(at: sourceURL, to: destURL)
+            } catch {
+                print("Failed to save recording: \(error)")
+            }
+        }
     }
 
     /// Play the audio recording for a history item
@@ -104,13 +215,16 @@ class HistoryManager {
     }
 
     func clear() {
-        // Delete all audio files
-        for item in history {
-            if let audioURL = item.audioURL {
-                try? FileManager.default.removeItem(at: audioURL)
+        store?.removeAll()
+        currentIndex = -1
+
+        // Delete all audio files (after any pending writes)
+        let dir = recordingsDir
+        audioQueue.async {
+            let files = (try? FileManager.default.contentsOfDirectory(at: dir, includingPropertiesForKeys: nil)) ?? []
+            for file in files {
+                try? FileManager.default.removeItem(at: file)
             }
         }
-        history.removeAll()
-        currentIndex = -1
     }
 }
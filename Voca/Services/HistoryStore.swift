@@ -0,0 +1,352 @@
+import Foundation
+
+/// Persistent transcription history: an append-only log plus a trigram full-text index.
+///
+/// Each log record is a fixed header followed by the UTF-8 transcript. Launch only walks
+/// the headers; transcripts are read on demand (`pread`, with a small cache) and indexed
+/// in the background. A torn record at the tail (crash mid-write) is truncated away.
+/// A record reusing an earlier id replaces that entry's transcript in place.
+final class HistoryStore {
+    struct Entry {
+        let id: UInt64
+        let timestamp: Date
+        let hasAudio: Bool
+        fileprivate let textOffset: UInt64
+        fileprivate let textLength: UInt32
+    }
+
+    private static let recordMagic: UInt32 = 0x31524856  // "VHR1"
+    // magic u32, text length u32, id u64, timestamp f64, has-audio u8
+    private static let headerSize = 25
+
+    private let logPath: String
+    private let fd: Int32
+    private let lock = NSLock()
+    private let indexQueue = DispatchQueue(label: "com.voca.history.index", qos: .utility)
+    private let textCache = NSCache<NSNumber, NSString>()
+
+    private var entries: [Entry] = []
+    private var logSize: UInt64 = 0
+    private var index = TrigramIndex()
+    private var isIndexReady = false
+    /// Bumped by `removeAll`, so a stale background index build is discarded
+    private var generation = 0
+
+    static var defaultDirectory: URL {
+        let appSupport = FileManager.default.urls(for: .applicationSupportDirectory, in: .userDomainMask).first!
+        return appSupport.appendingPathComponent("Voca/history")
+    }
+
+    init?(directory: URL = defaultDirectory) {
+        try? FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+        logPath = directory.appendingPathComponent("history.log").path
+        fd = open(logPath, O_RDWR | O_CREAT | O_APPEND, 0o644)
+        guard fd >= 0 else {
+            print("⚠️ History: cannot open \(logPath)")
+            return nil
+        }
+        textCache.countLimit = 256
+
+        let start = Date()
+        let log = (try? Data(contentsOf: URL(fileURLWithPath: logPath))) ?? Data()
+        loadHeaders(log)
+        print("✓ History: \(entries.count) entries loaded in \(Int(Date().timeIntervalSince(start) * 1000))ms")
+
+        // Index existing transcripts off the main thread, from the same read
+        let loaded = entries
+        indexQueue.async { [weak self] in
+            var built = TrigramIndex()
+            for (ordinal, entry) in loaded.enumerated() {
+                let start = Int(entry.textOffset)
+                let text = String(decoding: log[start..<(start + Int(entry.textLength))], as: UTF8.self)
+                built.add(text, ordinal: Int32(ordinal))
+            }
+            self?.finishIndexing(built, count: loaded.count, generation: 0)
+        }
+    }
+
+    deinit {
+        close(fd)
+    }
+
+    var count: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return entries.count
+    }
+
+    /// Entry by ordinal (0 = oldest)
+    func entry(at ordinal: Int) -> Entry? {
+        lock.lock()
+        defer { lock.unlock() }
+        return ordinal >= 0 && ordinal < entries.count ? entries[ordinal] : nil
+    }
+
+    /// Entry by id
+    func entry(id: UInt64) -> Entry? {
+        lock.lock()
+        defer { lock.unlock() }
+        return ordinal(of: id).map { entries[$0] }
+    }
+
+    /// Transcript of an entry, read from the log on first access
+    func text(of entry: Entry) -> String {
+        let key = NSNumber(value: entry.id)
+        if let cached = textCache.object(forKey: key) {
+            return cached as String
+        }
+        var bytes = [UInt8](repeating: 0, count: Int(entry.textLength))
+        let read = bytes.withUnsafeMutableBytes { pread(fd, $0.baseAddress, $0.count, off_t(entry.textOffset)) }
+        let text = read == bytes.count ? String(decoding: bytes, as: UTF8.self) : ""
+        textCache.setObject(text as NSString, forKey: key)
+        return text
+    }
+
+    /// Append a transcript (one `write` to the log); returns the new entry
+    @discardableResult
+    func append(_ text: String, timestamp: Date = Date(), hasAudio: Bool) -> Entry? {
+        lock.lock()
+        defer { lock.unlock() }
+
+        let id = (entries.last?.id ?? 0) + 1
+        guard let entry = writeRecord(text, id: id, timestamp: timestamp, hasAudio: hasAudio) else { return nil }
+        entries.append(entry)
+
+        // Keep the index current once the background build has caught up
+        if isIndexReady {
+            index.add(text, ordinal: Int32(entries.count - 1))
+        }
+        return entry
+    }
+
+    /// Replace an entry's transcript, keeping its id, timestamp, audio flag and position.
+    /// The new text is appended under the same id; the index is rebuilt in the background
+    /// (posting lists must stay sorted), with searches scanning until it is ready.
+    @discardableResult
+    func update(_ entry: Entry, text: String) -> Entry? {
+        lock.lock()
+        defer { lock.unlock() }
+
+        guard let ordinal = ordinal(of: entry.id),
+              let updated = writeRecord(text, id: entry.id, timestamp: entries[ordinal].timestamp,
+                                        hasAudio: entries[ordinal].hasAudio) else {
+            return nil
+        }
+        entries[ordinal] = updated
+        rebuildIndex()
+        return updated
+    }
+
+    /// Write one record at the end of the log (holding the lock)
+    private func writeRecord(_ text: String, id: UInt64, timestamp: Date, hasAudio: Bool) -> Entry? {
+        let utf8 = Array(text.utf8)
+        var record = Data(capacity: Self.headerSize + utf8.count)
+        withUnsafeBytes(of: Self.recordMagic.littleEndian) { record.append(contentsOf: $0) }
+        withUnsafeBytes(of: UInt32(utf8.count).littleEndian) { record.append(contentsOf: $0) }
+        withUnsafeBytes(of: id.littleEndian) { record.append(contentsOf: $0) }
+        withUnsafeBytes(of: timestamp.timeIntervalSince1970.bitPattern.littleEndian) { record.append(contentsOf: $0) }
+        record.append(hasAudio ? 1 : 0)
+        record.append(contentsOf: utf8)
+
+        let written = record.withUnsafeBytes { write(fd, $0.baseAddress, $0.count) }
+        guard written == record.count else {
+            print("⚠️ History: failed to append to log")
+            if written > 0 { ftruncate(fd, off_t(logSize)) }
+            return nil
+        }
+
+        let entry = Entry(id: id, timestamp: timestamp, hasAudio: hasAudio,
+                          textOffset: logSize + UInt64(Self.headerSize), textLength: UInt32(utf8.count))
+        logSize += UInt64(record.count)
+        textCache.setObject(text as NSString, forKey: NSNumber(value: id))
+        return entry
+    }
+
+    /// Ordinal of an id; ids increase with ordinal (holding the lock)
+    private func ordinal(of id: UInt64) -> Int? {
+        var low = 0
+        var high = entries.count
+        while low < high {
+            let mid = (low + high) / 2
+            if entries[mid].id < id { low = mid + 1 } else { high = mid }
+        }
+        return low < entries.count && entries[low].id == id ? low : nil
+    }
+
+    /// Discard the index and build it again off the calling thread (holding the lock)
+    private func rebuildIndex() {
+        isIndexReady = false
+        generation += 1
+        let snapshot = entries
+        let buildGeneration = generation
+        indexQueue.async { [weak self] in
+            guard let self = self else { return }
+            var built = TrigramIndex()
+            for (ordinal, entry) in snapshot.enumerated() {
+                built.add(self.text(of: entry), ordinal: Int32(ordinal))
+            }
+            self.finishIndexing(built, count: snapshot.count, generation: buildGeneration)
+        }
+    }
+
+    /// Ordinals of entries containing `query` (case-insensitive), newest first
+    func search(_ query: String, limit: Int = 50) -> [Int] {
+        let needle = query.lowercased()
+        guard !needle.isEmpty else { return [] }
+
+        lock.lock()
+        let snapshot = entries
+        let candidates = isIndexReady ? index.candidates(for: needle) : nil
+        lock.unlock()
+
+        // Trigram hits are a superset, so each is confirmed against the transcript.
+        // Without candidates (index still building, or query shorter than a trigram)
+        // every entry is scanned.
+        let ordinals = candidates.map { $0.reversed().map(Int.init) } ?? Array(snapshot.indices.reversed())
+        var results: [Int] = []
+        for ordinal in ordinals where text(of: snapshot[ordinal]).lowercased().contains(needle) {
+            results.append(ordinal)
+            if results.count >= limit { break }
+        }
+        return results
+    }
+
+    /// Block until the launch-time index build has finished
+    func waitUntilIndexed() {
+        indexQueue.sync {}
+    }
+
+    func removeAll() {
+        lock.lock()
+        defer { lock.unlock() }
+        ftruncate(fd, 0)
+        entries.removeAll()
+        logSize = 0
+        index = TrigramIndex()
+        isIndexReady = true
+        generation += 1
+        textCache.removeAllObjects()
+    }
+
+    // MARK: - Loading
+
+    private func loadHeaders(_ log: Data) {
+        log.withUnsafeBytes { (bytes: UnsafeRawBufferPointer) in
+            var offset = 0
+            while offset + Self.headerSize <= bytes.count {
+                let magic = UInt32(littleEndian: bytes.loadUnaligned(fromByteOffset: offset, as: UInt32.self))
+                let length = Int(UInt32(littleEndian: bytes.loadUnaligned(fromByteOffset: offset + 4, as: UInt32.self)))
+                guard magic == Self.recordMagic, offset + Self.headerSize + length <= bytes.count else { break }
+
+                let id = UInt64(littleEndian: bytes.loadUnaligned(fromByteOffset: offset + 8, as: UInt64.self))
+                let time = Double(bitPattern: UInt64(littleEndian: bytes.loadUnaligned(fromByteOffset: offset + 16, as: UInt64.self)))
+                let entry = Entry(id: id, timestamp: Date(timeIntervalSince1970: time),
+                                  hasAudio: bytes[offset + 24] != 0,
+                                  textOffset: UInt64(offset + Self.headerSize), textLength: UInt32(length))
+                // An id seen before is an update of that entry
+                if let last = entries.last, id <= last.id {
+                    if let ordinal = ordinal(of: id) {
+                        entries[ordinal] = entry
+                    }
+                } else {
+                    entries.append(entry)
+                }
+                offset += Self.headerSize + length
+            }
+            logSize = UInt64(offset)
+            if offset < bytes.count {
+                print("⚠️ History: dropping \(bytes.count - offset) bytes of incomplete record")
+                ftruncate(fd, off_t(offset))
+            }
+        }
+    }
+
+    private func finishIndexing(_ built: TrigramIndex, count: Int, generation buildGeneration: Int) {
+        lock.lock()
+        defer { lock.unlock() }
+        guard generation == buildGeneration else { return }
+
+        // Catch up on entries appended while the build ran
+        index = built
+        for ordinal in count..<entries.count {
+            index.add(text(of: entries[ordinal]), ordinal: Int32(ordinal))
+        }
+        isIndexReady = true
+    }
+}
+
+// MARK: - Trigram Index
+
+/// Posting lists of entry ordinals per lowercase scalar trigram. Ordinals are added
+/// in increasing order, so every list stays sorted and intersections are linear.
+private struct TrigramIndex {
+    private var postings: [UInt64: [Int32]] = [:]
+
+    mutating func add(_ text: String, ordinal: Int32) {
+        forEachTrigram(text.lowercased()) { key in
+            if postings[key]?.last != ordinal {
+                postings[key, default: []].append(ordinal)
+            }
+        }
+    }
+
+    /// Entries containing every trigram of a lowercased query (ascending), or nil if
+    /// the query is too short to have a trigram
+    func candidates(for query: String) -> [Int32]? {
+        var lists: [[Int32]] = []
+        var seen = Set<UInt64>()
+        var missing = false
+        forEachTrigram(query) { key in
+            guard seen.insert(key).inserted else { return }
+            if let list = postings[key] {
+                lists.append(list)
+            } else {
+                missing = true
+            }
+        }
+        if missing { return [] }
+        guard !lists.isEmpty else { return nil }
+
+        lists.sort { $0.count < $1.count }
+        var result = lists[0]
+        for list in lists.dropFirst() {
+            result = intersect(result, list)
+            if result.isEmpty { break }
+        }
+        return result
+    }
+
+    private func forEachTrigram(_ text: String, _ body: (UInt64) -> Void) {
+        var a: UInt64 = 0
+        var b: UInt64 = 0
+        var count = 0
+        for scalar in text.unicodeScalars {
+            let c = UInt64(scalar.value)
+            count += 1
+            if count >= 3 {
+                body(a << 42 | b << 21 | c)
+            }
+            a = b
+            b = c
+        }
+    }
+
+    private func intersect(_ lhs: [Int32], _ rhs: [Int32]) -> [Int32] {
+        var result: [Int32] = []
+        result.reserveCapacity(min(lhs.count, rhs.count))
+        var i = 0
+        var j = 0
+        while i < lhs.count && j < rhs.count {
+            if lhs[i] == rhs[j] {
+                result.append(lhs[i])
+                i += 1
+                j += 1
+            } else if lhs[i] < rhs[j] {
+                i += 1
+            } else {
+                j += 1
+            }
+        }
+        return result
+    }
+}
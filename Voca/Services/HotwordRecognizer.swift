@@ -0,0 +1,153 @@
+import Foundation
+import VoicePipeline
+
+/// SenseVoice engines that decode their CTC output app-side, so custom words can bias the
+/// search and the language tag is available
+protocol CTCRecognizer: SpeechRecognizer {
+    /// Storage of an utterance's logits, as the engine was loaded
+    var precision: CTCLogits.Precision { get }
+    /// Replace the custom words the search is biased towards (empty decodes greedily)
+    func setHotwords(_ words: [String])
+}
+
+/// SenseVoice on CoreML, the registry's `.senseVoice` engine when ONNX is off.
+///
+/// `ASREngine` only returns greedy-decoded text, so this runs the same front-end
+/// (mel → LFR → CoreML) through VoicePipeline's primitives to get the raw CTC logits,
+/// then decodes them with `CTCBeamDecoder` and a trie of the hotwords' BPE tokens.
+final class HotwordRecognizer: CTCRecognizer {
+    /// SenseVoice prepends language/event/emotion/ITN query frames to the encoder output
+    private static let queryFrames = 4
+
+    private let model: CoreMLModel
+    private let tokenizer: BPETokenizer
+    private let lock = NSLock()
+    private var hotwords = HotwordTrie()
+    private var hotwordList: [String] = []
+
+    var decoder = CTCBeamDecoder()
+    /// Storage for the logits of an utterance (fp16 halves their size)
+    var precision: CTCLogits.Precision = AppSettings.shared.halfPrecisionLogits ? .half : .single
+
+    private init(model: CoreMLModel, tokenizer: BPETokenizer) {
+        self.model = model
+        self.tokenizer = tokenizer
+    }
+
+    static func load(modelDir: String, assetsDir: String) -> HotwordRecognizer? {
+        let modelPath = "\(modelDir)/sensevoice-500-itn.mlmodelc"
+        guard let model = CoreMLModel.companion.load(path: modelPath) else {
+            print("⚠️ SenseVoice: failed to load \(modelPath)")
+            return nil
+        }
+        guard let tokenizer = BPETokenizer.load(modelPath: "\(assetsDir)/chn_jpn_yue_eng_ko_spectok.bpe.model") else {
+            print("⚠️ SenseVoice: failed to load BPE model")
+            return nil
+        }
+        _ = AudioProcessing.shared.loadMelFilterbank(path: "\(assetsDir)/mel_filterbank.bin")
+        return HotwordRecognizer(model: model, tokenizer: tokenizer)
+    }
+
+    /// Replace the hotword list (the trie is only rebuilt when the list changes)
+    func setHotwords(_ words: [String]) {
+        lock.lock()
+        defer { lock.unlock() }
+        guard words != hotwordList else { return }
+
+        hotwordList = words
+        hotwords = HotwordTrie(words: words, tokenizer: tokenizer, boost: hotwords.boost)
+    }
+
+    var hasWordTimings: Bool { true }
+
+    func transcribe(audio: KotlinFloatArray) -> String? {
+        transcribeTimed(audio: audio)?.text
+    }
+
+    /// Transcribe with word timings taken from the beam search's alignment; the beam search
+    /// is skipped when blanks dominate the encoder output
+    func transcribeTimed(audio: KotlinFloatArray) -> TimedTranscript? {
+        guard var logits = logits(audio: audio) else { return nil }
+        let confidence = SpeechConfidence(nonBlankRatio: logits.nonBlankRatio(from: Self.queryFrames))
+        guard !confidence.isBelowThreshold else { return TimedTranscript(text: "", confidence: confidence) }
+
+        var transcript = decodeTimed(&logits)
+        transcript.confidence = confidence
+        transcript.language = logits.detectedLanguage()
+        return transcript
+    }
+
+    /// Log-softmax and beam-search CTC logits, then detokenize the text tokens
+    func decode(_ logits: inout CTCLogits) -> String {
+        decodeTimed(&logits).text
+    }
+
+    func decodeTimed(_ logits: inout CTCLogits) -> TimedTranscript {
+        let span = Trace.begin(.decode)
+        defer { Trace.end(span) }
+
+        lock.lock()
+        let trie = hotwords
+        lock.unlock()
+
+        logits.applyLogSoftmax()
+        return WordTiming.transcript(decoder.decodeAligned(logits, hotwords: trie), tokenizer: tokenizer)
+    }
+
+    /// Raw CTC logits for the valid (unpadded) frames of an utterance
+    func logits(for samples: [Float]) -> CTCLogits? {
+        let audio = KotlinFloatArray(size: Int32(samples.count))
+        Trace.allocated(bytes: samples.count * MemoryLayout<Float>.size)
+        for (index, sample) in samples.enumerated() {
+            audio.set(index: Int32(index), value: sample)
+        }
+        return logits(audio: audio)
+    }
+
+    func logits(audio: KotlinFloatArray) -> CTCLogits? {
+        let mel = Trace.span(.mel) { AudioProcessing.shared.computeMelSpectrogram(audio: audio) }
+        let features = Trace.span(.lfr) { LFRTransform.shared.apply(mel: mel) }
+        let inference = Trace.begin(.inference)
+        defer { Trace.end(inference) }
+        guard !features.isEmpty,
+              let output = model.runASR(features: LFRTransform.shared.padToFixedFrames(features: features)),
+              let vocabularySize = output.first.map({ Int($0.size) }), vocabularySize > 0 else {
+            return nil
+        }
+
+        let frameCount = min(output.count, features.count + Self.queryFrames)
+        let logits = CTCLogits(frameCount: frameCount, vocabularySize: vocabularySize, precision: precision) { frame, buffer in
+            let row = output[frame]
+            for i in 0..<vocabularySize {
+                buffer[i] = row.get(index: Int32(i))
+            }
+        }
+        Trace.allocated(bytes: logits.storedBytes)
+        return logits
+    }
+}
+
+// MARK: - Hotword Spellings
+
+extension HotwordTrie {
+    /// Trie of every token sequence the words can appear as: as typed and lowercased, and
+    /// for CJK also without the word-start marker (no spaces separate CJK words)
+    init(words: [String], tokenizer: BPETokenizer, boost: Float = 1.5) {
+        self.init(boost: boost)
+        var spellings: Set<[Int32]> = []
+        for word in words {
+            let trimmed = word.trimmingCharacters(in: .whitespaces)
+            guard let first = trimmed.unicodeScalars.first else { continue }
+            for variant in Set([trimmed, trimmed.lowercased()]) {
+                spellings.insert(tokenizer.encode(variant))
+                if !first.isASCII {
+                    spellings.insert(tokenizer.encode(variant, wordStart: false))
+                }
+            }
+        }
+        spellings.forEach { insert($0) }
+        if !words.isEmpty {
+            print("📝 Hotwords: \(words.count) words, \(count) token spellings")
+        }
+    }
+}
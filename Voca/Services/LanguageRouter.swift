@@ -0,0 +1,118 @@
+import Foundation
+import VoicePipeline
+
+/// The language SenseVoice tagged an utterance with
+struct DetectedLanguage {
+    /// Tag without its brackets ("zh", "en", "nospeech", …)
+    let code: String
+    /// Softmax share of the tag among all language tags
+    let probability: Float
+}
+
+extension CTCLogits {
+    /// Language tag from the first query frame, scored among the language tokens only
+    /// (raw logits or log-probabilities alike); nil if the model has no such tokens
+    func detectedLanguage() -> DetectedLanguage? {
+        let tags = LanguageRouter.languageTokens.filter { $0.id < vocabularySize }
+        guard frameCount > 0, !tags.isEmpty else { return nil }
+
+        var scores: [Float] = []
+        forEachFrame(0..<1) { _, row in
+            scores = tags.map { row[$0.id] }
+        }
+        let best = scores.indices.max { scores[$0] < scores[$1] } ?? 0
+        let total = scores.reduce(0) { $0 + exp($1 - scores[best]) }
+        return DetectedLanguage(code: tags[best].code, probability: 1 / total)
+    }
+}
+
+/// Picks the model per utterance instead of one model for all traffic: SenseVoice runs
+/// first, and its output is kept when it tags one of its strong languages with confidence.
+/// Otherwise the same audio goes to Whisper Turbo, which covers far more languages at
+/// several times the cost.
+///
+/// SenseVoice only has tags for its own languages, so speech in any other language shows up
+/// as a low tag probability rather than as a tag of its own. Whisper computes its own
+/// 128-bin log-mel from the audio, so an escalation reuses the samples already converted
+/// for SenseVoice but none of its features. Silence is never escalated (Whisper tends to
+/// hallucinate on it).
+final class LanguageRouter {
+    enum Route: String, CaseIterable {
+        /// SenseVoice's output kept
+        case senseVoice
+        /// Tagged with a language outside `strongLanguages`
+        case otherLanguage
+        /// No language tag stood out
+        case uncertainLanguage
+        /// Too little of the CTC output was speech, or SenseVoice failed
+        case lowConfidence
+    }
+
+    struct Stats {
+        var counts: [Route: Int] = [:]
+        /// Escalations Whisper could not serve (SenseVoice's output was kept)
+        var whisperFailures = 0
+        var senseVoiceMs: Double = 0
+        var whisperMs: Double = 0
+
+        var clips: Int {
+            counts.values.reduce(0, +)
+        }
+
+        var escalated: Int {
+            clips - (counts[.senseVoice] ?? 0)
+        }
+
+        /// Model time per utterance, both passes included
+        var meanMs: Double {
+            clips == 0 ? 0 : (senseVoiceMs + whisperMs) / Double(clips)
+        }
+    }
+
+    /// Languages SenseVoice is trusted with
+    static let strongLanguages: Set<String> = ["zh", "en", "ja", "ko", "yue"]
+
+    /// SenseVoice's language token ids and their codes
+    static let languageTokens: [(id: Int, code: String)] = TokenMappings.shared.LANG_TOKENS
+        .map { (id: $0.key.intValue, code: $0.value.trimmingCharacters(in: CharacterSet(charactersIn: "<|>"))) }
+        .filter { $0.code != "auto" }
+        .sorted { $0.id < $1.id }
+
+    /// Tags below this probability don't count as a detection
+    var minLanguageProbability: Float = 0.7
+    /// Speech confidence (`SpeechConfidence.score`) below this is escalated
+    var minSpeechScore: Float = 0.5
+
+    private let lock = NSLock()
+    private var totals = Stats()
+
+    var stats: Stats {
+        lock.lock()
+        defer { lock.unlock() }
+        return totals
+    }
+
+    /// Where SenseVoice's transcript should go
+    func route(_ transcript: TimedTranscript?) -> Route {
+        guard let transcript = transcript else { return .lowConfidence }
+        guard !transcript.text.isEmpty else { return .senseVoice }
+        if let score = transcript.confidence?.score, score < minSpeechScore {
+            return .lowConfidence
+        }
+        guard let language = transcript.language, language.code != "nospeech" else { return .senseVoice }
+        if language.probability < minLanguageProbability {
+            return .uncertainLanguage
+        }
+        return Self.strongLanguages.contains(language.code) ? .senseVoice : .otherLanguage
+    }
+
+    /// Count an utterance; `whisperMs` is nil when it was not escalated
+    func record(_ route: Route, senseVoiceMs: Double, whisperMs: Double? = nil, whisperFailed: Bool = false) {
+        lock.lock()
+        defer { lock.unlock() }
+        totals.counts[route, default: 0] += 1
+        totals.senseVoiceMs += senseVoiceMs
+        totals.whisperMs += whisperMs ?? 0
+        totals.whisperFailures += whisperFailed ? 1 : 0
+    }
+}
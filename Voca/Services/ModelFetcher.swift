@@ -0,0 +1,400 @@
+import Foundation
+
+/// Downloads a zipped model with HTTP range resume, extracting while it streams.
+///
+/// Work lives in `<models>/.partial/<folder>/`: `extract/` (staging tree), `spool` (raw
+/// archive bytes of the entry in progress) and `state.json`. After a dropped connection
+/// the download continues with a Range request; after a relaunch the spool is replayed to
+/// rebuild the entry in progress first. Extra disk use is bounded by the largest
+/// compressed entry instead of the whole archive. Files are checked against their CRC-32
+/// and, when the release publishes one, a SHA-256 manifest; the finished model is then
+/// swapped into place with a single rename.
+final class ModelFetcher: NSObject {
+    enum FetchError: LocalizedError {
+        case http(Int)
+        case truncated
+        case verificationFailed(String)
+        case modelNotFound
+
+        var errorDescription: String? {
+            switch self {
+            case .http(let status): return "Server returned HTTP \(status)"
+            case .truncated: return "Download ended before the archive was complete"
+            case .verificationFailed(let path): return "Verification failed for \(path)"
+            case .modelNotFound: return "Model not found in archive"
+            }
+        }
+    }
+
+    /// `{"files": {"<path in archive>": "<sha256 hex>"}}`
+    struct Manifest: Codable {
+        let files: [String: String]
+    }
+
+    private struct State: Codable {
+        var url: String
+        var validator: String?
+        var entryStart: UInt64
+        var totalBytes: Int64?
+        var hashes: [String: String]
+    }
+
+    let archiveURL: URL
+    let manifestURL: URL?
+    let folderName: String
+    let modelsDirectory: URL
+    /// Drops in a row, without new bytes in between, before the download fails
+    var maxRetries = 5
+
+    /// Fraction of the archive received, on the main queue
+    var onProgress: ((Double) -> Void)?
+    /// Installed model directory or the failure, on the main queue
+    var onComplete: ((Result<URL, Error>) -> Void)?
+
+    /// Archive bytes received over the network (resumed bytes are not re-counted)
+    private(set) var bytesReceived: Int64 = 0
+
+    private let configuration: URLSessionConfiguration
+    private let delegateQueue: OperationQueue
+    private var session: URLSession?
+    private var task: URLSessionDataTask?
+    private var manifest: Manifest?
+    private var state: State
+    private var extractor: ZipStreamExtractor!
+    private var spool: FileHandle?
+    private var retries = 0
+    private var isCancelled = false
+    private var isDone = false
+
+    private var workDirectory: URL { modelsDirectory.appendingPathComponent(".partial/\(folderName)") }
+    private var extractDirectory: URL { workDirectory.appendingPathComponent("extract") }
+    private var spoolURL: URL { workDirectory.appendingPathComponent("spool") }
+    private var stateURL: URL { workDirectory.appendingPathComponent("state.json") }
+
+    init(archiveURL: URL, manifestURL: URL?, folderName: String, modelsDirectory: URL,
+         configuration: URLSessionConfiguration = .default) {
+        self.archiveURL = archiveURL
+        self.manifestURL = manifestURL
+        self.folderName = folderName
+        self.modelsDirectory = modelsDirectory
+        self.configuration = configuration
+        self.state = State(url: archiveURL.absoluteString, validator: nil, entryStart: 0, totalBytes: nil, hashes: [:])
+
+        delegateQueue = OperationQueue()
+        delegateQueue.maxConcurrentOperationCount = 1
+        super.init()
+    }
+
+    func start() {
+        session = URLSession(configuration: configuration, delegate: self, delegateQueue: delegateQueue)
+        delegateQueue.addOperation { [weak self] in
+            self?.fetchManifest()
+        }
+    }
+
+    /// Stop the transfer; the partial download is kept so the next `start` resumes it
+    func cancel() {
+        delegateQueue.addOperation { [weak self] in
+            guard let self = self else { return }
+            self.isCancelled = true
+            self.task?.cancel()
+            self.session?.invalidateAndCancel()
+            try? self.spool?.close()
+        }
+    }
+
+    // MARK: - Setup
+
+    private func fetchManifest() {
+        guard let manifestURL = manifestURL else {
+            prepareResume()
+            return
+        }
+        session?.dataTask(with: manifestURL) { [weak self] data, response, _ in
+            let status = (response as? HTTPURLResponse)?.statusCode ?? 0
+            self?.delegateQueue.addOperation {
+                guard let self = self, !self.isCancelled else { return }
+                if status == 200, let data = data, let manifest = try? JSONDecoder().decode(Manifest.self, from: data) {
+                    self.manifest = manifest
+                    print("✓ \(self.folderName): manifest lists \(manifest.files.count) files")
+                } else {
+                    print("⚠️ \(self.folderName): no manifest (HTTP \(status)), verifying CRC-32 only")
+                }
+                self.prepareResume()
+            }
+        }.resume()
+    }
+
+    /// Restore saved progress, replaying the spool into a fresh extractor
+    private func prepareResume() {
+        let fm = FileManager.default
+        if let data = try? Data(contentsOf: stateURL),
+           let saved = try? JSONDecoder().decode(State.self, from: data),
+           saved.url == archiveURL.absoluteString {
+            state = saved
+        } else {
+            resetWorkDirectory()
+        }
+
+        extractor = makeExtractor(startOffset: state.entryStart)
+        if state.entryStart > 0 || fm.fileExists(atPath: spoolURL.path) {
+            do {
+                let pending = (try? Data(contentsOf: spoolURL)) ?? Data()
+                try extractor.consume(pending)
+                if extractor.entryStart != state.entryStart {
+                    // Interrupted between finishing an entry and trimming the spool
+                    trimSpool(to: pending)
+                }
+                print("📝 \(folderName): resuming at \(extractor.offset) bytes")
+            } catch {
+                print("⚠️ \(folderName): discarding partial download (\(error.localizedDescription))")
+                resetWorkDirectory()
+                extractor = makeExtractor(startOffset: 0)
+            }
+        }
+
+        if spool == nil {
+            if !fm.fileExists(atPath: spoolURL.path) {
+                fm.createFile(atPath: spoolURL.path, contents: nil)
+            }
+            spool = try? FileHandle(forWritingTo: spoolURL)
+        }
+        _ = try? spool?.seekToEnd()
+        requestArchive()
+    }
+
+    private func resetWorkDirectory() {
+        let fm = FileManager.default
+        try? spool?.close()
+        spool = nil
+        try? fm.removeItem(at: workDirectory)
+        try? fm.createDirectory(at: extractDirectory, withIntermediateDirectories: true)
+        fm.createFile(atPath: spoolURL.path, contents: nil)
+        spool = try? FileHandle(forWritingTo: spoolURL)
+        state = State(url: archiveURL.absoluteString, validator: nil, entryStart: 0, totalBytes: nil, hashes: [:])
+    }
+
+    private func makeExtractor(startOffset: UInt64) -> ZipStreamExtractor {
+        let extractor = ZipStreamExtractor(destination: extractDirectory, startOffset: startOffset)
+        extractor.onFileExtracted = { [weak self] path, digest in
+            self?.state.hashes[path] = digest
+        }
+        return extractor
+    }
+
+    // MARK: - Transfer
+
+    private func requestArchive() {
+        var request = URLRequest(url: archiveURL)
+        if extractor.offset > 0 {
+            request.setValue("bytes=\(extractor.offset)-", forHTTPHeaderField: "Range")
+            // Falls back to a full 200 response if the archive changed on the server
+            if let validator = state.validator {
+                request.setValue(validator, forHTTPHeaderField: "If-Range")
+            }
+        }
+        task = session?.dataTask(with: request)
+        task?.resume()
+    }
+
+    private func handle(_ response: HTTPURLResponse) -> Bool {
+        let status = response.statusCode
+        if status == 206 {
+            // Content-Range: bytes <start>-<end>/<total>
+            let range = response.value(forHTTPHeaderField: "Content-Range") ?? ""
+            let start = range.dropFirst("bytes ".count).split(separator: "-").first.flatMap { UInt64($0) }
+            guard start == extractor.offset else {
+                fail(FetchError.http(status))
+                return false
+            }
+            state.totalBytes = range.split(separator: "/").last.flatMap { Int64($0) }
+        } else if status == 200 {
+            if extractor.offset > 0 {
+                print("⚠️ \(folderName): server ignored the range request, restarting")
+                resetWorkDirectory()
+                extractor = makeExtractor(startOffset: 0)
+            }
+            state.totalBytes = response.expectedContentLength > 0 ? response.expectedContentLength : nil
+        } else {
+            fail(FetchError.http(status))
+            return false
+        }
+
+        state.validator = response.value(forHTTPHeaderField: "ETag") ?? response.value(forHTTPHeaderField: "Last-Modified")
+        saveState()
+        return true
+    }
+
+    private func receive(_ data: Data) {
+        bytesReceived += Int64(data.count)
+        // Progress since the last drop: the next one starts a fresh count and backoff
+        retries = 0
+        let previousStart = extractor.entryStart
+        do {
+            try spool?.write(contentsOf: data)
+            try extractor.consume(data)
+        } catch {
+            print("⚠️ \(folderName): \(error.localizedDescription)")
+            task?.cancel()
+            resetWorkDirectory()
+            fail(error)
+            return
+        }
+
+        if extractor.entryStart != previousStart {
+            trimSpool(to: data)
+        }
+
+        if let total = state.totalBytes, total > 0 {
+            let progress = Double(extractor.offset) / Double(total)
+            DispatchQueue.main.async { [weak self] in
+                self?.onProgress?(progress)
+            }
+        }
+
+        if extractor.isFinished {
+            // The central directory is not needed
+            isDone = true
+            task?.cancel()
+            install()
+        }
+    }
+
+    /// An entry finished inside `data`: the spool only needs the bytes of the next one
+    private func trimSpool(to data: Data) {
+        let keep = Int(extractor.offset - extractor.entryStart)
+        if spool == nil {
+            spool = try? FileHandle(forWritingTo: spoolURL)
+        }
+        try? spool?.truncate(atOffset: 0)
+        try? spool?.write(contentsOf: data.suffix(keep))
+        state.entryStart = extractor.entryStart
+        saveState()
+    }
+
+    private func transferEnded(_ error: Error?) {
+        guard !isDone, !isCancelled else { return }
+
+        if error == nil && !extractor.isFinished {
+            fail(FetchError.truncated)
+            return
+        }
+        guard let error = error else { return }
+
+        retries += 1
+        guard retries <= maxRetries else {
+            fail(error)
+            return
+        }
+        let delay = min(pow(2.0, Double(retries - 1)), 30)
+        print("⚠️ \(folderName): \(error.localizedDescription), retrying from \(extractor.offset) in \(Int(delay))s")
+        DispatchQueue.global().asyncAfter(deadline: .now() + delay) { [weak self] in
+            self?.delegateQueue.addOperation {
+                guard let self = self, !self.isCancelled, !self.isDone else { return }
+                self.requestArchive()
+            }
+        }
+    }
+
+    // MARK: - Install
+
+    private func install() {
+        try? spool?.close()
+        spool = nil
+        session?.finishTasksAndInvalidate()
+
+        if let manifest = manifest {
+            for (path, digest) in manifest.files where state.hashes[path]?.lowercased() != digest.lowercased() {
+                resetWorkDirectory()
+                fail(FetchError.verificationFailed(path))
+                return
+            }
+        }
+
+        guard let source = Self.findFolder(named: folderName, in: extractDirectory) else {
+            resetWorkDirectory()
+            fail(FetchError.modelNotFound)
+            return
+        }
+
+        let destination = modelsDirectory.appendingPathComponent(folderName)
+        do {
+            try Self.atomicReplace(destination, with: source)
+        } catch {
+            fail(error)
+            return
+        }
+        try? FileManager.default.removeItem(at: workDirectory)
+        print("✓ \(folderName): installed (\(state.hashes.count) files verified)")
+
+        DispatchQueue.main.async { [weak self] in
+            self?.onComplete?(.success(destination))
+        }
+    }
+
+    /// The model folder at the archive root or one level down
+    private static func findFolder(named name: String, in directory: URL) -> URL? {
+        let fm = FileManager.default
+        let direct = directory.appendingPathComponent(name)
+        if fm.fileExists(atPath: direct.path) {
+            return direct
+        }
+        let children = (try? fm.contentsOfDirectory(at: directory, includingPropertiesForKeys: nil)) ?? []
+        return children.map { $0.appendingPathComponent(name) }.first { fm.fileExists(atPath: $0.path) }
+    }
+
+    /// Move `source` to `destination` in one step: readers see the old model or the new
+    /// one, never a half-written directory
+    private static func atomicReplace(_ destination: URL, with source: URL) throws {
+        if FileManager.default.fileExists(atPath: destination.path) {
+            guard renamex_np(source.path, destination.path, UInt32(RENAME_SWAP)) == 0 else {
+                throw POSIXError(POSIXErrorCode(rawValue: errno) ?? .EIO)
+            }
+            // The previous model now sits at the staging path
+            try? FileManager.default.removeItem(at: source)
+        } else {
+            guard rename(source.path, destination.path) == 0 else {
+                throw POSIXError(POSIXErrorCode(rawValue: errno) ?? .EIO)
+            }
+        }
+    }
+
+    private func saveState() {
+        if let data = try? JSONEncoder().encode(state) {
+            try? data.write(to: stateURL, options: .atomic)
+        }
+    }
+
+    private func fail(_ error: Error) {
+        isDone = true
+        try? spool?.close()
+        spool = nil
+        session?.invalidateAndCancel()
+        DispatchQueue.main.async { [weak self] in
+            self?.onComplete?(.failure(error))
+        }
+    }
+}
+
+// MARK: - URLSessionDataDelegate
+
+extension ModelFetcher: URLSessionDataDelegate {
+    func urlSession(_ session: URLSession, dataTask: URLSessionDataTask, didReceive response: URLResponse,
+                    completionHandler: @escaping (URLSession.ResponseDisposition) -> Void) {
+        guard dataTask == task, let http = response as? HTTPURLResponse else {
+            completionHandler(.allow)
+            return
+        }
+        completionHandler(handle(http) ? .allow : .cancel)
+    }
+
+    func urlSession(_ session: URLSession, dataTask: URLSessionDataTask, didReceive data: Data) {
+        guard dataTask == task, !isDone, !isCancelled else { return }
+        receive(data)
+    }
+
+    func urlSession(_ session: URLSession, task: URLSessionTask, didCompleteWithError error: Error?) {
+        guard task == self.task else { return }
+        transferEnded(error)
+    }
+}
@@ -27,8 +27,7 @@ class ModelManager: NSObject {
     var onStatusChanged: ((ASRModel, ModelStatus) -> Void)?
 
     // Active downloads
-    private var activeDownloads: [ASRModel: URLSessionDownloadTask] = [:]
-    private var downloadSessions: [ASRModel: URLSession] = [:]
+    private var activeDownloads: [ASRModel: ModelFetcher] = [:]
 
     // Model download URLs
     private let modelURLs: [ASRModel: String] = [
@@ -38,7 +37,7 @@ class ModelManager: NSObject {
     ]
 
     // Model folder names after extraction (must match what ASREngine expects)
-    private let modelFolderNames: [ASRModel: String] = [
+    static let modelFolderNames: [ASRModel: String] = [
         .senseVoice: "sensevoice-500-itn.mlmodelc",
         .whisperTurbo: "whisper-turbo",  // WhisperKit format (folder, not .mlmodelc)
         .parakeet: "parakeet-v2"  // FluidAudio format (folder with multiple models)
@@ -63,7 +62,7 @@ class ModelManager: NSObject {
     }
 
     func checkModelStatus(_ model: ASRModel) {
-        guard let folderName = modelFolderNames[model] else {
+        guard let folderName = Self.modelFolderNames[model] else {
             updateStatus(model, .error("Unknown model"))
             return
         }
@@ -88,7 +87,8 @@ class ModelManager: NSObject {
 
     func downloadModel(_ model: ASRModel) {
         guard let urlString = modelURLs[model],
-              let url = URL(string: urlString) else {
+              let url = URL(string: urlString),
+              let folderName = Self.modelFolderNames[model] else {
             updateStatus(model, .error("Invalid URL"))
             return
         }
@@ -98,164 +98,51 @@ class ModelManager: NSObject {
         if modelStatus[model] == .downloaded { return }
 
         updateStatus(model, .downloading(progress: 0))
+        try? FileManager.default.createDirectory(at: modelDirectory, withIntermediateDirectories: true)
 
-        // Create a dedicated session for this download with delegate
-        let config = URLSessionConfiguration.default
-        let session = URLSession(configuration: config, delegate: self, delegateQueue: .main)
-        downloadSessions[model] = session
-
-        let task = session.downloadTask(with: url)
-        activeDownloads[model] = task
-        task.resume()
+        // Streams and extracts the zip, resuming any partial download left from before
+        let fetcher = ModelFetcher(
+            archiveURL: url,
+            manifestURL: manifestURL(for: url),
+            folderName: folderName,
+            modelsDirectory: modelDirectory
+        )
+        fetcher.onProgress = { [weak self, weak fetcher] progress in
+            guard self?.activeDownloads[model] === fetcher else { return }
+            self?.updateStatus(model, .downloading(progress: progress))
+        }
+        fetcher.onComplete = { [weak self, weak fetcher] result in
+            guard let self = self, self.activeDownloads[model] === fetcher else { return }
+            self.activeDownloads.removeValue(forKey: model)
+            switch result {
+            case .success:
+                self.updateStatus(model, .downloaded)
+                NotificationCenter.default.post(name: .modelInstalled, object: model)
+                print("✓ Downloaded \(model.displayName)")
+            case .failure(let error):
+                self.updateStatus(model, .error(error.localizedDescription))
+            }
+        }
+        activeDownloads[model] = fetcher
+        fetcher.start()
     }
 
+    /// Pause a download; the next `downloadModel` resumes where it stopped
     func cancelDownload(_ model: ASRModel) {
         activeDownloads[model]?.cancel()
         activeDownloads.removeValue(forKey: model)
-        downloadSessions[model]?.invalidateAndCancel()
-        downloadSessions.removeValue(forKey: model)
         updateStatus(model, .notDownloaded)
     }
 
+    /// Per-file SHA-256 manifest published next to each archive (`x.zip` → `x.manifest.json`)
+    private func manifestURL(for archiveURL: URL) -> URL {
+        archiveURL.deletingPathExtension().appendingPathExtension("manifest.json")
+    }
+
     // MARK: - Private Helpers
 
     private func updateStatus(_ model: ASRModel, _ status: ModelStatus) {
         modelStatus[model] = status
         onStatusChanged?(model, status)
     }
-
-    private func findModel(for task: URLSessionTask) -> ASRModel? {
-        for (model, downloadTask) in activeDownloads {
-            if downloadTask == task {
-                return model
-            }
-        }
-        return nil
-    }
-
-    private func unzipModel(at zipURL: URL, for model: ASRModel) -> Bool {
-        guard let folderName = modelFolderNames[model] else { return false }
-
-        // Ensure model directory exists
-        try? FileManager.default.createDirectory(at: modelDirectory, withIntermediateDirectories: true)
-
-        // Create temp extraction directory
-        let tempDir = FileManager.default.temporaryDirectory.appendingPathComponent(UUID().uuidString)
-        try? FileManager.default.createDirectory(at: tempDir, withIntermediateDirectories: true)
-
-        // Unzip using ditto (built-in macOS command)
-        let process = Process()
-        process.executableURL = URL(fileURLWithPath: "/usr/bin/ditto")
-        process.arguments = ["-xk", zipURL.path, tempDir.path]
-
-        do {
-            try process.run()
-            process.waitUntilExit()
-
-            if process.terminationStatus != 0 {
-                print("Unzip failed with status \(process.terminationStatus)")
-                return false
-            }
-
-            // Find the .mlmodelc folder in extracted contents
-            let contents = try FileManager.default.contentsOfDirectory(at: tempDir, includingPropertiesForKeys: nil)
-            var modelcPath: URL?
-
-            for item in contents {
-                if item.lastPathComponent == folderName {
-                    modelcPath = item
-                    break
-                }
-                // Check one level deeper (in case zip has a wrapper folder)
-                if item.hasDirectoryPath {
-                    let subContents = try? FileManager.default.contentsOfDirectory(at: item, includingPropertiesForKeys: nil)
-                    for subItem in subContents ?? [] {
-                        if subItem.lastPathComponent == folderName {
-                            modelcPath = subItem
-                            break
-                        }
-                    }
-                }
-            }
-
-            guard let sourcePath = modelcPath else {
-                print("Could not find \(folderName) in extracted contents")
-                return false
-            }
-
-            // Move to final location
-            let destPath = modelDirectory.appendingPathComponent(folderName)
-
-            // Remove existing if present
-            try? FileManager.default.removeItem(at: destPath)
-
-            try FileManager.default.moveItem(at: sourcePath, to: destPath)
-
-            // Cleanup
-            try? FileManager.default.removeItem(at: tempDir)
-            try? FileManager.default.removeItem(at: zipURL)
-
-            return true
-        } catch {
-            print("Unzip error: \(error)")
-            try? FileManager.default.removeItem(at: tempDir)
-            return false
-        }
-    }
-}
-
-// MARK: - URLSessionDownloadDelegate
-
-extension ModelManager: URLSessionDownloadDelegate {
-    func urlSession(_ session: URLSession, downloadTask: URLSessionDownloadTask, didFinishDownloadingTo location: URL) {
-        guard let model = findModel(for: downloadTask) else { return }
-
-        // Move to a permanent temp location (the provided location is deleted after this method)
-        let tempZip = FileManager.default.temporaryDirectory.appendingPathComponent("\(model.rawValue).zip")
-        try? FileManager.default.removeItem(at: tempZip)
-
-        do {
-            try FileManager.default.moveItem(at: location, to: tempZip)
-
-            if unzipModel(at: tempZip, for: model) {
-                updateStatus(model, .downloaded)
-                print("✓ Downloaded \(model.displayName)")
-            } else {
-                updateStatus(model, .error("Failed to extract model"))
-            }
-        } catch {
-            updateStatus(model, .error("Failed to save download: \(error.localizedDescription)"))
-        }
-
-        activeDownloads.removeValue(forKey: model)
-        downloadSessions[model]?.finishTasksAndInvalidate()
-        downloadSessions.removeValue(forKey: model)
-    }
-
-    func urlSession(_ session: URLSession, downloadTask: URLSessionDownloadTask,
-                    didWriteData bytesWritten: Int64, totalBytesWritten: Int64,
-                    totalBytesExpectedToWrite: Int64) {
-        guard let model = findModel(for: downloadTask) else { return }
-
-        let progress = totalBytesExpectedToWrite > 0
-            ? Double(totalBytesWritten) / Double(totalBytesExpectedToWrite)
-            : 0
-
-        updateStatus(model, .downloading(progress: progress))
-    }
-
-    func urlSession(_ session: URLSession, task: URLSessionTask, didCompleteWithError error: Error?) {
-        guard let model = findModel(for: task), let error = error else { return }
-
-        // Don't report cancellation as error
-        if (error as NSError).code == NSURLErrorCancelled {
-            updateStatus(model, .notDownloaded)
-        } else {
-            updateStatus(model, .error(error.localizedDescription))
-        }
-
-        activeDownloads.removeValue(forKey: model)
-        downloadSessions[model]?.finishTasksAndInvalidate()
-        downloadSessions.removeValue(forKey: model)
-    }
 }
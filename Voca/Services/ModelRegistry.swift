@@ -0,0 +1,303 @@
+import Foundation
+import VoicePipeline
+
+/// A loaded recognizer handed out by `ModelRegistry`
+protocol SpeechRecognizer: AnyObject {
+    /// Transcribe 16kHz mono audio
+    func transcribe(audio: KotlinFloatArray) -> String?
+    /// Transcribe with word timings; nil if the engine exposes no alignment
+    func transcribeTimed(audio: KotlinFloatArray) -> TimedTranscript?
+    /// Whether `transcribeTimed` returns word timings
+    var hasWordTimings: Bool { get }
+}
+
+extension SpeechRecognizer {
+    func transcribeTimed(audio: KotlinFloatArray) -> TimedTranscript? {
+        nil
+    }
+
+    var hasWordTimings: Bool { false }
+}
+
+extension ASREngine: SpeechRecognizer {}
+
+/// Framework `ASRModel` implementations (Whisper) behind the recognizer interface
+private final class FrameworkRecognizer: SpeechRecognizer {
+    private let model: VoicePipeline.ASRModel
+
+    init(_ model: VoicePipeline.ASRModel) {
+        self.model = model
+    }
+
+    func transcribe(audio: KotlinFloatArray) -> String? {
+        model.transcribe(audio: audio)?.text
+    }
+}
+
+/// ASR models by `ASRModel`: loaded on first use, kept resident under a memory budget with
+/// least-recently-used eviction, and switchable while a transcription is running.
+///
+/// Callers hold the recognizer returned by `recognizer()` for one utterance. `setActive`
+/// loads the new model on a background queue and flips the active pointer once it is
+/// ready, so a switch never waits for an in-flight transcription and that transcription
+/// finishes on the model it started with. Evicted models are freed once their last user
+/// lets go.
+final class ModelRegistry {
+    struct Stats {
+        let model: ASRModel
+        /// Growth of the process footprint while loading and warming up (approximate)
+        let residentBytes: UInt64
+        let loadMs: Double
+        let isActive: Bool
+    }
+
+    private final class Resident {
+        let recognizer: SpeechRecognizer
+        let residentBytes: UInt64
+        let loadMs: Double
+        var lastUsed: UInt64 = 0
+
+        init(recognizer: SpeechRecognizer, residentBytes: UInt64, loadMs: Double) {
+            self.recognizer = recognizer
+            self.residentBytes = residentBytes
+            self.loadMs = loadMs
+        }
+    }
+
+    let modelDir: String
+    let assetsDir: String
+
+    /// Resident models beyond this are evicted, least recently used first (the active
+    /// model is never evicted)
+    var memoryBudget: UInt64 {
+        get { locked { budget } }
+        set { locked { budget = newValue } }
+    }
+
+    private let lock = NSLock()
+    private let loadQueue = DispatchQueue(label: "com.voca.models.load", qos: .userInitiated)
+    private var residents: [ASRModel: Resident] = [:]
+    private var active: ASRModel
+    private var requested: ASRModel
+    private var failed: Set<ASRModel> = []
+    private var budget: UInt64
+    private var clock: UInt64 = 0
+    /// Never initialized; only used to run the Kotlin/Native collector
+    private let collector: ASREngine
+
+    init(modelDir: String, assetsDir: String, initial: ASRModel = .senseVoice,
+         memoryBudget: UInt64 = UInt64(AppSettings.shared.modelMemoryBudgetMB) << 20) {
+        self.modelDir = modelDir
+        self.assetsDir = assetsDir
+        self.active = initial
+        self.requested = initial
+        self.budget = memoryBudget
+        self.collector = ASREngine(modelDir: modelDir, assetsDir: assetsDir)
+
+        NotificationCenter.default.addObserver(forName: .modelInstalled, object: nil, queue: nil) { [weak self] notification in
+            if let model = notification.object as? ASRModel {
+                self?.invalidate(model)
+            }
+        }
+    }
+
+    var activeModel: ASRModel {
+        locked { active }
+    }
+
+    /// The active recognizer, loading it on the calling thread if nothing is resident
+    func recognizer() -> (model: ASRModel, recognizer: SpeechRecognizer)? {
+        if let hit = residentActive() {
+            return hit
+        }
+        return loadQueue.sync {
+            // Prefer the model being switched to; fall back to SenseVoice
+            let target = locked { requested }
+            for model in [target, .senseVoice] where load(model) {
+                locked { active = model }
+                return residentActive()
+            }
+            return nil
+        }
+    }
+
+    /// A model's recognizer without making it active (e.g. a second opinion on one
+    /// utterance), loading it on the calling thread if it is not resident
+    func recognizer(for model: ASRModel) -> SpeechRecognizer? {
+        let resident: SpeechRecognizer? = locked {
+            guard let resident = residents[model] else { return nil }
+            clock += 1
+            resident.lastUsed = clock
+            return resident.recognizer
+        }
+        if let resident = resident {
+            return resident
+        }
+        return loadQueue.sync {
+            load(model) ? locked { residents[model]?.recognizer } : nil
+        }
+    }
+
+    /// Switch models without blocking: resident models switch immediately, others load
+    /// in the background and become active when ready
+    func setActive(_ model: ASRModel) {
+        let isResident: Bool = locked {
+            requested = model
+            guard residents[model] != nil else { return false }
+            active = model
+            return true
+        }
+        guard !isResident else { return }
+
+        let start = Date()
+        loadQueue.async { [weak self] in
+            guard let self = self, self.locked({ self.requested == model }) else { return }
+            guard self.load(model) else { return }
+            let switched: Bool = self.locked {
+                guard self.requested == model else { return false }
+                self.active = model
+                return true
+            }
+            if switched {
+                print("✓ Models: switched to \(model.rawValue) in \(Int(Date().timeIntervalSince(start) * 1000))ms")
+            }
+        }
+    }
+
+    /// Load a model ahead of use without making it active
+    func prefetch(_ model: ASRModel) {
+        loadQueue.async { [weak self] in
+            _ = self?.load(model)
+        }
+    }
+
+    /// Block until pending loads and switches have finished
+    func waitUntilIdle() {
+        loadQueue.sync {}
+    }
+
+    /// Drop a model (e.g. after a new version is installed) so the next use reloads it
+    func invalidate(_ model: ASRModel) {
+        locked {
+            residents.removeValue(forKey: model)
+            failed.remove(model)
+        }
+        collectGarbage()
+        if activeModel == model {
+            prefetch(model)
+        }
+    }
+
+    /// Release Kotlin/Native memory held by finished transcriptions and evicted models
+    func collectGarbage() {
+        collector.collectGarbage()
+    }
+
+    func stats() -> [Stats] {
+        locked {
+            residents.map { model, resident in
+                Stats(model: model, residentBytes: resident.residentBytes, loadMs: resident.loadMs, isActive: model == active)
+            }
+        }
+    }
+
+    // MARK: - Loading
+
+    private func residentActive() -> (model: ASRModel, recognizer: SpeechRecognizer)? {
+        locked {
+            guard let resident = residents[active] else { return nil }
+            clock += 1
+            resident.lastUsed = clock
+            return (active, resident.recognizer)
+        }
+    }
+
+    /// Load and warm up a model if it is not resident (runs on `loadQueue`)
+    private func load(_ model: ASRModel) -> Bool {
+        let known: Bool? = locked {
+            if residents[model] != nil { return true }
+            if failed.contains(model) { return false }
+            return nil
+        }
+        if let known = known {
+            return known
+        }
+
+        let start = Date()
+        let before = Self.physicalFootprint()
+        guard let recognizer = makeRecognizer(model) else {
+            print("⚠️ Models: failed to load \(model.rawValue)")
+            locked { _ = failed.insert(model) }
+            return false
+        }
+        // One pass over a second of silence maps the weights and compiles the model
+        _ = recognizer.transcribe(audio: KotlinFloatArray(size: 16000))
+        let after = Self.physicalFootprint()
+        let resident = Resident(
+            recognizer: recognizer,
+            residentBytes: after > before ? after - before : 0,
+            loadMs: Date().timeIntervalSince(start) * 1000
+        )
+        print("✓ Models: loaded \(model.rawValue) in \(Int(resident.loadMs))ms, ~\(resident.residentBytes >> 20) MB")
+
+        locked {
+            clock += 1
+            resident.lastUsed = clock
+            residents[model] = resident
+        }
+        evict(keeping: model)
+        return true
+    }
+
+    private func makeRecognizer(_ model: ASRModel) -> SpeechRecognizer? {
+        switch model {
+        case .senseVoice where AppSettings.shared.senseVoiceOnONNX:
+            return ONNXSenseVoice.load(modelsDir: "\(modelDir)/\(ONNXSenseVoice.folderName)", assetsDir: assetsDir,
+                                       sessions: AppSettings.shared.onnxSessions)
+        case .senseVoice:
+            // Exposes the CTC output (custom words, language tags) so no second copy is needed
+            return HotwordRecognizer.load(modelDir: modelDir, assetsDir: assetsDir)
+        case .whisperTurbo:
+            return WhisperASR.companion.load(modelDir: "\(modelDir)/whisper-turbo").map(FrameworkRecognizer.init)
+        case .parakeet:
+            return ParakeetTDT.load(modelDir: "\(modelDir)/\(ParakeetTDT.folderName)")
+        }
+    }
+
+    /// Evict least recently used models until the budget is met
+    private func evict(keeping justLoaded: ASRModel) {
+        var evicted: [ASRModel] = []
+        locked {
+            var total = residents.values.reduce(0) { $0 + $1.residentBytes }
+            let candidates = residents
+                .filter { $0.key != active && $0.key != requested && $0.key != justLoaded }
+                .sorted { $0.value.lastUsed < $1.value.lastUsed }
+            for (model, resident) in candidates where total > budget {
+                residents.removeValue(forKey: model)
+                total -= resident.residentBytes
+                evicted.append(model)
+            }
+        }
+        guard !evicted.isEmpty else { return }
+        print("📝 Models: evicted \(evicted.map(\.rawValue).joined(separator: ", ")) (budget \(memoryBudget >> 20) MB)")
+        collectGarbage()
+    }
+
+    private func locked<T>(_ body: () -> T) -> T {
+        lock.lock()
+        defer { lock.unlock() }
+        return body()
+    }
+
+    /// Physical memory footprint of the process (what Activity Monitor shows)
+    static func physicalFootprint() -> UInt64 {
+        var info = task_vm_info_data_t()
+        var count = mach_msg_type_number_t(MemoryLayout<task_vm_info_data_t>.size / MemoryLayout<natural_t>.size)
+        let result = withUnsafeMutablePointer(to: &info) {
+            $0.withMemoryRebound(to: integer_t.self, capacity: Int(count)) {
+                task_info(mach_task_self_, task_flavor_t(TASK_VM_INFO), $0, &count)
+            }
+        }
+        return result == KERN_SUCCESS ? info.phys_footprint : 0
+    }
+}
@@ -0,0 +1,198 @@
+import Foundation
+import CoreML
+import VoicePipeline
+
+/// SenseVoice on ONNX Runtime (CPU): the CoreML path's front-end (mel → LFR) feeding
+/// `ONNXModelManager`, then CTC decoding (greedy, or biased towards custom words; keeping
+/// word timings) and BPE detokenization.
+///
+/// A session is one loaded `ONNXModelManager` plus its logits buffer; sessions are created
+/// once and reused for every call. Up to `sessionCount` utterances run at once, one per
+/// session, so parallel file jobs scale with cores until every session is busy; further
+/// callers wait for one to free up. Feature extraction runs before a session is taken, so
+/// it overlaps with other callers' inference.
+final class ONNXSenseVoice: CTCRecognizer {
+    /// Folder under the models directory holding the ONNX export
+    static let folderName = "sensevoice-onnx"
+
+    /// SenseVoice prepends language/event/emotion/ITN query frames to the encoder output
+    private static let queryFrames = 4
+
+    private final class Session {
+        let manager: ONNXModelManager
+        /// Logits for the current utterance, grown to the longest seen and reused
+        var logits: [Float] = []
+
+        init(manager: ONNXModelManager) {
+            self.manager = manager
+        }
+    }
+
+    let sessionCount: Int
+    /// Storage for the logits of an utterance; `.half` converts row by row from the
+    /// session's float32 buffer
+    var precision: CTCLogits.Precision = AppSettings.shared.halfPrecisionLogits ? .half : .single
+
+    let tokenizer: BPETokenizer
+    private let free: DispatchSemaphore
+    private let lock = NSLock()
+    private var idle: [Session]
+    /// Callers blocked in `checkOut` (tracked while tracing)
+    private var waiting = 0
+    private var hotwords = HotwordTrie()
+    private var hotwordList: [String] = []
+
+    private init(sessions: [Session], tokenizer: BPETokenizer) {
+        self.sessionCount = sessions.count
+        self.tokenizer = tokenizer
+        self.free = DispatchSemaphore(value: sessions.count)
+        self.idle = sessions
+    }
+
+    deinit {
+        idle.forEach { $0.manager.release() }
+    }
+
+    /// Load `sessions` independent copies of the model from `modelsDir`
+    static func load(modelsDir: String, assetsDir: String, sessions: Int) -> ONNXSenseVoice? {
+        guard let tokenizer = BPETokenizer.load(modelPath: "\(assetsDir)/chn_jpn_yue_eng_ko_spectok.bpe.model") else {
+            print("⚠️ ONNX: failed to load BPE model")
+            return nil
+        }
+        _ = AudioProcessing.shared.loadMelFilterbank(path: "\(assetsDir)/mel_filterbank.bin")
+
+        var loaded: [Session] = []
+        for _ in 0..<max(1, sessions) {
+            let manager = ONNXModelManager(modelsDir: modelsDir)
+            guard manager.loadModels() else {
+                print("⚠️ ONNX: failed to load SenseVoice from \(modelsDir)")
+                loaded.forEach { $0.manager.release() }
+                return nil
+            }
+            loaded.append(Session(manager: manager))
+        }
+        print("✓ ONNX: SenseVoice loaded with \(loaded.count) session(s)")
+        return ONNXSenseVoice(sessions: loaded, tokenizer: tokenizer)
+    }
+
+    /// Replace the hotword list (the trie is only rebuilt when the list changes)
+    func setHotwords(_ words: [String]) {
+        lock.lock()
+        defer { lock.unlock() }
+        guard words != hotwordList else { return }
+
+        hotwordList = words
+        hotwords = HotwordTrie(words: words, tokenizer: tokenizer)
+    }
+
+    var hasWordTimings: Bool { true }
+
+    func transcribe(audio: KotlinFloatArray) -> String? {
+        transcribeTimed(audio: audio)?.text
+    }
+
+    func transcribeTimed(audio: KotlinFloatArray) -> TimedTranscript? {
+        let mel = Trace.span(.mel) { AudioProcessing.shared.computeMelSpectrogram(audio: audio) }
+        let features = Trace.span(.lfr) { LFRTransform.shared.apply(mel: mel) }
+        guard var logits = logits(features: features) else { return nil }
+
+        let decode = Trace.begin(.decode)
+        defer { Trace.end(decode) }
+
+        // Nothing but blanks after the query frames: no speech, so no decoding
+        let confidence = SpeechConfidence(nonBlankRatio: logits.nonBlankRatio(from: Self.queryFrames))
+        guard !confidence.isBelowThreshold else { return TimedTranscript(text: "", confidence: confidence) }
+
+        lock.lock()
+        let trie = hotwords
+        lock.unlock()
+
+        let tokens: [CTCToken]
+        if trie.isEmpty {
+            tokens = CTCBeamDecoder.greedyAlign(logits)
+        } else {
+            logits.applyLogSoftmax()
+            tokens = CTCBeamDecoder().decodeAligned(logits, hotwords: trie)
+        }
+        var transcript = WordTiming.transcript(tokens, tokenizer: tokenizer)
+        transcript.confidence = confidence
+        transcript.language = logits.detectedLanguage()
+        return transcript
+    }
+
+    /// Raw CTC logits for LFR features, query frames first (nil if the model failed)
+    func logits(features: [KotlinFloatArray]) -> CTCLogits? {
+        guard !features.isEmpty else { return nil }
+        let session = checkOut()
+        defer { checkIn(session) }
+
+        return Trace.span(.inference) {
+            guard let output = session.manager.runASR(melLFR: features) else { return nil }
+            // One row per input frame plus the query frames; the row width comes from the
+            // output itself and must agree with the tokenizer, or every row is misaligned
+            let frameCount = features.count + Self.queryFrames
+            let size = Int(output.size)
+            guard size > 0, size % frameCount == 0 else {
+                print("✗ ONNX: \(size) logits don't split into \(frameCount) frames")
+                return nil
+            }
+            let vocabularySize = size / frameCount
+            guard vocabularySize == tokenizer.vocabularySize else {
+                print("✗ ONNX: model emits \(vocabularySize) scores per frame, BPE model has \(tokenizer.vocabularySize) pieces")
+                return nil
+            }
+
+            // One bridged call copies the output into the session's buffer (per-element `get`
+            // would cross into Kotlin frames × vocabulary times)
+            if session.logits.count < size {
+                session.logits = [Float](repeating: 0, count: size)
+                Trace.allocated(bytes: size * MemoryLayout<Float>.size)
+            }
+            let copied: Bool = session.logits.withUnsafeMutableBufferPointer { buffer in
+                guard let array = try? MLMultiArray(dataPointer: buffer.baseAddress!, shape: [NSNumber(value: size)],
+                                                    dataType: .float32, strides: [1], deallocator: nil) else {
+                    return false
+                }
+                MLArrayUtils.shared.doCopyFloatArray(src: output, dst: array)
+                return true
+            }
+            guard copied else { return nil }
+
+            if precision == .half {
+                return session.logits.withUnsafeBufferPointer { buffer in
+                    CTCLogits(frameCount: frameCount, vocabularySize: vocabularySize, precision: .half) { frame, row in
+                        row.baseAddress!.update(from: buffer.baseAddress! + frame * vocabularySize, count: vocabularySize)
+                    }
+                }
+            }
+            // CTCLogits shares the session's buffer without copying
+            return CTCLogits(values: session.logits, frameCount: frameCount, vocabularySize: vocabularySize)
+        }
+    }
+
+    // MARK: - Sessions
+
+    private func checkOut() -> Session {
+        if Trace.isEnabled {
+            lock.lock()
+            waiting += 1
+            Trace.gauge(.sessionWaiters, waiting)
+            lock.unlock()
+        }
+        free.wait()
+        lock.lock()
+        defer { lock.unlock() }
+        if Trace.isEnabled {
+            waiting = max(waiting - 1, 0)
+            Trace.gauge(.sessionWaiters, waiting)
+        }
+        return idle.removeLast()
+    }
+
+    private func checkIn(_ session: Session) {
+        lock.lock()
+        idle.append(session)
+        lock.unlock()
+        free.signal()
+    }
+}
@@ -0,0 +1,212 @@
+import Foundation
+
+/// Overlapping fixed-length chunks for long audio, and reconciliation of the chunk
+/// transcripts at each seam.
+///
+/// Every seam is heard by both neighbouring chunks. The two transcripts are aligned on the
+/// words in that overlap: the longest run of matching words (whose timestamps also agree,
+/// when the engine provides them) is kept once, with the left chunk contributing what comes
+/// before it and the right chunk what comes after. Words cut by a chunk edge sit at the far
+/// end of the overlap from the match, so they are dropped. Without a match both are cut at
+/// the middle of the overlap.
+///
+/// Text-only transcripts have no times, so each word's position is estimated from its place
+/// in the chunk (an even speaking rate). Only words estimated near the overlap can match, and
+/// at least two in a row must (a lone common word or character is no evidence). The estimate
+/// is coarse, so engines with word timings merge far more reliably.
+struct OverlapChunker {
+    var chunkSeconds: TimeInterval = 30
+    var overlapSeconds: TimeInterval = 2
+
+    /// A chunk's transcript and its place in the recording (word times are absolute)
+    struct Chunk {
+        let start: TimeInterval
+        let end: TimeInterval
+        let transcript: TimedTranscript
+    }
+
+    /// Seconds two words' start times may differ and still count as the same word
+    private static let timeTolerance: TimeInterval = 0.3
+    /// Timestamps may run this far past a chunk's edge
+    private static let edgeSlack: TimeInterval = 0.5
+    /// Estimated positions of text-only words may be off by this much
+    private static let estimateSlack: TimeInterval = 2
+
+    /// Equal-length chunks covering the samples, each overlapping the next by at least
+    /// `overlapSeconds`
+    func ranges(sampleCount: Int, sampleRate: Int) -> [Range<Int>] {
+        let length = Int(chunkSeconds * Double(sampleRate))
+        let overlap = min(Int(overlapSeconds * Double(sampleRate)), length / 2)
+        guard sampleCount > length, length > 0 else { return [0..<sampleCount] }
+
+        // Spread the starts evenly so the last chunk isn't a sliver
+        let count = (sampleCount - overlap + (length - overlap) - 1) / (length - overlap)
+        let stride = Double(sampleCount - length) / Double(count - 1)
+        return (0..<count).map { index in
+            let start = Int((Double(index) * stride).rounded())
+            return start..<min(start + length, sampleCount)
+        }
+    }
+
+    /// Merge chunk transcripts (in order) into one
+    static func merge(_ chunks: [Chunk]) -> TimedTranscript {
+        guard var merged = chunks.first.map(units(of:)) else { return TimedTranscript(text: "") }
+        var leftEnd = chunks[0].end
+
+        for chunk in chunks.dropFirst() {
+            var right = units(of: chunk)
+            let (keepLeft, dropRight) = seam(merged, right, rightStart: chunk.start, leftEnd: leftEnd)
+            merged.removeSubrange(keepLeft...)
+            right.removeSubrange(..<dropRight)
+
+            // The right chunk's first word had no left neighbour inside its own transcript
+            if var first = right.first, let last = merged.last {
+                first.gap = needsSpace(between: last.text, and: first.text) ? " " : ""
+                right[0] = first
+            }
+            merged += right
+            leftEnd = chunk.end
+        }
+
+        let timed = merged.allSatisfy { $0.start != nil }
+        return TimedTranscript(
+            text: merged.enumerated().map { $0.offset == 0 ? $0.element.text : $0.element.gap + $0.element.text }.joined(),
+            words: timed ? merged.map { TimedWord(text: $0.text, start: $0.start ?? 0, end: $0.end ?? 0) } : []
+        )
+    }
+
+    // MARK: - Seams
+
+    /// A word of a transcript, with the separator that preceded it in the text
+    private struct Unit {
+        var gap: String
+        var text: String
+        let key: String
+        let start: TimeInterval?
+        let end: TimeInterval?
+        /// Middle of the word: timed, or estimated from its place in the chunk
+        var position: TimeInterval = 0
+    }
+
+    /// Where to join: keep `left[..<keepLeft]` and `right[dropRight...]`
+    private static func seam(_ left: [Unit], _ right: [Unit], rightStart: TimeInterval,
+                             leftEnd: TimeInterval) -> (keepLeft: Int, dropRight: Int) {
+        let timed = left.last?.start != nil && right.first?.start != nil
+
+        // Words either side could have heard
+        let leftFrom = timed
+            ? left.firstIndex { ($0.end ?? 0) > rightStart - edgeSlack } ?? left.count
+            : left.firstIndex { $0.position > rightStart - estimateSlack } ?? left.count
+        let rightTo = timed
+            ? right.firstIndex { ($0.start ?? 0) >= leftEnd + edgeSlack } ?? right.count
+            : right.firstIndex { $0.position >= leftEnd + estimateSlack } ?? right.count
+
+        // Longest run of matching words (dynamic programming over the two windows)
+        var best = (length: 0, leftEnd: 0, rightEnd: 0)
+        var previous = [Int](repeating: 0, count: rightTo + 1)
+        var current = previous
+        for i in leftFrom..<left.count {
+            for j in 0..<rightTo {
+                let same = !left[i].key.isEmpty && left[i].key == right[j].key
+                    && (!timed || abs((left[i].start ?? 0) - (right[j].start ?? 0)) <= timeTolerance)
+                current[j + 1] = same ? previous[j] + 1 : 0
+                if current[j + 1] > best.length {
+                    best = (current[j + 1], i + 1, j + 1)
+                }
+            }
+            swap(&previous, &current)
+        }
+
+        // One shared word is enough when the times agree too
+        if best.length >= (timed ? 1 : 2) {
+            return (best.leftEnd, best.rightEnd)
+        }
+
+        let middle = (rightStart + leftEnd) / 2
+        let keepLeft = left.firstIndex { $0.position >= middle } ?? left.count
+        let dropRight = right.firstIndex { $0.position >= middle } ?? right.count
+        return (keepLeft, dropRight)
+    }
+
+    // MARK: - Units
+
+    /// Timed words located in the text, or words scanned from the text when there are no
+    /// timings (or they don't line up with the text), spread evenly over the chunk
+    private static func units(of chunk: Chunk) -> [Unit] {
+        let text = chunk.transcript.text
+        var units: [Unit] = []
+        var cursor = text.startIndex
+        for word in chunk.transcript.words {
+            guard let found = text.range(of: word.text, range: cursor..<text.endIndex) else {
+                units = []
+                break
+            }
+            units.append(Unit(gap: String(text[cursor..<found.lowerBound]), text: word.text, key: key(word.text),
+                              start: word.start, end: word.end, position: (word.start + word.end) / 2))
+            cursor = found.upperBound
+        }
+        if !units.isEmpty {
+            units[units.count - 1].text += text[cursor...]
+            return units
+        }
+
+        units = scan(text)
+        let wordSeconds = (chunk.end - chunk.start) / Double(max(units.count, 1))
+        for index in units.indices {
+            units[index].position = chunk.start + (Double(index) + 0.5) * wordSeconds
+        }
+        return units
+    }
+
+    /// Split text into words: whitespace-separated, each CJK character alone, punctuation
+    /// attached to the word before it
+    private static func scan(_ text: String) -> [Unit] {
+        var units: [Unit] = []
+        var gap = ""
+        var word = ""
+        var wordIsCJK = false
+
+        func finishWord() {
+            guard !word.isEmpty else { return }
+            units.append(Unit(gap: gap, text: word, key: key(word), start: nil, end: nil))
+            gap = ""
+            word = ""
+        }
+
+        for character in text {
+            let scalar = character.unicodeScalars.first!
+            if character.isWhitespace {
+                finishWord()
+                gap.append(character)
+            } else if scalar.properties.generalCategory.isPunctuation {
+                if word.isEmpty && gap.isEmpty && !units.isEmpty {
+                    units[units.count - 1].text.append(character)
+                } else {
+                    word.append(character)
+                }
+            } else {
+                let isCJK = WordTiming.isCJK(scalar)
+                if isCJK || wordIsCJK {
+                    finishWord()
+                }
+                word.append(character)
+                wordIsCJK = isCJK
+            }
+        }
+        finishWord()
+        return units
+    }
+
+    /// Comparison form of a word: lowercased, punctuation removed
+    private static func key(_ word: String) -> String {
+        String(word.lowercased().unicodeScalars.filter { !$0.properties.generalCategory.isPunctuation })
+    }
+
+    /// Words are space-separated unless either side is CJK or the right one is punctuation
+    private static func needsSpace(between left: String, and right: String) -> Bool {
+        let lastLetter = left.unicodeScalars.reversed().first { !$0.properties.generalCategory.isPunctuation }
+        guard let last = lastLetter, let first = right.unicodeScalars.first,
+              !first.properties.generalCategory.isPunctuation else { return false }
+        return !WordTiming.isCJK(last) && !WordTiming.isCJK(first)
+    }
+}
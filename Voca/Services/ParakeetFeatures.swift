@@ -0,0 +1,196 @@
+import Foundation
+import Accelerate
+
+/// NeMo's log-mel front-end for Parakeet, computed as the model was trained: pre-emphasis
+/// 0.97, 25 ms symmetric Hann windows every 10 ms (centered, zero-padded) in a 512-point
+/// FFT, power spectrum, 128 Slaney-normalized mel bands up to 8 kHz, log with a 2⁻²⁴ guard,
+/// then every band normalized to zero mean and unit variance over the utterance.
+///
+/// Takes the place of the bundle's Preprocessor model, so features come out at the audio's
+/// own length instead of the encoder's fixed window. Buffers are reused between calls, so
+/// one instance serves one thread at a time.
+final class ParakeetFeatures {
+    static let melBands = 128
+    static let hopSize = 160
+    static let windowSize = 400
+    static let fftSize = 512
+
+    private static let log2n = vDSP_Length(9)
+    private static let bins = fftSize / 2 + 1
+    private static let preemphasis: Float = 0.97
+    /// Added before the log (NeMo's `log_zero_guard_value`)
+    private static let logGuard: Float = 1.0 / Float(1 << 24)
+    /// Added to each band's standard deviation before dividing
+    private static let normalizationGuard: Float = 1e-5
+
+    private let fft: FFTSetup
+    /// The Hann window centered in an FFT-sized frame
+    private let window: [Float]
+    /// Mel weights, `melBands` rows of `bins`
+    private let filterbank: [Float]
+    private var frame: [Float]
+    private var real: [Float]
+    private var imag: [Float]
+
+    init(sampleRate: Int = 16000) {
+        fft = vDSP_create_fftsetup(Self.log2n, FFTRadix(kFFTRadix2))!
+        let offset = (Self.fftSize - Self.windowSize) / 2
+        var window = [Float](repeating: 0, count: Self.fftSize)
+        for i in 0..<Self.windowSize {
+            window[offset + i] = Float(0.5 - 0.5 * cos(2 * Double.pi * Double(i) / Double(Self.windowSize - 1)))
+        }
+        self.window = window
+        filterbank = Self.melFilterbank(sampleRate: sampleRate)
+        frame = [Float](repeating: 0, count: Self.fftSize)
+        real = [Float](repeating: 0, count: Self.fftSize / 2)
+        imag = [Float](repeating: 0, count: Self.fftSize / 2)
+    }
+
+    deinit {
+        vDSP_destroy_fftsetup(fft)
+    }
+
+    /// Feature frames for `sampleCount` samples: one per hop, plus one
+    static func frameCount(sampleCount: Int) -> Int {
+        sampleCount / hopSize + 1
+    }
+
+    /// Features for 16kHz samples, band-major (`values[band * frames + frame]`) as the
+    /// encoder takes them
+    func compute(_ samples: [Float]) -> (values: [Float], frames: Int) {
+        let frames = Self.frameCount(sampleCount: samples.count)
+        let bins = Self.bins
+        let half = Self.fftSize / 2
+        let emphasized = Self.emphasize(samples)
+
+        // Power spectra, bin-major so the mel projection is a single matrix product
+        var spectra = [Float](repeating: 0, count: bins * frames)
+        Trace.allocated(bytes: (spectra.count + emphasized.count) * MemoryLayout<Float>.size)
+        spectra.withUnsafeMutableBufferPointer { spectra in
+            for index in 0..<frames {
+                fillFrame(emphasized, center: index * Self.hopSize)
+                forwardFFT()
+                // vDSP's real FFT is scaled by 2; packed layout has DC in real[0], Nyquist in imag[0]
+                spectra[index] = real[0] * real[0] / 4
+                spectra[half * frames + index] = imag[0] * imag[0] / 4
+                for k in 1..<half {
+                    spectra[k * frames + index] = (real[k] * real[k] + imag[k] * imag[k]) / 4
+                }
+            }
+        }
+
+        var values = [Float](repeating: 0, count: Self.melBands * frames)
+        Trace.allocated(bytes: values.count * MemoryLayout<Float>.size)
+        vDSP_mmul(filterbank, 1, spectra, 1, &values, 1,
+                  vDSP_Length(Self.melBands), vDSP_Length(frames), vDSP_Length(bins))
+
+        var guardValue = Self.logGuard
+        var count = Int32(values.count)
+        values.withUnsafeMutableBufferPointer { buffer in
+            vDSP_vsadd(buffer.baseAddress!, 1, &guardValue, buffer.baseAddress!, 1, vDSP_Length(buffer.count))
+            vvlogf(buffer.baseAddress!, buffer.baseAddress!, &count)
+            for band in 0..<Self.melBands {
+                Self.normalize(buffer.baseAddress! + band * frames, count: frames)
+            }
+        }
+        return (values, frames)
+    }
+
+    // MARK: - Frames
+
+    /// x[n] − 0.97·x[n−1]
+    private static func emphasize(_ samples: [Float]) -> [Float] {
+        guard samples.count > 1 else { return samples }
+        var output = samples
+        var coefficient = -preemphasis
+        samples.withUnsafeBufferPointer { input in
+            output.withUnsafeMutableBufferPointer { output in
+                vDSP_vsma(input.baseAddress!, 1, &coefficient, input.baseAddress! + 1, 1,
+                          output.baseAddress! + 1, 1, vDSP_Length(samples.count - 1))
+            }
+        }
+        return output
+    }
+
+    /// Window the FFT-sized frame centered on sample `center`; zeros outside the audio
+    private func fillFrame(_ samples: [Float], center: Int) {
+        let start = center - Self.fftSize / 2
+        let lower = max(0, -start)
+        let upper = min(Self.fftSize, samples.count - start)
+        frame.withUnsafeMutableBufferPointer { frame in
+            frame.update(repeating: 0)
+            guard upper > lower else { return }
+            samples.withUnsafeBufferPointer { samples in
+                window.withUnsafeBufferPointer { window in
+                    vDSP_vmul(samples.baseAddress! + start + lower, 1, window.baseAddress! + lower, 1,
+                              frame.baseAddress! + lower, 1, vDSP_Length(upper - lower))
+                }
+            }
+        }
+    }
+
+    private func forwardFFT() {
+        real.withUnsafeMutableBufferPointer { realBuffer in
+            imag.withUnsafeMutableBufferPointer { imagBuffer in
+                var split = DSPSplitComplex(realp: realBuffer.baseAddress!, imagp: imagBuffer.baseAddress!)
+                frame.withUnsafeBufferPointer { frameBuffer in
+                    frameBuffer.baseAddress!.withMemoryRebound(to: DSPComplex.self, capacity: Self.fftSize / 2) {
+                        vDSP_ctoz($0, 2, &split, 1, vDSP_Length(Self.fftSize / 2))
+                    }
+                }
+                vDSP_fft_zrip(fft, &split, 1, Self.log2n, FFTDirection(FFT_FORWARD))
+            }
+        }
+    }
+
+    /// Zero mean, unit (sample) standard deviation
+    private static func normalize(_ band: UnsafeMutablePointer<Float>, count: Int) {
+        let length = vDSP_Length(count)
+        var mean: Float = 0
+        vDSP_meanv(band, 1, &mean, length)
+        var shift = -mean
+        vDSP_vsadd(band, 1, &shift, band, 1, length)
+
+        var sumOfSquares: Float = 0
+        vDSP_svesq(band, 1, &sumOfSquares, length)
+        let deviation = (sumOfSquares / Float(max(count - 1, 1))).squareRoot()
+        var scale = 1 / (deviation + normalizationGuard)
+        vDSP_vsmul(band, 1, &scale, band, 1, length)
+    }
+
+    // MARK: - Mel Filterbank
+
+    /// Triangular filters evenly spaced on the Slaney mel scale from 0 Hz to Nyquist, each
+    /// scaled to unit area (librosa's `mel(norm="slaney", htk=False)`)
+    private static func melFilterbank(sampleRate: Int) -> [Float] {
+        let nyquist = Double(sampleRate) / 2
+        let maxMel = mel(nyquist)
+        let edges = (0..<(melBands + 2)).map { hertz(maxMel * Double($0) / Double(melBands + 1)) }
+        let frequencies = (0..<bins).map { nyquist * Double($0) / Double(bins - 1) }
+
+        var weights = [Float](repeating: 0, count: melBands * bins)
+        for band in 0..<melBands {
+            let lower = edges[band], center = edges[band + 1], upper = edges[band + 2]
+            let area = 2 / (upper - lower)
+            for (bin, frequency) in frequencies.enumerated() {
+                let rising = (frequency - lower) / (center - lower)
+                let falling = (upper - frequency) / (upper - center)
+                weights[band * bins + bin] = Float(max(0, min(rising, falling)) * area)
+            }
+        }
+        return weights
+    }
+
+    /// Slaney mel scale: linear below 1 kHz, logarithmic above
+    private static let linearStep = 200.0 / 3
+    private static let logStep = log(6.4) / 27
+
+    private static func mel(_ hertz: Double) -> Double {
+        hertz < 1000 ? hertz / linearStep : 1000 / linearStep + log(hertz / 1000) / logStep
+    }
+
+    private static func hertz(_ mel: Double) -> Double {
+        let breakpoint = 1000 / linearStep
+        return mel < breakpoint ? mel * linearStep : 1000 * exp(logStep * (mel - breakpoint))
+    }
+}
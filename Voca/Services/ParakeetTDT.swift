@@ -0,0 +1,331 @@
+import Foundation
+import Accelerate
+import CoreML
+import VoicePipeline
+
+/// Parakeet TDT (token-and-duration transducer) on CoreML, from the FluidAudio bundle in
+/// `parakeet-v2/`: FastConformer encoder, LSTM prediction network and joint network.
+///
+/// Features come from `ParakeetFeatures`. Decoding is greedy TDT: at each encoder frame the
+/// joint scores every token plus blank, and separately how many frames the emission covers;
+/// the decoder then jumps ahead by that duration instead of visiting every frame, and the
+/// prediction network only runs after a non-blank token. Both argmaxes are single vDSP
+/// passes over the joint output. A joint with no duration outputs decodes as plain RNN-T.
+///
+/// The encoder has a fixed input window (15 s in the bundle); longer audio is split with
+/// `OverlapChunker` and the windows merged at their seams.
+final class ParakeetTDT: SpeechRecognizer {
+    static let folderName = "parakeet-v2"
+
+    /// Model files and tensor names of the bundle
+    private enum Layout {
+        static let encoder = "Encoder.mlmodelc"
+        static let decoder = "Decoder.mlmodelc"
+        static let joint = "JointDecision.mlmodelc"
+        static let vocabulary = "parakeet_vocab.json"
+
+        static let features = "audio_signal"
+        static let featureLength = "length"
+        static let encoded = "encoder"
+        static let encodedLength = "encoder_length"
+        static let targets = "targets"
+        static let targetLength = "target_length"
+        static let hiddenIn = "h_in"
+        static let cellIn = "c_in"
+        static let decoded = "decoder"
+        static let hiddenOut = "h_out"
+        static let cellOut = "c_out"
+        static let encoderStep = "encoder_step"
+        static let decoderStep = "decoder_step"
+        static let logits = "logits"
+    }
+
+    /// Encoder frames are 8 feature hops (80 ms)
+    static let frameShift = 0.08
+    /// Frames the joint's duration outputs stand for
+    static let durations = [0, 1, 2, 3, 4]
+    /// Tokens emitted at one frame before the decoder is forced on
+    static let maxSymbolsPerFrame = 10
+
+    /// Frame and network-call counts of everything decoded so far, to show how much work the
+    /// duration skips save
+    struct DecodeStats {
+        var encoderFrames = 0
+        var jointCalls = 0
+        var decoderCalls = 0
+    }
+
+    private let encoder: CoreMLModel
+    private let decoder: CoreMLModel
+    private let joint: CoreMLModel
+    /// Pieces by token id; blank is the id after the last piece
+    private let pieces: [String]
+    private let featureWindow: Int
+    private let stateShape: [NSNumber]
+    private let frontEnd = ParakeetFeatures()
+    private let lock = NSLock()
+    private var totals = DecodeStats()
+
+    private init(encoder: CoreMLModel, decoder: CoreMLModel, joint: CoreMLModel, pieces: [String],
+                 featureWindow: Int, stateShape: [NSNumber]) {
+        self.encoder = encoder
+        self.decoder = decoder
+        self.joint = joint
+        self.pieces = pieces
+        self.featureWindow = featureWindow
+        self.stateShape = stateShape
+    }
+
+    /// nil if the bundle is missing a model or its tensors are not the ones expected
+    static func load(modelDir: String) -> ParakeetTDT? {
+        func model(_ name: String, inputs: [String], outputs: [String]) -> CoreMLModel? {
+            guard let model = CoreMLModel.companion.load(path: "\(modelDir)/\(name)") else {
+                print("⚠️ Parakeet: failed to load \(name)")
+                return nil
+            }
+            let description = model.internalModel.modelDescription
+            let missing = inputs.filter { description.inputDescriptionsByName[$0] == nil }
+                + outputs.filter { description.outputDescriptionsByName[$0] == nil }
+            guard missing.isEmpty else {
+                print("⚠️ Parakeet: \(name) has no tensor \(missing.joined(separator: ", "))")
+                return nil
+            }
+            return model
+        }
+
+        guard let encoder = model(Layout.encoder, inputs: [Layout.features, Layout.featureLength],
+                                  outputs: [Layout.encoded, Layout.encodedLength]),
+              let decoder = model(Layout.decoder, inputs: [Layout.targets, Layout.targetLength, Layout.hiddenIn, Layout.cellIn],
+                                  outputs: [Layout.decoded, Layout.hiddenOut, Layout.cellOut]),
+              let joint = model(Layout.joint, inputs: [Layout.encoderStep, Layout.decoderStep], outputs: [Layout.logits]) else {
+            return nil
+        }
+        guard let data = FileManager.default.contents(atPath: "\(modelDir)/\(Layout.vocabulary)"),
+              let entries = try? JSONDecoder().decode([String: String].self, from: data) else {
+            print("⚠️ Parakeet: failed to load \(Layout.vocabulary)")
+            return nil
+        }
+        var pieces = [String](repeating: "", count: entries.count)
+        for (key, piece) in entries {
+            guard let id = Int(key), pieces.indices.contains(id) else { continue }
+            pieces[id] = piece
+        }
+
+        let inputs = encoder.internalModel.modelDescription.inputDescriptionsByName
+        let states = decoder.internalModel.modelDescription.inputDescriptionsByName
+        guard let featureWindow = inputs[Layout.features]?.multiArrayConstraint?.shape.last?.intValue, featureWindow > 0,
+              let stateShape = states[Layout.hiddenIn]?.multiArrayConstraint?.shape, !stateShape.isEmpty else {
+            print("⚠️ Parakeet: encoder window or decoder state shape not declared")
+            return nil
+        }
+        print("✓ Parakeet loaded (\(pieces.count) tokens, \(Double((featureWindow - 1) * ParakeetFeatures.hopSize) / 16000)s window)")
+        return ParakeetTDT(encoder: encoder, decoder: decoder, joint: joint, pieces: pieces,
+                           featureWindow: featureWindow, stateShape: stateShape)
+    }
+
+    var stats: DecodeStats {
+        lock.lock()
+        defer { lock.unlock() }
+        return totals
+    }
+
+    var hasWordTimings: Bool { true }
+
+    func transcribe(audio: KotlinFloatArray) -> String? {
+        transcribeTimed(audio: audio)?.text
+    }
+
+    func transcribeTimed(audio: KotlinFloatArray) -> TimedTranscript? {
+        let samples = (0..<Int(audio.size)).map { audio.get(index: Int32($0)) }
+        return transcribe(samples)
+    }
+
+    /// Transcribe 16kHz mono samples; nil if a model failed
+    func transcribe(_ samples: [Float]) -> TimedTranscript? {
+        lock.lock()
+        defer { lock.unlock() }
+
+        let windowSamples = (featureWindow - 1) * ParakeetFeatures.hopSize
+        let chunker = OverlapChunker(chunkSeconds: Double(windowSamples) / 16000, overlapSeconds: 2)
+        let ranges = chunker.ranges(sampleCount: samples.count, sampleRate: 16000)
+        var chunks: [OverlapChunker.Chunk] = []
+        for range in ranges {
+            guard let transcript = transcribeWindow(Array(samples[range])) else { return nil }
+            let start = Double(range.lowerBound) / 16000
+            chunks.append(OverlapChunker.Chunk(
+                start: start, end: Double(range.upperBound) / 16000,
+                transcript: TimedTranscript(text: transcript.text, words: WordTiming.shift(transcript.words, by: start))
+            ))
+        }
+        return ranges.count == 1 ? chunks[0].transcript : OverlapChunker.merge(chunks)
+    }
+
+    // MARK: - Encoder
+
+    /// One encoder window: features, encoder, TDT decode
+    private func transcribeWindow(_ samples: [Float]) -> TimedTranscript? {
+        let (features, frames) = Trace.span(.mel) { frontEnd.compute(samples) }
+        let used = min(frames, featureWindow)
+
+        let inference = Trace.begin(.inference)
+        guard let input = try? MLMultiArray(shape: [1, NSNumber(value: ParakeetFeatures.melBands), NSNumber(value: featureWindow)],
+                                            dataType: .float32),
+              let length = try? MLMultiArray(shape: [1], dataType: .int32) else {
+            Trace.end(inference)
+            return nil
+        }
+        // Zero-pad each band to the window (padding is zero after normalization, as in NeMo)
+        let rows = input.dataPointer.assumingMemoryBound(to: Float.self)
+        let rowStride = input.strides[1].intValue
+        rows.update(repeating: 0, count: input.count)
+        features.withUnsafeBufferPointer { features in
+            for band in 0..<ParakeetFeatures.melBands {
+                (rows + band * rowStride).update(from: features.baseAddress! + band * frames, count: used)
+            }
+        }
+        length[0] = NSNumber(value: used)
+
+        let output = encoder.predict(inputs: [Layout.features: input, Layout.featureLength: length])
+        Trace.end(inference)
+        guard let encoded = output?[Layout.encoded], let encodedLength = output?[Layout.encodedLength],
+              encoded.dataType == .float32, encoded.shape.count == 3 else {
+            print("⚠️ Parakeet: encoder failed")
+            return nil
+        }
+        let tokens = Trace.span(.decode) {
+            decode(encoded, frames: min(encodedLength[0].intValue, encoded.shape[2].intValue))
+        }
+        return tokens.map(transcript)
+    }
+
+    // MARK: - TDT Decoding
+
+    private struct Emission {
+        let id: Int
+        let startFrame: Int
+        let endFrame: Int
+    }
+
+    /// Greedy TDT over the valid encoder frames; nil if the decoder or joint failed
+    private func decode(_ encoded: MLMultiArray, frames: Int) -> [Emission]? {
+        let hidden = encoded.shape[1].intValue
+        let source = encoded.dataPointer.assumingMemoryBound(to: Float.self)
+        let channelStride = encoded.strides[1].intValue
+        let frameStride = encoded.strides[2].intValue
+        let blank = pieces.count
+
+        guard let step = try? MLMultiArray(shape: [1, NSNumber(value: hidden), 1], dataType: .float32),
+              let target = try? MLMultiArray(shape: [1, 1], dataType: .int32),
+              let targetLength = try? MLMultiArray(shape: [1], dataType: .int32),
+              var hiddenState = try? MLMultiArray(shape: stateShape, dataType: .float32),
+              var cellState = try? MLMultiArray(shape: stateShape, dataType: .float32) else {
+            return nil
+        }
+        hiddenState.dataPointer.assumingMemoryBound(to: Float.self).update(repeating: 0, count: hiddenState.count)
+        cellState.dataPointer.assumingMemoryBound(to: Float.self).update(repeating: 0, count: cellState.count)
+        targetLength[0] = 1
+        let stepValues = step.dataPointer.assumingMemoryBound(to: Float.self)
+        let stepStride = step.strides[1].intValue
+
+        /// Advance the prediction network by one token (blank starts the sequence)
+        func predict(_ token: Int) -> MLMultiArray? {
+            target[0] = NSNumber(value: token)
+            guard let output = decoder.predict(inputs: [Layout.targets: target, Layout.targetLength: targetLength,
+                                                        Layout.hiddenIn: hiddenState, Layout.cellIn: cellState]),
+                  let decoded = output[Layout.decoded], let h = output[Layout.hiddenOut], let c = output[Layout.cellOut] else {
+                return nil
+            }
+            hiddenState = h
+            cellState = c
+            return decoded
+        }
+
+        var stats = DecodeStats(encoderFrames: frames)
+        var emissions: [Emission] = []
+        guard var prediction = predict(blank) else { return nil }
+        stats.decoderCalls += 1
+
+        var frame = 0
+        var symbols = 0
+        while frame < frames {
+            vDSP_mmov(source + frame * frameStride, stepValues, 1, vDSP_Length(hidden),
+                      vDSP_Length(channelStride), vDSP_Length(stepStride))
+            guard let output = joint.predict(inputs: [Layout.encoderStep: step, Layout.decoderStep: prediction]),
+                  let logits = output[Layout.logits], logits.dataType == .float32 else {
+                return nil
+            }
+            stats.jointCalls += 1
+
+            // Token scores (pieces + blank) then duration scores, contiguous in the last axis
+            let values = logits.dataPointer.assumingMemoryBound(to: Float.self)
+            var best: Float = 0
+            var index: vDSP_Length = 0
+            vDSP_maxvi(values, 1, &best, &index, vDSP_Length(blank + 1))
+            let token = Int(index)
+            var skip = 1
+            let durationCount = logits.count - (blank + 1)
+            if durationCount > 0 {
+                vDSP_maxvi(values + blank + 1, 1, &best, &index, vDSP_Length(min(durationCount, Self.durations.count)))
+                skip = Self.durations[Int(index)]
+            }
+
+            if token != blank {
+                emissions.append(Emission(id: token, startFrame: frame, endFrame: frame + max(skip, 1)))
+                guard let next = predict(token) else { return nil }
+                prediction = next
+                stats.decoderCalls += 1
+                symbols += 1
+            }
+            // A blank always moves on, and so does a frame that has emitted too many tokens
+            if skip == 0 && (token == blank || symbols >= Self.maxSymbolsPerFrame) {
+                skip = 1
+            }
+            if skip > 0 {
+                frame += skip
+                symbols = 0
+            }
+        }
+
+        totals.encoderFrames += stats.encoderFrames
+        totals.jointCalls += stats.jointCalls
+        totals.decoderCalls += stats.decoderCalls
+        return emissions
+    }
+
+    // MARK: - Text
+
+    /// Join the pieces: "▁" starts a word, punctuation stays with the word before it
+    private func transcript(_ emissions: [Emission]) -> TimedTranscript {
+        var words: [TimedWord] = []
+        var text = ""
+        var current = ""
+        var start = 0
+        var end = 0
+
+        func finishWord() {
+            guard !current.isEmpty else { return }
+            words.append(TimedWord(text: current, start: Double(start) * Self.frameShift, end: Double(end) * Self.frameShift))
+            text += (text.isEmpty ? "" : " ") + current
+            current = ""
+        }
+
+        for emission in emissions {
+            let piece = pieces[emission.id]
+            if piece.hasPrefix("<") && piece.hasSuffix(">") {
+                continue
+            }
+            let body = piece.replacingOccurrences(of: "\u{2581}", with: "")
+            let isPunctuation = !body.isEmpty && body.unicodeScalars.allSatisfy { $0.properties.generalCategory.isPunctuation }
+            if piece.hasPrefix("\u{2581}") && !isPunctuation {
+                finishWord()
+            }
+            if current.isEmpty {
+                start = emission.startFrame
+            }
+            current += body
+            end = emission.endFrame
+        }
+        finishWord()
+        return TimedTranscript(text: text, words: words)
+    }
+}
@@ -0,0 +1,239 @@
+import Foundation
+
+/// Streaming polyphase FIR sample-rate converter (any integer rates, e.g. 48k/44.1k → 16k).
+///
+/// The prototype low-pass is a Kaiser-windowed sinc designed at the upsampled rate L·fs_in
+/// and split into L phases of `tapsPerPhase` coefficients, each stored reversed so an output
+/// sample is one contiguous dot product (SIMD8) over the input history. Tables are built
+/// once per ratio and shared. State carries across `process` calls, so blocks of any size
+/// give the same output as one call; `flush` drains the filter delay at end of stream.
+///
+/// Needs nothing beyond Foundation, so it also builds and can be checked on Linux.
+final class Resampler {
+    /// Passband edge as a fraction of the lower Nyquist rate
+    static let passband = 0.9
+    /// Stopband attenuation the filter length is designed for
+    static let attenuationDB = 80.0
+
+    /// Input rates whose tables `precomputeCommonTables` builds for 16 kHz output
+    static let commonInputRates = [48000, 44100, 32000, 22050]
+
+    let inputRate: Int
+    let outputRate: Int
+
+    private let table: FilterTable
+    private var pending: [Float]
+    /// Logical input index of `pending[0]` (negative while the zero history is in use)
+    private var pendingStart: Int
+    /// Position of the next output sample on the upsampled time grid
+    private var nextTime: Int
+    private var inputCount = 0
+    private var outputCount = 0
+
+    init(inputRate: Int, outputRate: Int = 16000) {
+        precondition(inputRate > 0 && outputRate > 0, "Resampler needs positive rates (\(inputRate) → \(outputRate))")
+        self.inputRate = inputRate
+        self.outputRate = outputRate
+        table = FilterTable.shared(inputRate: inputRate, outputRate: outputRate)
+
+        // Zero history before the first sample, and start one filter delay in so output
+        // sample n lines up with input time n·M/L
+        pending = [Float](repeating: 0, count: table.tapsPerPhase)
+        pendingStart = -table.tapsPerPhase
+        nextTime = table.delay
+    }
+
+    /// Build the filter tables for the usual capture and file rates ahead of first use
+    static func precomputeCommonTables(outputRate: Int = 16000) {
+        for rate in commonInputRates {
+            _ = FilterTable.shared(inputRate: rate, outputRate: outputRate)
+        }
+    }
+
+    /// One-shot conversion of a whole signal
+    static func resample(_ samples: [Float], from inputRate: Int, to outputRate: Int = 16000) -> [Float] {
+        guard inputRate != outputRate else { return samples }
+        let resampler = Resampler(inputRate: inputRate, outputRate: outputRate)
+        var output: [Float] = []
+        output.reserveCapacity(samples.count * outputRate / inputRate + 1)
+        samples.withUnsafeBufferPointer { resampler.process($0, into: &output) }
+        resampler.flush(into: &output)
+        return output
+    }
+
+    /// Resample a block, appending every output sample it completes to `output`
+    func process(_ input: UnsafeBufferPointer<Float>, into output: inout [Float]) {
+        guard table.up != table.down else {
+            output.append(contentsOf: input)
+            return
+        }
+        pending.append(contentsOf: input)
+        inputCount += input.count
+        run(limit: Int.max, into: &output)
+    }
+
+    func process(_ input: [Float], into output: inout [Float]) {
+        input.withUnsafeBufferPointer { process($0, into: &output) }
+    }
+
+    /// Emit the samples still inside the filter delay; the resampler is spent afterwards
+    func flush(into output: inout [Float]) {
+        guard table.up != table.down else { return }
+        let total = (inputCount * table.up + table.down - 1) / table.down
+        pending.append(contentsOf: [Float](repeating: 0, count: table.tapsPerPhase))
+        run(limit: total, into: &output)
+    }
+
+    private func run(limit: Int, into output: inout [Float]) {
+        let up = table.up
+        let down = table.down
+        let taps = table.tapsPerPhase
+        let available = pendingStart + pending.count
+
+        pending.withUnsafeBufferPointer { history in
+            table.coefficients.withUnsafeBufferPointer { coefficients in
+                while outputCount < limit {
+                    let base = nextTime / up
+                    guard base < available else { break }
+                    let phase = nextTime - base * up
+                    let window = history.baseAddress! + (base - taps + 1 - pendingStart)
+                    output.append(Self.dot(coefficients.baseAddress! + phase * taps, window, taps))
+                    nextTime += down
+                    outputCount += 1
+                }
+            }
+        }
+
+        // Keep only the history the next output needs
+        let keepFrom = nextTime / up - taps + 1 - pendingStart
+        if keepFrom > 0 {
+            pending.removeFirst(min(keepFrom, pending.count))
+            pendingStart += keepFrom
+        }
+    }
+
+    @inline(__always)
+    private static func dot(_ a: UnsafePointer<Float>, _ b: UnsafePointer<Float>, _ count: Int) -> Float {
+        let ra = UnsafeRawPointer(a)
+        let rb = UnsafeRawPointer(b)
+        var acc0 = SIMD8<Float>()
+        var acc1 = SIMD8<Float>()
+        var i = 0
+        while i + 16 <= count {
+            acc0 += ra.loadUnaligned(fromByteOffset: i * 4, as: SIMD8<Float>.self)
+                * rb.loadUnaligned(fromByteOffset: i * 4, as: SIMD8<Float>.self)
+            acc1 += ra.loadUnaligned(fromByteOffset: (i + 8) * 4, as: SIMD8<Float>.self)
+                * rb.loadUnaligned(fromByteOffset: (i + 8) * 4, as: SIMD8<Float>.self)
+            i += 16
+        }
+        if i + 8 <= count {
+            acc0 += ra.loadUnaligned(fromByteOffset: i * 4, as: SIMD8<Float>.self)
+                * rb.loadUnaligned(fromByteOffset: i * 4, as: SIMD8<Float>.self)
+            i += 8
+        }
+        var sum = (acc0 + acc1).sum()
+        while i < count {
+            sum += a[i] * b[i]
+            i += 1
+        }
+        return sum
+    }
+}
+
+// MARK: - Filter Design
+
+/// Polyphase coefficients for one L/M ratio
+private final class FilterTable {
+    let up: Int
+    let down: Int
+    let tapsPerPhase: Int
+    /// Upsampled-grid offset that centres the filter on the output instant
+    let delay: Int
+    /// `up` phases of `tapsPerPhase` reversed coefficients
+    let coefficients: [Float]
+
+    private static var cache: [Int: FilterTable] = [:]
+    private static let cacheLock = NSLock()
+
+    static func shared(inputRate: Int, outputRate: Int) -> FilterTable {
+        precondition(inputRate > 0 && outputRate > 0, "Filter table needs positive rates (\(inputRate) → \(outputRate))")
+        let divisor = gcd(inputRate, outputRate)
+        let up = outputRate / divisor
+        let down = inputRate / divisor
+        let key = up << 32 | down
+
+        cacheLock.lock()
+        defer { cacheLock.unlock() }
+        if let table = cache[key] {
+            return table
+        }
+        let table = FilterTable(up: up, down: down, inputRate: inputRate, outputRate: outputRate)
+        cache[key] = table
+        return table
+    }
+
+    private init(up: Int, down: Int, inputRate: Int, outputRate: Int) {
+        self.up = up
+        self.down = down
+        guard up != down else {
+            tapsPerPhase = 0
+            delay = 0
+            coefficients = []
+            return
+        }
+
+        // Transition band from the passband edge to the lower Nyquist rate; the Kaiser
+        // estimate gives the length at the input rate, i.e. taps per phase
+        let nyquist = Double(min(inputRate, outputRate)) / 2
+        let transition = nyquist * (1 - Resampler.passband) / Double(inputRate)
+        let attenuation = Resampler.attenuationDB
+        let estimate = (attenuation - 8) / (2.285 * 2 * Double.pi * transition)
+        tapsPerPhase = (Int(estimate.rounded(.up)) + 7) / 8 * 8
+
+        let length = up * tapsPerPhase
+        let center = length / 2
+        delay = center
+        let cutoff = nyquist * (1 + Resampler.passband) / 2 / Double(inputRate * up)
+        let beta = 0.1102 * (attenuation - 8.7)
+        let norm = Self.besselI0(beta)
+
+        var prototype = [Double](repeating: 0, count: length)
+        var sum = 0.0
+        for j in 0..<length {
+            let x = Double(j - center)
+            let sinc = x == 0 ? 2 * cutoff : sin(2 * Double.pi * cutoff * x) / (Double.pi * x)
+            let r = x / Double(center)
+            let window = abs(r) < 1 ? Self.besselI0(beta * (1 - r * r).squareRoot()) / norm : 0
+            prototype[j] = sinc * window
+            sum += prototype[j]
+        }
+
+        // Unity DC gain per output sample (interpolation by L needs a gain of L)
+        let gain = Double(up) / sum
+        var table = [Float](repeating: 0, count: length)
+        for phase in 0..<up {
+            for k in 0..<tapsPerPhase {
+                table[phase * tapsPerPhase + (tapsPerPhase - 1 - k)] = Float(prototype[phase + k * up] * gain)
+            }
+        }
+        coefficients = table
+    }
+
+    private static func gcd(_ a: Int, _ b: Int) -> Int {
+        b == 0 ? a : gcd(b, a % b)
+    }
+
+    /// Zeroth-order modified Bessel function of the first kind (power series)
+    private static func besselI0(_ x: Double) -> Double {
+        var sum = 1.0
+        var term = 1.0
+        var k = 1.0
+        while term > sum * 1e-12 {
+            let half = x / (2 * k)
+            term *= half * half
+            sum += term
+            k += 1
+        }
+        return sum
+    }
+}
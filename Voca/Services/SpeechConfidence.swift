@@ -0,0 +1,117 @@
+import Foundation
+import Accelerate
+import VoicePipeline
+
+/// How likely a segment holds speech, from two cheap signals: the VAD's speech probability
+/// (before the encoder runs) and the share of encoder frames whose best CTC label is not
+/// blank (after it, before any decoding).
+///
+/// Segments scoring below `threshold` are not decoded: a low VAD score skips the model call,
+/// a dominant blank skips CTC decoding, detokenization and post-processing.
+struct SpeechConfidence {
+    /// Peak speech probability over ~100 ms windows (nil when no VAD model is installed)
+    var vadProbability: Float?
+    /// Share of audio frames whose best CTC label is not blank (nil before the encoder ran)
+    var nonBlankRatio: Float?
+
+    /// Non-blank share counted as fully confident; speech runs at roughly 0.15–0.3
+    static let fullNonBlankRatio: Float = 0.1
+
+    /// Scores below this are skipped (0 disables)
+    static var threshold: Float {
+        AppSettings.shared.minSpeechConfidence
+    }
+
+    /// 0...1: the weakest of the measured signals (1 when nothing was measured)
+    var score: Float {
+        min(vadProbability ?? 1, nonBlankRatio.map { min($0 / Self.fullNonBlankRatio, 1) } ?? 1)
+    }
+
+    var isBelowThreshold: Bool {
+        score < Self.threshold
+    }
+}
+
+extension CTCLogits {
+    /// Share of frames from `firstFrame` on whose best label is not blank (raw logits or
+    /// log-probabilities alike)
+    func nonBlankRatio(from firstFrame: Int = 0, blankId: Int = 0) -> Float {
+        guard frameCount > firstFrame else { return 0 }
+        var nonBlank = 0
+        forEachFrame(firstFrame..<frameCount) { _, row in
+            var maxValue: Float = 0
+            var maxIndex: vDSP_Length = 0
+            vDSP_maxvi(row, 1, &maxValue, &maxIndex, vDSP_Length(vocabularySize))
+            if Int(maxIndex) != blankId {
+                nonBlank += 1
+            }
+        }
+        return Float(nonBlank) / Float(frameCount - firstFrame)
+    }
+}
+
+/// Silero VAD (CoreML) speech probability for whole segments. Optional: the model is used
+/// when it has been placed in the models directory.
+final class SpeechDetector {
+    static let modelName = (ConfigKt.VAD_MODEL_PATH as NSString).lastPathComponent
+
+    private let model: CoreMLModel
+    private let lock = NSLock()
+
+    private init(model: CoreMLModel) {
+        self.model = model
+    }
+
+    /// nil if the VAD model isn't installed
+    static func load(modelDir: String) -> SpeechDetector? {
+        let path = "\(modelDir)/\(modelName)"
+        guard FileManager.default.fileExists(atPath: path),
+              let model = CoreMLModel.companion.load(path: path) else {
+            return nil
+        }
+        print("✓ VAD loaded for segment confidence")
+        return SpeechDetector(model: model)
+    }
+
+    /// Highest speech probability averaged over three consecutive VAD chunks (~100 ms), so
+    /// a single word counts but a click does not; nil if the model failed
+    func peakProbability(_ samples: [Float]) -> Float? {
+        let chunk = Int(ConstantsKt.VAD_CHUNK_SIZE)
+        let context = Int(ConstantsKt.VAD_CONTEXT_SIZE)
+        let stateSize = ConstantsKt.VAD_STATE_SIZE
+        guard chunk > 0, samples.count >= chunk else { return nil }
+
+        lock.lock()
+        defer { lock.unlock() }
+        let span = Trace.begin(.vad)
+        defer { Trace.end(span) }
+
+        let input = KotlinFloatArray(size: Int32(context + chunk))
+        var hidden = KotlinFloatArray(size: stateSize)
+        var cell = KotlinFloatArray(size: stateSize)
+        var window: [Float] = []
+        var peak: Float = 0
+
+        for start in stride(from: 0, through: samples.count - chunk, by: chunk) {
+            // Each chunk is preceded by the tail of the previous one (zeros at the start)
+            for i in 0..<(context + chunk) {
+                let index = start - context + i
+                input.set(index: Int32(i), value: index >= 0 ? samples[index] : 0)
+            }
+            guard let output = model.runVAD(audioInput: input, hiddenState: hidden, cellState: cell) else {
+                return nil
+            }
+            hidden = output.newHiddenState
+            cell = output.newCellState
+
+            window.append(output.probability)
+            if window.count > 3 {
+                window.removeFirst()
+            }
+            if window.count == 3 {
+                peak = max(peak, window.reduce(0, +) / 3)
+            }
+        }
+        return window.count < 3 ? window.reduce(0, +) / Float(window.count) : peak
+    }
+}
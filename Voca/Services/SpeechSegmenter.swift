@@ -0,0 +1,103 @@
+import Foundation
+
+/// Cuts the 16kHz capture stream into speech segments at pauses, for incremental
+/// transcription while recording.
+///
+/// A block is sound when its RMS exceeds `silenceThreshold`. Once sound has been followed by
+/// `silenceDuration` of silence, everything buffered up to the start of that silence is a
+/// segment (if long enough). Until sound is heard only `preRoll` of silence is kept, and a
+/// stream that ends without new sound yields no segment, so silence is not sent to the
+/// model. Time is counted in samples, so the same audio always splits the same way, live or
+/// offline.
+struct SpeechSegmenter {
+    struct Segment {
+        /// Sample offset of the segment in the stream
+        let start: Int
+        let samples: [Float]
+    }
+
+    var silenceThreshold: Float = 0.02  // RMS threshold for silence (above the mic noise floor)
+    var silenceDuration: Double = 1.2   // Seconds of silence to end a segment (long enough not to break natural pauses)
+    var minSpeechDuration: Double = 1.0 // Minimum speech duration to process
+    var preRoll: Double = 0.5           // Seconds of silence kept before speech (soft onsets)
+    let sampleRate: Double = 16000
+
+    private(set) var isSpeaking = false
+    private var buffer: [Float] = []
+    /// Stream offset of `buffer[0]`
+    private var bufferStart = 0
+    private var silenceStart: Int?
+    private var speechStart: Int?
+    /// Sound was heard since the last segment
+    private var heardSound = false
+
+    /// Add a block with its RMS; returns a segment when this block completes one
+    mutating func append(_ samples: [Float], rms: Float) -> Segment? {
+        buffer.append(contentsOf: samples)
+        let now = bufferStart + buffer.count
+
+        guard rms <= silenceThreshold else {
+            silenceStart = nil
+            if !isSpeaking {
+                isSpeaking = true
+                speechStart = now
+                heardSound = true
+            }
+            return nil
+        }
+
+        guard isSpeaking else {
+            // Nothing to keep but the lead-in (short utterances stay until the next segment)
+            let keep = Int(preRoll * sampleRate)
+            if !heardSound && buffer.count > keep {
+                let dropped = buffer.count - keep
+                buffer.removeSubrange(0..<dropped)
+                bufferStart += dropped
+            }
+            return nil
+        }
+        guard let silenceFrom = silenceStart else {
+            silenceStart = now
+            return nil
+        }
+        let silenceSamples = Int(silenceDuration * sampleRate)
+        guard now - silenceFrom >= silenceSamples else { return nil }
+
+        // Silence long enough: the segment is complete
+        var segment: Segment?
+        if let speechFrom = speechStart,
+           now - speechFrom >= Int((minSpeechDuration + silenceDuration) * sampleRate) {
+            // Drop the trailing silence (approximate)
+            let segmentEnd = max(0, buffer.count - silenceSamples)
+            if segmentEnd > Int(sampleRate * minSpeechDuration) {
+                segment = Segment(start: bufferStart, samples: Array(buffer[0..<segmentEnd]))
+                buffer.removeSubrange(0..<segmentEnd)
+                bufferStart += segmentEnd
+                heardSound = false
+            }
+        }
+
+        isSpeaking = false
+        speechStart = nil
+        silenceStart = nil
+        return segment
+    }
+
+    /// Whatever is still buffered at the end of the stream (plus any final `tail`), if long
+    /// enough to process
+    mutating func finish(tail: [Float] = []) -> Segment? {
+        defer { reset() }
+        buffer.append(contentsOf: tail)
+        guard heardSound, buffer.count > Int(sampleRate * minSpeechDuration) else { return nil }
+        return Segment(start: bufferStart, samples: buffer)
+    }
+
+    mutating func reset() {
+        buffer = []
+        bufferStart = 0
+        isSpeaking = false
+        heardSound = false
+        silenceStart = nil
+        speechStart = nil
+    }
+}
@@ -0,0 +1,168 @@
+import Foundation
+import Accelerate
+import VoicePipeline
+
+/// Streaming SenseVoice for live partials: the encoder runs on fixed-size chunks of LFR
+/// frames as audio arrives, and each chunk's CTC output is greedy-decoded onto the running
+/// hypothesis, which is finalized at the endpoint.
+///
+/// The encoder is not causal and keeps no state between calls, so the cache sits at its
+/// input: the LFR features of the last `leftFrames` are kept and encoded again ahead of each
+/// chunk, `rightFrames` of lookahead follow it, and only the chunk's own output frames are
+/// decoded. Every call encodes the same window, so compute per second of audio is constant
+/// however long the utterance runs; features are computed once per frame and the CTC
+/// search only visits new frames. Partials trail the audio by one chunk plus the lookahead.
+///
+/// Needs SenseVoice on ONNX Runtime: the CoreML model takes a fixed 500-frame input, so
+/// every chunk would cost as much as 30 s of audio. Not thread-safe; feed it from one queue.
+final class StreamingRecognizer {
+    struct Configuration {
+        /// LFR frames (60 ms each) per chunk: a partial every 360 ms
+        var chunkFrames = 6
+        /// Cached frames encoded ahead of each chunk (1.8 s)
+        var leftFrames = 30
+        /// Lookahead frames encoded after each chunk (180 ms)
+        var rightFrames = 3
+    }
+
+    let configuration: Configuration
+
+    /// Samples per LFR frame
+    private static let frameSamples = Int(ConstantsKt.LFR_N * ConstantsKt.HOP_LENGTH)
+    /// Frames computed past the end of the audio and dropped, so the stacking of
+    /// neighbouring mel frames never sees the edge
+    private static let guardFrames = 2
+    /// Language/event/emotion/ITN query frames the encoder prepends to its output
+    private static let queryFrames = 4
+
+    private let engine: ONNXSenseVoice
+    /// Audio from `guardFrames` before the next feature frame on; `audioStart` is its offset
+    /// in the stream (a multiple of `frameSamples`)
+    private var audio: [Float] = []
+    private var audioStart = 0
+    /// Features of the left context and of frames not encoded yet, from stream frame `featureStart`
+    private var features: [KotlinFloatArray] = []
+    private var featureStart = 0
+    /// Frames decoded so far
+    private var encoded = 0
+    private var tokens: [CTCToken] = []
+    private var previous: Int32 = -1
+
+    init(engine: ONNXSenseVoice, configuration: Configuration = Configuration()) {
+        self.engine = engine
+        self.configuration = configuration
+    }
+
+    /// The hypothesis so far (word times from the start of the utterance)
+    var hypothesis: TimedTranscript {
+        WordTiming.transcript(tokens, tokenizer: engine.tokenizer)
+    }
+
+    /// Add 16kHz samples; returns the updated hypothesis when a chunk was decoded
+    func append(_ samples: [Float]) -> TimedTranscript? {
+        audio.append(contentsOf: samples)
+
+        // Features for whole chunks at a time, once their audio (and guard) has arrived
+        let computable = (audioStart + audio.count) / Self.frameSamples - Self.guardFrames
+        if computable - (featureStart + features.count) >= configuration.chunkFrames {
+            extractFeatures(upTo: computable)
+        }
+
+        var decoded = false
+        while featureStart + features.count >= encoded + configuration.chunkFrames + configuration.rightFrames {
+            decodeChunk(frames: configuration.chunkFrames)
+            decoded = true
+        }
+        return decoded ? hypothesis : nil
+    }
+
+    /// Endpoint: decode the rest with whatever lookahead there is and return the final
+    /// transcript, then start over for the next utterance
+    func finish() -> TimedTranscript {
+        extractFeatures(upTo: nil)
+        let remaining = featureStart + features.count - encoded
+        if remaining > 0 {
+            decodeChunk(frames: remaining)
+        }
+        let transcript = hypothesis
+        reset()
+        return transcript
+    }
+
+    func reset() {
+        audio = []
+        audioStart = 0
+        features = []
+        featureStart = 0
+        encoded = 0
+        tokens = []
+        previous = -1
+    }
+
+    // MARK: - Chunks
+
+    /// Compute features for buffered audio up to stream frame `end` (nil: all of it, at the
+    /// end of the stream)
+    private func extractFeatures(upTo end: Int?) {
+        guard !audio.isEmpty else { return }
+        let input = KotlinFloatArray(size: Int32(audio.count))
+        for (index, sample) in audio.enumerated() {
+            input.set(index: Int32(index), value: sample)
+        }
+        let mel = Trace.span(.mel) { AudioProcessing.shared.computeMelSpectrogram(audio: input) }
+        let lfr = Trace.span(.lfr) { LFRTransform.shared.apply(mel: mel) }
+
+        // lfr[i] is stream frame audioFrame + i; the frames before the next one are the
+        // leading guard (recomputed so they see real audio on both sides)
+        let audioFrame = audioStart / Self.frameSamples
+        let first = featureStart + features.count - audioFrame
+        let last = min(end.map { $0 - audioFrame } ?? lfr.count, lfr.count)
+        if last > first {
+            features.append(contentsOf: lfr[first..<last])
+        }
+
+        // Keep the audio of the guard ahead of the next frame
+        let keepFrom = max(featureStart + features.count - Self.guardFrames, 0) * Self.frameSamples
+        if keepFrom > audioStart {
+            audio.removeFirst(min(keepFrom - audioStart, audio.count))
+            audioStart = keepFrom
+        }
+    }
+
+    /// Encode the next `frames` frames with their left context and lookahead and extend the
+    /// hypothesis by their greedy CTC path
+    private func decodeChunk(frames: Int) {
+        let windowStart = max(featureStart, encoded - configuration.leftFrames)
+        let windowEnd = min(featureStart + features.count, encoded + frames + configuration.rightFrames)
+        let window = Array(features[(windowStart - featureStart)..<(windowEnd - featureStart)])
+
+        if let logits = engine.logits(features: window) {
+            Trace.span(.decode) {
+                let firstRow = Self.queryFrames + encoded - windowStart
+                let lastRow = min(firstRow + frames, logits.frameCount)
+                logits.forEachFrame(firstRow..<max(lastRow, firstRow)) { row, scores in
+                    var maxValue: Float = 0
+                    var maxIndex: vDSP_Length = 0
+                    vDSP_maxvi(scores, 1, &maxValue, &maxIndex, vDSP_Length(logits.vocabularySize))
+                    // Output frames as WordTiming counts them: query frames first
+                    let frame = Int32(encoded + row - firstRow + Self.queryFrames)
+                    let token = Int32(maxIndex)
+                    if token == previous && token != 0 {
+                        tokens[tokens.count - 1].endFrame = frame + 1
+                    } else if token != 0 {
+                        tokens.append(CTCToken(id: token, startFrame: frame, endFrame: frame + 1))
+                    }
+                    previous = token
+                }
+            }
+        }
+        encoded += frames
+
+        // Only the left context of the next chunk stays cached
+        let drop = min(encoded - configuration.leftFrames - featureStart, features.count)
+        if drop > 0 {
+            features.removeFirst(drop)
+            featureStart += drop
+        }
+    }
+}
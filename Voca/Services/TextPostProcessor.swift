@@ -0,0 +1,448 @@
+import Foundation
+
+/// Incremental post-processor for dictated text: filler removal and punctuation cleanup.
+///
+/// Segments stream through two stages in a single pass:
+/// 1. Filler removal on space-delimited tokens ("um", "呃", "えーと", ...)
+/// 2. Spacing/punctuation normalization of each maximal run of whitespace and
+///    punctuation, with CJK rules if the text contains Han characters, Latin otherwise
+///
+/// Only the trailing token and trailing punctuation run stay pending, so appending a
+/// segment costs time proportional to that segment instead of re-running regexes over
+/// the whole transcript. Reading `text` likewise only resolves that pending tail; the
+/// finished, capitalized prefix before it is kept and extended as it grows.
+final class TextPostProcessor {
+    // English, Chinese, Japanese, Korean (order matters: see FillerPass)
+    static let fillerWords = [
+        "um", "uh", "er", "ah", "hmm",
+        "呃", "嗯", "啊", "那个",
+        "えーと", "あの", "えー",
+        "음", "어",
+    ]
+
+    private var passes = TextPostProcessor.fillerWords.map { FillerPass(filler: $0) }
+    private var state = EmitState()
+    private var pendingToken = ""
+    private var hasSegments = false
+    /// Capitalized, left-trimmed form of the committed output (`presentedCount` UTF-8
+    /// bytes of the CJK or Latin stage); it only ever grows, so it is extended in place
+    private var presented = ""
+    private var presentedCJK = false
+    private var presentedCount = 0
+
+    var isEmpty: Bool { !hasSegments }
+
+    /// One-shot processing of a complete text
+    static func process(_ text: String) -> String {
+        let processor = TextPostProcessor()
+        processor.append(text)
+        return processor.text
+    }
+
+    /// Append a segment (joined to the previous one with a space)
+    func append(_ segment: String) {
+        if hasSegments {
+            consume(" ")
+        }
+        hasSegments = true
+        for character in segment {
+            consume(character)
+        }
+    }
+
+    func reset() {
+        passes = Self.fillerWords.map { FillerPass(filler: $0) }
+        state = EmitState()
+        pendingToken = ""
+        hasSegments = false
+        presented = ""
+        presentedCJK = false
+        presentedCount = 0
+    }
+
+    /// Processed text for everything appended so far
+    var text: String {
+        guard hasSegments else { return "" }
+
+        // Resolve the pending token on copies so more segments can still be appended
+        var snapshotPasses = passes
+        var tail = state.pending
+        var tokens = [pendingToken]
+        for i in snapshotPasses.indices {
+            var released: [String] = []
+            for (j, token) in tokens.enumerated() {
+                snapshotPasses[i].push(token, followedBySeparator: j < tokens.count - 1, into: &released)
+            }
+            snapshotPasses[i].flush(into: &released)
+            tokens = released
+        }
+        for token in tokens {
+            tail.emit(token)
+        }
+        let pendingText = tail.finished()
+
+        let committed = state.committed(cjk: tail.isCJK)
+        guard !committed.isEmpty else { return Self.present(pendingText) }
+
+        // Committed output always ends in text, so only the tail can need trimming
+        // (and the first letter is already in `presented`)
+        if presentedCJK != tail.isCJK || presentedCount == 0 || committed.utf8.count < presentedCount {
+            presented = Self.present(committed)
+        } else if committed.utf8.count > presentedCount {
+            let added = committed.utf8.index(committed.utf8.startIndex, offsetBy: presentedCount)
+            presented.append(String(decoding: committed.utf8[added...], as: UTF8.self))
+        }
+        presentedCJK = tail.isCJK
+        presentedCount = committed.utf8.count
+
+        let scalars = pendingText.unicodeScalars
+        let end = scalars.lastIndex { !CharacterSet.whitespaces.contains($0) }.map(scalars.index(after:)) ?? scalars.startIndex
+        return presented + String(scalars[..<end])
+    }
+
+    /// Capitalize the first letter (for English text) and trim surrounding spaces
+    private static func present(_ text: String) -> String {
+        var result = text
+        if let first = result.first {
+            result = first.uppercased() + result.dropFirst()
+        }
+        return result.trimmingCharacters(in: .whitespaces)
+    }
+
+    private func consume(_ character: Character) {
+        guard character == " " else {
+            pendingToken.append(character)
+            return
+        }
+
+        // Token complete and followed by a separator: run it through every filler pass
+        var tokens = [pendingToken]
+        pendingToken = ""
+        for i in passes.indices {
+            var released: [String] = []
+            for token in tokens {
+                passes[i].push(token, followedBySeparator: true, into: &released)
+            }
+            tokens = released
+        }
+        for token in tokens {
+            state.emit(token)
+        }
+    }
+}
+
+// MARK: - Stage 1: Fillers
+
+/// Streaming equivalent of the per-filler replacement rules, applied in list order:
+///   " um " → " "   (non-overlapping, so "a um um b" keeps the second "um")
+///   "^um " → ""
+///   " um," → ","   (merges into the previous token)
+/// Holds back one token, since a following " um," can still extend it.
+private struct FillerPass {
+    let filler: String
+    private var index = 0
+    private var held: String?
+    private var previousRemoved = false
+
+    init(filler: String) {
+        self.filler = filler
+    }
+
+    mutating func push(_ token: String, followedBySeparator: Bool, into released: inout [String]) {
+        let position = index
+        index += 1
+
+        if followedBySeparator && token.lowercased() == filler {
+            if position == 0 {
+                previousRemoved = false
+                return
+            }
+            if !previousRemoved {
+                previousRemoved = true
+                return
+            }
+        }
+        previousRemoved = false
+
+        if let previous = held,
+           let comma = token.firstIndex(of: ","),
+           token[..<comma].lowercased() == filler {
+            held = previous + token[comma...]
+            return
+        }
+
+        if let previous = held {
+            released.append(previous)
+        }
+        held = token
+    }
+
+    mutating func flush(into released: inout [String]) {
+        if let previous = held {
+            released.append(previous)
+        }
+        held = nil
+    }
+}
+
+// MARK: - Emission
+
+/// Joins surviving tokens and feeds both punctuation stages. A value type so `text`
+/// can finish the pending tail on a copy without disturbing the streaming state.
+private struct EmitState {
+    private var hasEmittedToken = false
+    private var containsHan = false
+    private var latin = PunctuationStage(cjk: false)
+    private var cjk = PunctuationStage(cjk: true)
+
+    mutating func emit(_ token: String) {
+        if hasEmittedToken {
+            feed(" ")
+        }
+        feed(token)
+        hasEmittedToken = true
+    }
+
+    var isCJK: Bool { containsHan }
+
+    /// A copy without the committed output: finishing it yields only what follows
+    /// `committed(cjk:)`
+    var pending: EmitState {
+        var copy = self
+        copy.latin = latin.pending
+        copy.cjk = cjk.pending
+        return copy
+    }
+
+    /// Output that later input can no longer change
+    func committed(cjk: Bool) -> String {
+        cjk ? self.cjk.output : latin.output
+    }
+
+    func finished() -> String {
+        containsHan ? cjk.finished() : latin.finished()
+    }
+
+    private mutating func feed(_ text: String) {
+        for character in text {
+            cjk.feed(character)
+            guard !containsHan else { continue }
+
+            if character.unicodeScalars.contains(where: { $0.isHan }) {
+                // Text is CJK from here on; the Latin variant is no longer needed
+                containsHan = true
+                latin = PunctuationStage(cjk: false)
+            } else {
+                latin.feed(character)
+            }
+        }
+    }
+}
+
+// MARK: - Stage 2: Punctuation
+
+/// Normalizes each maximal run of whitespace/punctuation as it closes.
+/// Every cleanup rule only ever spans such a run, so runs are independent.
+private struct PunctuationStage {
+    private static let runPunctuation: Set<Character> = ["。", ".", "，", ",", "？", "?", "！", "!"]
+
+    let cjk: Bool
+    /// Flushed runs and text; never changes once written
+    private(set) var output = ""
+    private var run: [Character] = []
+
+    init(cjk: Bool) {
+        self.cjk = cjk
+    }
+
+    /// The open run alone, without the output before it
+    var pending: PunctuationStage {
+        var stage = PunctuationStage(cjk: cjk)
+        stage.run = run
+        return stage
+    }
+
+    mutating func feed(_ character: Character) {
+        if character.isWhitespace || Self.runPunctuation.contains(character) {
+            run.append(character)
+        } else {
+            flushRun()
+            output.append(character)
+        }
+    }
+
+    func finished() -> String {
+        var copy = self
+        copy.flushRun()
+        return copy.output
+    }
+
+    private mutating func flushRun() {
+        guard !run.isEmpty else { return }
+        output.append(contentsOf: Self.normalize(run, cjk: cjk))
+        run.removeAll(keepingCapacity: true)
+    }
+
+    private static func normalize(_ run: [Character], cjk: Bool) -> [Character] {
+        // Spacing: multiple spaces, space before comma, space before period
+        var result = collapseSpaces(run)
+        result = removeSpace(before: ",", in: result)
+        result = removeSpace(before: ".", in: result)
+
+        if cjk {
+            // Mixed punctuation (with optional spaces) → one Chinese mark
+            result = collapse(result, members: ["。", "."], into: ["。"])
+            result = collapse(result, members: ["，", ","], into: ["，"])
+            result = collapse(result, members: ["？", "?"], into: ["？"])
+            result = collapse(result, members: ["！", "!"], into: ["！"])
+            // ，。 → 。 and 。， → 。
+            result = replace(["，", "。"], with: ["。"], in: result)
+            result = replace(["。", "，"], with: ["。"], in: result)
+            // Period after question/exclamation: ？。 → ？, ！。 → ！
+            result = replace(["？", "。"], with: ["？"], in: result)
+            result = replace(["！", "。"], with: ["！"], in: result)
+        } else {
+            result = collapse(result, members: ["."], into: [".", " "])
+            result = dedupe(",", in: result)
+            result = join(",", ".", keeping: ".", in: result)  // Comma before period → period
+            result = join(".", ",", keeping: ",", in: result)  // Period before comma → comma
+            result = dedupe("?", in: result)
+            result = dedupe("!", in: result)
+        }
+
+        // Remaining runs of 2+ whitespace → single space
+        return collapseWhitespace(result)
+    }
+
+    private static func collapseSpaces(_ run: [Character]) -> [Character] {
+        var result: [Character] = []
+        result.reserveCapacity(run.count)
+        for character in run where !(character == " " && result.last == " ") {
+            result.append(character)
+        }
+        return result
+    }
+
+    private static func removeSpace(before mark: Character, in run: [Character]) -> [Character] {
+        var result: [Character] = []
+        result.reserveCapacity(run.count)
+        for (i, character) in run.enumerated() where !(character == " " && i + 1 < run.count && run[i + 1] == mark) {
+            result.append(character)
+        }
+        return result
+    }
+
+    /// Replace each maximal stretch of `members` + whitespace that contains a member
+    private static func collapse(_ run: [Character], members: Set<Character>, into replacement: [Character]) -> [Character] {
+        var result: [Character] = []
+        var i = 0
+        while i < run.count {
+            guard run[i].isWhitespace || members.contains(run[i]) else {
+                result.append(run[i])
+                i += 1
+                continue
+            }
+            var end = i
+            var hasMember = false
+            while end < run.count && (run[end].isWhitespace || members.contains(run[end])) {
+                hasMember = hasMember || members.contains(run[end])
+                end += 1
+            }
+            if hasMember {
+                result.append(contentsOf: replacement)
+            } else {
+                result.append(contentsOf: run[i..<end])
+            }
+            i = end
+        }
+        return result
+    }
+
+    private static func replace(_ pair: [Character], with replacement: [Character], in run: [Character]) -> [Character] {
+        var result: [Character] = []
+        var i = 0
+        while i < run.count {
+            if i + 1 < run.count && run[i] == pair[0] && run[i + 1] == pair[1] {
+                result.append(contentsOf: replacement)
+                i += 2
+            } else {
+                result.append(run[i])
+                i += 1
+            }
+        }
+        return result
+    }
+
+    /// `first` + optional whitespace + `second` → `kept`
+    private static func join(_ first: Character, _ second: Character, keeping kept: Character, in run: [Character]) -> [Character] {
+        var result: [Character] = []
+        var i = 0
+        while i < run.count {
+            if run[i] == first {
+                var j = i + 1
+                while j < run.count && run[j].isWhitespace {
+                    j += 1
+                }
+                if j < run.count && run[j] == second {
+                    result.append(kept)
+                    i = j + 1
+                    continue
+                }
+            }
+            result.append(run[i])
+            i += 1
+        }
+        return result
+    }
+
+    private static func dedupe(_ mark: Character, in run: [Character]) -> [Character] {
+        var result: [Character] = []
+        result.reserveCapacity(run.count)
+        for character in run where !(character == mark && result.last == mark) {
+            result.append(character)
+        }
+        return result
+    }
+
+    private static func collapseWhitespace(_ run: [Character]) -> [Character] {
+        var result: [Character] = []
+        var i = 0
+        while i < run.count {
+            guard run[i].isWhitespace else {
+                result.append(run[i])
+                i += 1
+                continue
+            }
+            var end = i
+            while end < run.count && run[end].isWhitespace {
+                end += 1
+            }
+            if end - i >= 2 {
+                result.append(" ")
+            } else {
+                result.append(run[i])
+            }
+            i = end
+        }
+        return result
+    }
+}
+
+extension Unicode.Scalar {
+    /// Han ideograph (the `\p{Han}` script class)
+    var isHan: Bool {
+        switch value {
+        case 0x2E80...0x2FD5,      // CJK radicals, Kangxi radicals
+             0x3005, 0x3007,
+             0x3021...0x3029,
+             0x3038...0x303B,
+             0x3400...0x4DBF,      // Extension A
+             0x4E00...0x9FFF,      // Unified Ideographs
+             0xF900...0xFAFF,      // Compatibility Ideographs
+             0x20000...0x323AF:    // Extensions B-H, Compatibility Supplement
+            return true
+        default:
+            return false
+        }
+    }
+}
@@ -0,0 +1,305 @@
+import Foundation
+
+/// Pipeline instrumentation: timed spans per stage plus counters, exported as Chrome trace
+/// JSON (chrome://tracing or ui.perfetto.dev) and as periodic stats snapshots.
+///
+/// Off until `start` (the app starts it for `--trace <file.json>`); while off a span costs
+/// one flag check. Events go to a ring buffer allocated up front, so recording never
+/// allocates; once it is full the oldest events are overwritten (the stats keep counting).
+/// Building with `-D VOCA_NO_TRACING` compiles every call down to nothing.
+enum Trace {
+    enum Stage: Int, CaseIterable {
+        case capture, resample, frontEnd, vad, transcribe, mel, lfr, inference, decode, postProcess
+    }
+
+    enum Counter: Int, CaseIterable {
+        /// Buffers allocated per call on hot paths, and their size
+        case allocations, allocatedBytes
+        /// Capture frames the input tap never delivered
+        case droppedFrames
+        /// Speech segments waiting to be transcribed
+        case pendingSegments
+        /// Callers waiting for a free ONNX session
+        case sessionWaiters
+    }
+
+    /// An open span; pass it to `end`
+    struct Span {
+        #if !VOCA_NO_TRACING
+        fileprivate let stage: Stage
+        fileprivate let start: UInt64
+        #endif
+    }
+
+    /// Totals since `start`
+    struct Snapshot {
+        struct StageStats {
+            let stage: Stage
+            let count: Int
+            let totalMs: Double
+            let maxMs: Double
+        }
+
+        let seconds: Double
+        let stages: [StageStats]
+        let counters: [(counter: Counter, value: Int64, peak: Int64)]
+
+        /// One line per stage that ran, then the non-zero counters
+        var summary: String {
+            var lines = ["📊 Trace after \(String(format: "%.1f", seconds)) s"]
+            for stats in stages where stats.count > 0 {
+                lines.append("  \(stats.stage)".padding(toLength: 14, withPad: " ", startingAt: 0)
+                    + " ×\(stats.count)  total \(String(format: "%.1f", stats.totalMs)) ms"
+                    + "  mean \(String(format: "%.2f", stats.totalMs / Double(stats.count))) ms"
+                    + "  max \(String(format: "%.2f", stats.maxMs)) ms")
+            }
+            for entry in counters where entry.value != 0 || entry.peak != 0 {
+                lines.append("  \(entry.counter) = \(entry.value) (peak \(entry.peak))")
+            }
+            return lines.joined(separator: "\n")
+        }
+    }
+
+    // MARK: - Recording
+
+    /// Whether events are being recorded
+    static var isEnabled: Bool {
+        #if VOCA_NO_TRACING
+        return false
+        #else
+        return enabled
+        #endif
+    }
+
+    @inline(__always)
+    static func begin(_ stage: Stage) -> Span {
+        #if VOCA_NO_TRACING
+        return Span()
+        #else
+        return Span(stage: stage, start: enabled ? DispatchTime.now().uptimeNanoseconds : 0)
+        #endif
+    }
+
+    @inline(__always)
+    static func end(_ span: Span) {
+        #if !VOCA_NO_TRACING
+        guard enabled, span.start != 0 else { return }
+        record(span.stage, start: span.start, end: DispatchTime.now().uptimeNanoseconds)
+        #endif
+    }
+
+    /// Time `body` as one span of `stage`
+    @inline(__always)
+    static func span<T>(_ stage: Stage, _ body: () throws -> T) rethrows -> T {
+        #if VOCA_NO_TRACING
+        return try body()
+        #else
+        let span = begin(stage)
+        defer { end(span) }
+        return try body()
+        #endif
+    }
+
+    /// Add to a counter
+    @inline(__always)
+    static func count(_ counter: Counter, by delta: Int = 1) {
+        #if !VOCA_NO_TRACING
+        guard enabled else { return }
+        record(counter, delta: Int64(delta), absolute: false)
+        #endif
+    }
+
+    /// Set a gauge (queue depths)
+    @inline(__always)
+    static func gauge(_ counter: Counter, _ value: Int) {
+        #if !VOCA_NO_TRACING
+        guard enabled else { return }
+        record(counter, delta: Int64(value), absolute: true)
+        #endif
+    }
+
+    /// Count a buffer allocated on a hot path
+    @inline(__always)
+    static func allocated(bytes: Int) {
+        #if !VOCA_NO_TRACING
+        guard enabled else { return }
+        record(.allocations, delta: 1, absolute: false)
+        record(.allocatedBytes, delta: Int64(bytes), absolute: false)
+        #endif
+    }
+
+    // MARK: - Control
+
+    /// Start recording, keeping up to `capacity` events; `snapshotInterval` > 0 prints a
+    /// stats snapshot that often
+    static func start(capacity: Int = 1 << 16, snapshotInterval: TimeInterval = 10) {
+        #if !VOCA_NO_TRACING
+        lock.lock()
+        events = [Event](repeating: Event(), count: max(capacity, 1))
+        eventCount = 0
+        stageStats = [StageTotals](repeating: StageTotals(), count: Stage.allCases.count)
+        counterValues = [Int64](repeating: 0, count: Counter.allCases.count)
+        counterPeaks = counterValues
+        origin = DispatchTime.now().uptimeNanoseconds
+        lock.unlock()
+        enabled = true
+
+        timer?.cancel()
+        timer = nil
+        if snapshotInterval > 0 {
+            let source = DispatchSource.makeTimerSource(queue: DispatchQueue.global(qos: .utility))
+            source.schedule(deadline: .now() + snapshotInterval, repeating: snapshotInterval)
+            source.setEventHandler {
+                print(snapshot().summary)
+            }
+            source.resume()
+            timer = source
+        }
+        #endif
+    }
+
+    /// Stop recording (events stay available for export)
+    static func stop() {
+        #if !VOCA_NO_TRACING
+        enabled = false
+        timer?.cancel()
+        timer = nil
+        #endif
+    }
+
+    /// `--trace <file.json> [--trace-interval <seconds>]`: trace this run, written out by
+    /// `finishFromArguments` at quit
+    static func startFromArguments() {
+        let arguments = ProcessInfo.processInfo.arguments
+        guard let index = arguments.firstIndex(of: "--trace"), index + 1 < arguments.count else { return }
+        let interval = arguments.firstIndex(of: "--trace-interval")
+            .flatMap { $0 + 1 < arguments.count ? TimeInterval(arguments[$0 + 1]) : nil } ?? 10
+        start(snapshotInterval: interval)
+        print(isEnabled ? "📊 Tracing to \(arguments[index + 1])" : "⚠️ Tracing is compiled out (VOCA_NO_TRACING)")
+    }
+
+    static func finishFromArguments() {
+        let arguments = ProcessInfo.processInfo.arguments
+        guard isEnabled, let index = arguments.firstIndex(of: "--trace"), index + 1 < arguments.count else { return }
+        stop()
+        print(snapshot().summary)
+        let url = URL(fileURLWithPath: arguments[index + 1])
+        do {
+            try writeChromeTrace(to: url)
+            print("📊 Trace written to \(url.path)")
+        } catch {
+            print("⚠️ Failed to write trace: \(error)")
+        }
+    }
+
+    // MARK: - Export
+
+    static func snapshot() -> Snapshot {
+        #if VOCA_NO_TRACING
+        return Snapshot(seconds: 0, stages: [], counters: [])
+        #else
+        lock.lock()
+        defer { lock.unlock() }
+        let now = DispatchTime.now().uptimeNanoseconds
+        return Snapshot(
+            seconds: origin == 0 ? 0 : Double(now - origin) / 1e9,
+            stages: stageStats.enumerated().map { index, totals in
+                Snapshot.StageStats(stage: Stage(rawValue: index)!, count: totals.count,
+                                    totalMs: Double(totals.totalNs) / 1e6, maxMs: Double(totals.maxNs) / 1e6)
+            },
+            counters: counterValues.enumerated().map { index, value in
+                (counter: Counter(rawValue: index)!, value: value, peak: counterPeaks[index])
+            }
+        )
+        #endif
+    }
+
+    /// Chrome trace event format: complete ("X") events for spans, counter ("C") events
+    static func writeChromeTrace(to url: URL) throws {
+        #if !VOCA_NO_TRACING
+        lock.lock()
+        let capacity = events.count
+        let recorded = min(eventCount, capacity)
+        let first = eventCount - recorded
+        let ordered = (0..<recorded).map { events[(first + $0) % capacity] }
+        let start = origin
+        lock.unlock()
+
+        var json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+        json.reserveCapacity(recorded * 100)
+        for (index, event) in ordered.enumerated() {
+            let timestamp = String(format: "%.3f", Double(event.time &- start) / 1000)
+            if event.isCounter {
+                let name = Counter(rawValue: Int(event.index))!
+                json += "{\"name\":\"\(name)\",\"ph\":\"C\",\"ts\":\(timestamp),\"pid\":1,"
+                    + "\"args\":{\"value\":\(event.value)}}"
+            } else {
+                let name = Stage(rawValue: Int(event.index))!
+                json += "{\"name\":\"\(name)\",\"cat\":\"pipeline\",\"ph\":\"X\",\"ts\":\(timestamp),"
+                    + "\"dur\":\(String(format: "%.3f", Double(event.value) / 1000)),\"pid\":1,\"tid\":\(event.thread)}"
+            }
+            json += index + 1 < ordered.count ? ",\n" : "\n"
+        }
+        json += "]}\n"
+        try json.write(to: url, atomically: true, encoding: .utf8)
+        #endif
+    }
+
+    // MARK: - Storage
+
+    #if !VOCA_NO_TRACING
+    private struct Event {
+        var time: UInt64 = 0
+        /// Span duration (ns) or counter value
+        var value: Int64 = 0
+        var thread: UInt32 = 0
+        var index: UInt8 = 0
+        var isCounter = false
+    }
+
+    private struct StageTotals {
+        var count = 0
+        var totalNs: UInt64 = 0
+        var maxNs: UInt64 = 0
+    }
+
+    private static var enabled = false
+    private static let lock = NSLock()
+    private static var events: [Event] = []
+    private static var eventCount = 0
+    private static var stageStats: [StageTotals] = []
+    private static var counterValues: [Int64] = []
+    private static var counterPeaks: [Int64] = []
+    private static var origin: UInt64 = 0
+    private static var timer: DispatchSourceTimer?
+
+    private static func record(_ stage: Stage, start: UInt64, end: UInt64) {
+        let duration = end &- start
+        let thread = pthread_mach_thread_np(pthread_self())
+        lock.lock()
+        defer { lock.unlock() }
+        guard !events.isEmpty else { return }
+        stageStats[stage.rawValue].count += 1
+        stageStats[stage.rawValue].totalNs += duration
+        stageStats[stage.rawValue].maxNs = max(stageStats[stage.rawValue].maxNs, duration)
+        append(Event(time: start, value: Int64(duration), thread: thread, index: UInt8(stage.rawValue)))
+    }
+
+    private static func record(_ counter: Counter, delta: Int64, absolute: Bool) {
+        let now = DispatchTime.now().uptimeNanoseconds
+        lock.lock()
+        defer { lock.unlock() }
+        guard !events.isEmpty else { return }
+        let value = absolute ? delta : counterValues[counter.rawValue] + delta
+        counterValues[counter.rawValue] = value
+        counterPeaks[counter.rawValue] = max(counterPeaks[counter.rawValue], value)
+        append(Event(time: now, value: value, index: UInt8(counter.rawValue), isCounter: true))
+    }
+
+    /// Caller holds `lock`
+    private static func append(_ event: Event) {
+        events[eventCount % events.count] = event
+        eventCount += 1
+    }
+    #endif
+}
@@ -5,77 +5,276 @@ import VoicePipeline
 struct TranscriptionResult {
     let text: String?
     let modelTime: TimeInterval
+    /// Word timings over the whole recording (empty if the model gives no alignment)
+    var words: [TimedWord] = []
 }
 
 class Transcriber {
-    private let engine: ASREngine
+    /// How recordings longer than one chunk are split
+    enum Chunking {
+        /// Cut in pauses found by an energy VAD; continuous speech is hard-cut at 60 s
+        case silence
+        /// Fixed-length overlapping chunks, reconciled at the seams
+        case overlapping(OverlapChunker)
+    }
+
+    /// Fixed choice of chunking; nil overlaps chunks for engines with word timings and cuts in
+    /// pauses for text-only ones, whose seams could only be aligned on the words themselves
+    var chunking: Chunking?
+
+    /// Incremental segments seen, and how many were skipped by confidence
+    struct SegmentStats {
+        var segments = 0
+        /// Low VAD probability: the model was never run
+        var skippedBeforeModel = 0
+        /// Blank-dominated CTC output: decoding and post-processing were skipped
+        var skippedDecoding = 0
+
+        var skippedRatio: Double {
+            segments == 0 ? 0 : Double(skippedBeforeModel + skippedDecoding) / Double(segments)
+        }
+    }
+
+    var segmentStats: SegmentStats {
+        statsLock.lock()
+        defer { statsLock.unlock() }
+        return stats
+    }
+
+    /// Per-utterance SenseVoice → Whisper Turbo escalation, with its route counters
+    let router = LanguageRouter()
+    /// Overrides the language-routing setting (nil follows it)
+    var routing: Bool?
+
+    private let models: ModelRegistry
+    /// One Whisper escalation at a time
+    private let escalationLock = NSLock()
+
+    // Silero VAD for segment confidence, if installed
+    private var speechDetector: SpeechDetector?
+    private var speechDetectorLoaded = false
+    private let detectorLock = NSLock()
+    private let statsLock = NSLock()
+    private var stats = SegmentStats()
 
-    init(engine: ASREngine) {
-        self.engine = engine
+    init(models: ModelRegistry) {
+        self.models = models
     }
 
-    func transcribe(audioURL: URL, completion: @escaping (TranscriptionResult) -> Void) {
+    /// Transcribe a recording in the background; chunks found in `cache` aren't run again
+    func transcribe(audioURL: URL, cache: TranscriptCache? = nil, completion: @escaping (TranscriptionResult) -> Void) {
         DispatchQueue.global(qos: .userInitiated).async { [weak self] in
             guard let self = self else {
                 completion(TranscriptionResult(text: nil, modelTime: 0))
                 return
             }
 
-            let result = self.runTranscription(audioURL: audioURL)
+            let result = self.runTranscription(audioURL: audioURL, cache: cache)
             completion(result)
         }
     }
 
-    private func runTranscription(audioURL: URL) -> TranscriptionResult {
+    private func runTranscription(audioURL: URL, cache: TranscriptCache?) -> TranscriptionResult {
         // Load audio file to float array
-        guard let audioSamples = loadAudioFile(url: audioURL) else {
+        guard let audioSamples = Self.loadAudioFile(url: audioURL) else {
             return TranscriptionResult(text: nil, modelTime: 0)
         }
+        // Cached chunks are keyed on the samples the stored 16-bit recording will give back
+        return transcribe(samples: cache == nil ? audioSamples : TranscriptCache.quantized(audioSamples), cache: cache)
+    }
 
-        let modelStart = Date()
+    /// Transcribe 16kHz mono audio of any length on the calling thread
+    func transcribe(samples audioSamples: [Float], chunking: Chunking? = nil, cache: TranscriptCache? = nil) -> TranscriptionResult {
+        // Every chunk uses the model active now, even if the user switches mid-way
+        guard let active = models.recognizer() else {
+            return TranscriptionResult(text: nil, modelTime: 0)
+        }
 
-        // For short audio (< 60 seconds), transcribe directly
+        // Chunks already transcribed under the same configuration come from the cache
+        let configuration = cache.map { _ in cacheConfiguration(for: active.model, recognizer: active.recognizer) }
+        func recognize(_ range: Range<Int>) -> TimedTranscript? {
+            guard let cache = cache, let configuration = configuration else {
+                return transcribeChunk(Array(audioSamples[range]), model: active.model, recognizer: active.recognizer)
+            }
+            let key = TranscriptCache.key(audioSamples[range], configuration: configuration)
+            if let hit = cache.transcript(for: key) {
+                return hit
+            }
+            let result = transcribeChunk(Array(audioSamples[range]), model: active.model, recognizer: active.recognizer)
+            if let result = result {
+                cache.store(result, for: key)
+            }
+            return result
+        }
+
+        let modelStart = Date()
         let sampleRate = 16000
-        let maxChunkSamples = 60 * sampleRate  // 60 seconds max per chunk
 
-        if audioSamples.count <= maxChunkSamples {
-            let text = transcribeChunk(audioSamples)
+        let defaultChunking = active.recognizer.hasWordTimings ? Chunking.overlapping(OverlapChunker()) : .silence
+        switch chunking ?? self.chunking ?? defaultChunking {
+        case .overlapping(let chunker):
+            let ranges = chunker.ranges(sampleCount: audioSamples.count, sampleRate: sampleRate)
+            var results = [TimedTranscript?](repeating: nil, count: ranges.count)
+
+            // ONNX sessions take chunks in parallel; other engines run one at a time
+            if concurrency(of: active.recognizer) > 1 && ranges.count > 1 {
+                results.withUnsafeMutableBufferPointer { buffer in
+                    let output = buffer
+                    DispatchQueue.concurrentPerform(iterations: ranges.count) { index in
+                        output[index] = recognize(ranges[index])
+                    }
+                }
+            } else {
+                for (index, range) in ranges.enumerated() {
+                    results[index] = recognize(range)
+                }
+            }
+
+            let chunks = zip(ranges, results).map { range, result -> OverlapChunker.Chunk in
+                let start = Double(range.lowerBound) / Double(sampleRate)
+                var transcript = result ?? TimedTranscript(text: "")
+                transcript.words = WordTiming.shift(transcript.words, by: start)
+                return OverlapChunker.Chunk(start: start, end: Double(range.upperBound) / Double(sampleRate),
+                                            transcript: transcript)
+            }
+            let merged = OverlapChunker.merge(chunks)
             let modelTime = Date().timeIntervalSince(modelStart)
-            return TranscriptionResult(text: text, modelTime: modelTime)
-        }
+            return TranscriptionResult(text: merged.text.isEmpty ? nil : merged.text, modelTime: modelTime,
+                                       words: merged.words)
 
-        // For longer audio, use VAD-based chunking
-        let chunks = splitAudioByVAD(audioSamples, sampleRate: sampleRate, maxChunkSamples: maxChunkSamples)
+        case .silence:
+            // For short audio (< 60 seconds), transcribe directly
+            let maxChunkSamples = 60 * sampleRate  // 60 seconds max per chunk
 
-        var results: [String] = []
-        for chunk in chunks {
-            if let text = transcribeChunk(chunk), !text.isEmpty {
-                results.append(text)
+            if audioSamples.count <= maxChunkSamples {
+                let result = recognize(0..<audioSamples.count)
+                let modelTime = Date().timeIntervalSince(modelStart)
+                return TranscriptionResult(text: result?.text, modelTime: modelTime, words: result?.words ?? [])
             }
+
+            // For longer audio, use VAD-based chunking
+            let chunks = splitAudioByVAD(audioSamples, sampleRate: sampleRate, maxChunkSamples: maxChunkSamples)
+
+            var results: [String] = []
+            var words: [TimedWord] = []
+            for chunk in chunks {
+                if let result = recognize(chunk), !result.text.isEmpty {
+                    results.append(result.text)
+                    words += WordTiming.shift(result.words, by: Double(chunk.lowerBound) / Double(sampleRate))
+                }
+            }
+
+            let modelTime = Date().timeIntervalSince(modelStart)
+            let combinedText = results.joined(separator: " ")
+
+            return TranscriptionResult(text: combinedText.isEmpty ? nil : combinedText, modelTime: modelTime, words: words)
         }
+    }
 
-        let modelTime = Date().timeIntervalSince(modelStart)
-        let combinedText = results.joined(separator: " ")
+    /// Everything besides the audio that shapes a chunk's transcript, for cache keys
+    private func cacheConfiguration(for model: ASRModel, recognizer: SpeechRecognizer) -> String {
+        let settings = AppSettings.shared
+        let folder = ModelManager.modelFolderNames[model].map { "\(models.modelDir)/\($0)" } ?? models.modelDir
+        let installed = ((try? FileManager.default.attributesOfItem(atPath: folder))?[.modificationDate] as? Date)?
+            .timeIntervalSince1970 ?? 0
+        var parts = [
+            model.rawValue,
+            "installed \(installed)",
+            "app \(Bundle.main.infoDictionary?["CFBundleShortVersionString"] as? String ?? "")",
+            "confidence \(settings.minSpeechConfidence)",
+        ]
+        if model == .senseVoice {
+            parts += [
+                "onnx \(settings.senseVoiceOnONNX)",
+                "logits \(logitPrecision(of: recognizer))",
+                "routing \(routing ?? settings.languageRouting)",
+                "hotwords \(settings.customWords.joined(separator: "\u{1F}"))",
+            ]
+        }
+        return parts.joined(separator: "|")
+    }
+
+    /// Logit storage of the SenseVoice engine a transcription runs on, as it was loaded
+    /// (the setting only reaches engines loaded after it changed)
+    private func logitPrecision(of recognizer: SpeechRecognizer) -> String {
+        (recognizer as? CTCRecognizer).map { "\($0.precision)" } ?? "-"
+    }
+
+    private func transcribeChunk(_ samples: [Float], model: ASRModel, recognizer: SpeechRecognizer) -> TimedTranscript? {
+        let span = Trace.begin(.transcribe)
+        defer { Trace.end(span) }
+
+        if model == .senseVoice && (routing ?? AppSettings.shared.languageRouting) {
+            return transcribeRouted(samples, recognizer: recognizer)
+        }
+        return transcribeOnce(samples, model: model, recognizer: recognizer)
+    }
+
+    /// One model's pass; `audio` is the samples already converted for the framework, if any
+    private func transcribeOnce(_ samples: [Float], model: ASRModel, recognizer: SpeechRecognizer,
+                                audio: KotlinFloatArray? = nil) -> TimedTranscript? {
+        // Custom-word biasing decodes SenseVoice's CTC output
+        if let ctc = recognizer as? CTCRecognizer {
+            ctc.setHotwords(AppSettings.shared.customWords)
+        }
+
+        let kotlinArray = audio ?? Self.kotlinArray(samples)
+        if let result = recognizer.transcribeTimed(audio: kotlinArray) {
+            return result
+        }
+        // Engines without app-side stages (mel through decode happen inside the framework)
+        return Trace.span(.inference) { recognizer.transcribe(audio: kotlinArray) }.map { TimedTranscript(text: $0) }
+    }
+
+    /// SenseVoice first, on the registry's engine (both SenseVoice engines report the language
+    /// tag); the router decides whether Whisper Turbo hears the same audio again
+    private func transcribeRouted(_ samples: [Float], recognizer: SpeechRecognizer) -> TimedTranscript? {
+        let audio = Self.kotlinArray(samples)
+        let start = Date()
+        let first = transcribeOnce(samples, model: .senseVoice, recognizer: recognizer, audio: audio)
+        let senseVoiceMs = Date().timeIntervalSince(start) * 1000
+
+        let route = router.route(first)
+        guard route != .senseVoice else {
+            router.record(route, senseVoiceMs: senseVoiceMs)
+            return first
+        }
+
+        let escalated = Date()
+        escalationLock.lock()
+        let text = models.recognizer(for: .whisperTurbo).flatMap { whisper in
+            Trace.span(.inference) { whisper.transcribe(audio: audio) }
+        }
+        escalationLock.unlock()
+        let whisperMs = Date().timeIntervalSince(escalated) * 1000
 
-        return TranscriptionResult(text: combinedText.isEmpty ? nil : combinedText, modelTime: modelTime)
+        guard let text = text, !text.isEmpty else {
+            router.record(route, senseVoiceMs: senseVoiceMs, whisperMs: whisperMs, whisperFailed: true)
+            return first
+        }
+        router.record(route, senseVoiceMs: senseVoiceMs, whisperMs: whisperMs)
+        let tag = first?.language.map { "\($0.code) \(String(format: "%.2f", $0.probability))" } ?? "no tag"
+        print("📝 Routing: \(route.rawValue) (\(tag)) → Whisper Turbo in \(Int(whisperMs))ms")
+        return TimedTranscript(text: text)
     }
 
-    private func transcribeChunk(_ samples: [Float]) -> String? {
-        let kotlinArray = KotlinFloatArray(size: Int32(samples.count))
+    private static func kotlinArray(_ samples: [Float]) -> KotlinFloatArray {
+        let array = KotlinFloatArray(size: Int32(samples.count))
+        Trace.allocated(bytes: samples.count * MemoryLayout<Float>.size)
         for (index, sample) in samples.enumerated() {
-            kotlinArray.set(index: Int32(index), value: sample)
+            array.set(index: Int32(index), value: sample)
         }
-        return engine.transcribe(audio: kotlinArray)
+        return array
     }
 
     /// Split audio into chunks using energy-based VAD (Voice Activity Detection)
-    private func splitAudioByVAD(_ samples: [Float], sampleRate: Int, maxChunkSamples: Int) -> [[Float]] {
+    private func splitAudioByVAD(_ samples: [Float], sampleRate: Int, maxChunkSamples: Int) -> [Range<Int>] {
         let minSilenceSamples = Int(0.3 * Double(sampleRate))  // 300ms minimum silence
         let minChunkSamples = sampleRate  // 1 second minimum chunk
         let windowSize = Int(0.025 * Double(sampleRate))  // 25ms window for energy calculation
         let energyThreshold: Float = 0.01  // Silence threshold
 
-        var chunks: [[Float]] = []
+        var chunks: [Range<Int>] = []
         var currentChunkStart = 0
         var silenceStart: Int? = nil
 
@@ -103,8 +302,7 @@ class Transcriber {
                     // If we have enough silence and a reasonable chunk, split here
                     if silenceLength >= minSilenceSamples && chunkLength >= minChunkSamples {
                         let splitPoint = start + silenceLength / 2  // Split in middle of silence
-                        let chunk = Array(samples[currentChunkStart..<splitPoint])
-                        chunks.append(chunk)
+                        chunks.append(currentChunkStart..<splitPoint)
                         currentChunkStart = splitPoint
                     }
                 }
@@ -115,8 +313,7 @@ class Transcriber {
             let chunkLength = i - currentChunkStart
             if chunkLength >= maxChunkSamples {
                 // Try to find a recent silence point, or just split
-                let chunk = Array(samples[currentChunkStart..<i])
-                chunks.append(chunk)
+                chunks.append(currentChunkStart..<i)
                 currentChunkStart = i
                 silenceStart = nil
             }
@@ -126,9 +323,8 @@ class Transcriber {
 
         // Add remaining samples as final chunk
         if currentChunkStart < samples.count {
-            let chunk = Array(samples[currentChunkStart...])
-            if chunk.count >= minChunkSamples / 2 {  // Only add if meaningful
-                chunks.append(chunk)
+            if samples.count - currentChunkStart >= minChunkSamples / 2 {  // Only add if meaningful
+                chunks.append(currentChunkStart..<samples.count)
             }
         }
 
@@ -137,73 +333,37 @@ class Transcriber {
     }
 
     /// Load WAV/M4A audio file and convert to 16kHz mono float samples
-    private func loadAudioFile(url: URL) -> [Float]? {
+    static func loadAudioFile(url: URL) -> [Float]? {
         do {
             let audioFile = try AVAudioFile(forReading: url)
-
-            // Target format: 16kHz, mono, float
-            guard let targetFormat = AVAudioFormat(
-                commonFormat: .pcmFormatFloat32,
-                sampleRate: 16000,
-                channels: 1,
-                interleaved: false
-            ) else {
-                print("Failed to create target audio format")
-                return nil
-            }
-
-            // Create converter
-            guard let converter = AVAudioConverter(from: audioFile.processingFormat, to: targetFormat) else {
-                print("Failed to create audio converter")
-                return nil
-            }
-
-            // Calculate output buffer size
-            let inputLength = AVAudioFrameCount(audioFile.length)
-            let ratio = targetFormat.sampleRate / audioFile.processingFormat.sampleRate
-            let outputLength = AVAudioFrameCount(Double(inputLength) * ratio)
-
-            guard let outputBuffer = AVAudioPCMBuffer(pcmFormat: targetFormat, frameCapacity: outputLength) else {
-                print("Failed to create output buffer")
+            let format = audioFile.processingFormat
+            guard format.sampleRate >= 1, format.channelCount > 0 else {
+                print("Unsupported audio format: \(format)")
                 return nil
             }
 
-            // Read input
-            guard let inputBuffer = AVAudioPCMBuffer(
-                pcmFormat: audioFile.processingFormat,
-                frameCapacity: inputLength
-            ) else {
+            // Read in blocks so long files never hold a second full-rate copy
+            let blockFrames: AVAudioFrameCount = 65536
+            guard let block = AVAudioPCMBuffer(pcmFormat: format, frameCapacity: blockFrames) else {
                 print("Failed to create input buffer")
                 return nil
             }
 
-            try audioFile.read(into: inputBuffer)
-
-            // Convert
-            var error: NSError?
-            let inputBlock: AVAudioConverterInputBlock = { inNumPackets, outStatus in
-                outStatus.pointee = .haveData
-                return inputBuffer
-            }
-
-            converter.convert(to: outputBuffer, error: &error, withInputFrom: inputBlock)
-
-            if let error = error {
-                print("Audio conversion error: \(error)")
-                return nil
-            }
-
-            // Extract float samples
-            guard let floatData = outputBuffer.floatChannelData?[0] else {
-                print("Failed to get float channel data")
-                return nil
-            }
-
-            let frameCount = Int(outputBuffer.frameLength)
-            var samples = [Float](repeating: 0, count: frameCount)
-            for i in 0..<frameCount {
-                samples[i] = floatData[i]
+            let resampler = Resampler(inputRate: Int(format.sampleRate), outputRate: 16000)
+            var samples: [Float] = []
+            samples.reserveCapacity(Int(Double(audioFile.length) * 16000 / format.sampleRate) + 1)
+            var mono: [Float] = []
+
+            while audioFile.framePosition < audioFile.length {
+                try audioFile.read(into: block, frameCount: blockFrames)
+                guard block.frameLength > 0 else { break }
+                mono.removeAll(keepingCapacity: true)
+                block.appendMono(to: &mono)
+                Trace.span(.resample) {
+                    resampler.process(mono, into: &samples)
+                }
             }
+            resampler.flush(into: &samples)
 
             return samples
 
@@ -220,14 +380,116 @@ class Transcriber {
                 completion(nil)
                 return
             }
-            let text = self.transcribeChunk(samples)
-            completion(text)
+            guard let active = self.models.recognizer() else {
+                completion(nil)
+                return
+            }
+
+            // No speech by the VAD's reckoning: don't run the model at all
+            let vadProbability = self.detectorForConfidence()?.peakProbability(samples)
+            if SpeechConfidence(vadProbability: vadProbability).isBelowThreshold {
+                self.countSegment(skippedBeforeModel: true)
+                print("⏭️ Skipped segment: speech probability \(String(format: "%.2f", vadProbability ?? 0))")
+                completion(nil)
+                return
+            }
+
+            let result = self.transcribeChunk(samples, model: active.model, recognizer: active.recognizer)
+            let skippedDecoding = result?.confidence?.isBelowThreshold ?? false
+            self.countSegment(skippedDecoding: skippedDecoding)
+            if skippedDecoding {
+                print("⏭️ Skipped decoding: blank-dominated segment")
+            }
+            completion(result?.text)
+        }
+    }
+
+    /// How many utterances `transcribeBatch` runs at once with the active model
+    var batchConcurrency: Int {
+        models.recognizer().map { concurrency(of: $0.recognizer) } ?? 1
+    }
+
+    /// Utterances a recognizer can take at once (its ONNX sessions)
+    private func concurrency(of recognizer: SpeechRecognizer) -> Int {
+        (recognizer as? ONNXSenseVoice)?.sessionCount ?? 1
+    }
+
+    /// Transcribe independent utterances together on the calling thread (the server's
+    /// micro-batches): the model is looked up once, utterances run in parallel when the
+    /// engine has several sessions, and those the VAD rejects never reach the model
+    func transcribeBatch(_ batch: [[Float]]) -> [TranscriptionResult] {
+        let empty = TranscriptionResult(text: nil, modelTime: 0)
+        guard let active = models.recognizer() else {
+            return batch.map { _ in empty }
         }
+        let detector = detectorForConfidence()
+        let maxChunkSamples = 60 * 16000
+
+        func run(_ samples: [Float]) -> TranscriptionResult {
+            if SpeechConfidence(vadProbability: detector?.peakProbability(samples)).isBelowThreshold {
+                countSegment(skippedBeforeModel: true)
+                return empty
+            }
+            guard samples.count <= maxChunkSamples else {
+                return transcribe(samples: samples)
+            }
+            let start = Date()
+            let result = transcribeChunk(samples, model: active.model, recognizer: active.recognizer)
+            countSegment(skippedDecoding: result?.confidence?.isBelowThreshold ?? false)
+            let text = result?.text ?? ""
+            return TranscriptionResult(text: text.isEmpty ? nil : text, modelTime: Date().timeIntervalSince(start),
+                                       words: result?.words ?? [])
+        }
+
+        var results = [TranscriptionResult](repeating: empty, count: batch.count)
+        if concurrency(of: active.recognizer) > 1 && batch.count > 1 {
+            results.withUnsafeMutableBufferPointer { buffer in
+                let output = buffer
+                DispatchQueue.concurrentPerform(iterations: batch.count) { index in
+                    output[index] = run(batch[index])
+                }
+            }
+        } else {
+            for index in batch.indices {
+                results[index] = run(batch[index])
+            }
+        }
+        return results
+    }
+
+    /// A streaming recognizer for live partials, if the active model can stream (SenseVoice on
+    /// ONNX Runtime). Custom words need the beam search over a whole segment, so they keep
+    /// the segment-at-a-time path.
+    func makeStream() -> StreamingRecognizer? {
+        guard AppSettings.shared.customWords.isEmpty,
+              let engine = models.recognizer()?.recognizer as? ONNXSenseVoice else {
+            return nil
+        }
+        return StreamingRecognizer(engine: engine)
+    }
+
+    /// The VAD model, loaded on first use when confidence gating is on
+    private func detectorForConfidence() -> SpeechDetector? {
+        guard SpeechConfidence.threshold > 0 else { return nil }
+        detectorLock.lock()
+        defer { detectorLock.unlock() }
+        if !speechDetectorLoaded {
+            speechDetector = SpeechDetector.load(modelDir: models.modelDir)
+            speechDetectorLoaded = true
+        }
+        return speechDetector
+    }
+
+    private func countSegment(skippedBeforeModel: Bool = false, skippedDecoding: Bool = false) {
+        statsLock.lock()
+        stats.segments += 1
+        stats.skippedBeforeModel += skippedBeforeModel ? 1 : 0
+        stats.skippedDecoding += skippedDecoding ? 1 : 0
+        statsLock.unlock()
     }
 
-    // Legacy methods for compatibility (no-op since model is fixed in ASREngine)
+    /// Switch the ASR model; loads in the background and never waits for a running transcription
     func setModel(_ model: ASRModel) {
-        // Model selection handled by ASREngine internally
-        // For now, only SenseVoice is supported
+        models.setActive(model)
     }
 }
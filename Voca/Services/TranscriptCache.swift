@@ -0,0 +1,161 @@
+import Foundation
+import CryptoKit
+
+/// Chunk transcripts on disk, so transcribing the same audio again only reruns the stages
+/// whose inputs changed.
+///
+/// An entry is keyed by a SHA-256 of the chunk's samples plus a fingerprint of everything
+/// that shapes the recognizer's output (model and its install date, backend, hotwords,
+/// routing). It holds the raw recognition: text before post-processing, CTC word timings
+/// and the language tag. Seam merging and post-processing run on top of it, so new word
+/// mappings rerun only post-processing while a new model or hotword list misses.
+///
+/// One small JSON file per entry. The total is kept under `maxBytes` by evicting the least
+/// recently used entries; hits bump the file's modification date, so the order survives
+/// restarts.
+final class TranscriptCache {
+    struct Stats {
+        var hits = 0
+        var misses = 0
+        var evictions = 0
+        var entries = 0
+        var bytes = 0
+
+        var hitRate: Double {
+            hits + misses == 0 ? 0 : Double(hits) / Double(hits + misses)
+        }
+    }
+
+    private struct Entry: Codable {
+        let text: String
+        let words: [TimedWord]
+        let language: String?
+        let languageProbability: Float?
+    }
+
+    static var defaultDirectory: URL {
+        let appSupport = FileManager.default.urls(for: .applicationSupportDirectory, in: .userDomainMask).first!
+        return appSupport.appendingPathComponent("Voca/transcripts")
+    }
+
+    let directory: URL
+    var maxBytes: Int {
+        get { locked { limit } }
+        set { locked { limit = newValue; evict() } }
+    }
+
+    private let lock = NSLock()
+    private var limit: Int
+    private var index: [String: (bytes: Int, lastUsed: Date)] = [:]
+    private var totalBytes = 0
+    private var counters = Stats()
+
+    init(directory: URL = defaultDirectory, maxBytes: Int = 64 << 20) {
+        self.directory = directory
+        self.limit = maxBytes
+        try? FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+
+        let keys: [URLResourceKey] = [.fileSizeKey, .contentModificationDateKey]
+        let files = (try? FileManager.default.contentsOfDirectory(at: directory, includingPropertiesForKeys: keys)) ?? []
+        for file in files where file.pathExtension == "json" {
+            let values = try? file.resourceValues(forKeys: Set(keys))
+            let bytes = values?.fileSize ?? 0
+            index[file.deletingPathExtension().lastPathComponent] = (bytes, values?.contentModificationDate ?? .distantPast)
+            totalBytes += bytes
+        }
+        locked { evict() }
+    }
+
+    /// Samples as a 16-bit PCM file reads them back. History stores recordings that way, so
+    /// audio quantized before transcription hashes the same when its recording is re-read.
+    static func quantized(_ samples: [Float]) -> [Float] {
+        samples.map { min(max(($0 * 32768).rounded(), -32768), 32767) / 32768 }
+    }
+
+    /// Cache key for a chunk of 16kHz samples transcribed under `configuration`
+    static func key(_ samples: ArraySlice<Float>, configuration: String) -> String {
+        var hasher = SHA256()
+        samples.withUnsafeBytes { hasher.update(bufferPointer: $0) }
+        hasher.update(data: Data(configuration.utf8))
+        return hasher.finalize().map { String(format: "%02x", $0) }.joined()
+    }
+
+    var stats: Stats {
+        locked {
+            var stats = counters
+            stats.entries = index.count
+            stats.bytes = totalBytes
+            return stats
+        }
+    }
+
+    func transcript(for key: String) -> TimedTranscript? {
+        locked {
+            guard index[key] != nil else {
+                counters.misses += 1
+                return nil
+            }
+            let url = fileURL(for: key)
+            guard let data = try? Data(contentsOf: url), let entry = try? JSONDecoder().decode(Entry.self, from: data) else {
+                remove(key)
+                counters.misses += 1
+                return nil
+            }
+            let now = Date()
+            try? FileManager.default.setAttributes([.modificationDate: now], ofItemAtPath: url.path)
+            index[key]?.lastUsed = now
+            counters.hits += 1
+
+            let language = entry.language.map { DetectedLanguage(code: $0, probability: entry.languageProbability ?? 1) }
+            return TimedTranscript(text: entry.text, words: entry.words, language: language)
+        }
+    }
+
+    func store(_ transcript: TimedTranscript, for key: String) {
+        let entry = Entry(text: transcript.text, words: transcript.words, language: transcript.language?.code,
+                          languageProbability: transcript.language?.probability)
+        guard let data = try? JSONEncoder().encode(entry) else { return }
+        locked {
+            guard (try? data.write(to: fileURL(for: key), options: .atomic)) != nil else { return }
+            totalBytes += data.count - (index[key]?.bytes ?? 0)
+            index[key] = (data.count, Date())
+            evict()
+        }
+    }
+
+    func removeAll() {
+        locked {
+            for key in Array(index.keys) {
+                remove(key)
+            }
+            counters = Stats()
+        }
+    }
+
+    // MARK: - Storage
+
+    private func fileURL(for key: String) -> URL {
+        directory.appendingPathComponent("\(key).json")
+    }
+
+    /// Drop least recently used entries until the total fits (holding the lock)
+    private func evict() {
+        guard totalBytes > limit else { return }
+        for (key, _) in index.sorted(by: { $0.value.lastUsed < $1.value.lastUsed }) where totalBytes > limit {
+            remove(key)
+            counters.evictions += 1
+        }
+    }
+
+    private func remove(_ key: String) {
+        guard let entry = index.removeValue(forKey: key) else { return }
+        totalBytes -= entry.bytes
+        try? FileManager.default.removeItem(at: fileURL(for: key))
+    }
+
+    private func locked<T>(_ body: () -> T) -> T {
+        lock.lock()
+        defer { lock.unlock() }
+        return body()
+    }
+}
@@ -0,0 +1,78 @@
+import Foundation
+
+/// One session with a `TranscriptionServer`: stream audio in with `send`, receive segment
+/// results as they complete (on the client's reader thread), then `finish` for the whole
+/// transcript.
+final class TranscriptionClient {
+    enum ClientError: LocalizedError {
+        case unreachable(String)
+        case refused(String)
+        case disconnected
+
+        var errorDescription: String? {
+            switch self {
+            case .unreachable(let path): return "No transcription server at \(path)"
+            case .refused(let reason): return "Session refused: \(reason)"
+            case .disconnected: return "Connection closed by the server"
+            }
+        }
+    }
+
+    private let socket: FrameSocket
+    private let done = DispatchSemaphore(value: 0)
+    private var transcript: TranscriptionProtocol.Result?
+
+    /// Open a session; throws `refused` when the server's admission control turns it away
+    init(path: String, onResult: @escaping (TranscriptionProtocol.Result) -> Void) throws {
+        guard let socket = FrameSocket.connect(path: path) else {
+            throw ClientError.unreachable(path)
+        }
+        guard socket.send(.start), let reply = socket.receive() else {
+            throw ClientError.disconnected
+        }
+        switch reply.kind {
+        case .accepted:
+            break
+        case .error:
+            let failure = try? JSONDecoder().decode(TranscriptionProtocol.Failure.self, from: reply.payload)
+            throw ClientError.refused(failure?.reason ?? "unknown")
+        default:
+            throw ClientError.disconnected
+        }
+        self.socket = socket
+
+        Thread { [self] in
+            defer { done.signal() }
+            let decoder = JSONDecoder()
+            while let frame = socket.receive() {
+                guard let result = try? decoder.decode(TranscriptionProtocol.Result.self, from: frame.payload) else {
+                    return
+                }
+                switch frame.kind {
+                case .result:
+                    onResult(result)
+                case .final:
+                    transcript = result
+                    return
+                default:
+                    return
+                }
+            }
+        }.start()
+    }
+
+    /// Stream 16kHz mono samples; false once the connection is gone
+    func send(_ samples: [Float]) -> Bool {
+        socket.send(samples: samples)
+    }
+
+    /// End the stream and wait for the session's transcript; nil if the connection dropped
+    /// or `timeout` passed
+    func finish(timeout: TimeInterval = 60) -> TranscriptionProtocol.Result? {
+        guard socket.send(.end), done.wait(timeout: .now() + timeout) == .success else {
+            socket.shutdown()
+            return nil
+        }
+        return transcript
+    }
+}
@@ -0,0 +1,169 @@
+import Foundation
+
+/// Wire protocol of `TranscriptionServer` over a Unix domain stream socket.
+///
+/// Every message is a frame: payload length (UInt32, little-endian), a one-byte `Kind`, then
+/// the payload. One connection is one session:
+///
+///     client: start, audio…, end
+///     server: accepted (or error), result… (one per speech segment, in order), final
+///
+/// Audio payloads are 16kHz mono Float32 (little-endian) of any length; results and errors
+/// are JSON. The server closes the connection after `final` or `error`.
+enum TranscriptionProtocol {
+    enum Kind: UInt8 {
+        case start = 1, audio, end
+        case accepted, result, final, error
+    }
+
+    /// A speech segment's transcription, or for `final` the whole session's (post-processed)
+    struct Result: Codable {
+        /// Segment number within the session; for `final`, the number of segments
+        let segment: Int
+        let text: String
+        /// Seconds from the start of the stream
+        let start: TimeInterval
+        let end: TimeInterval
+        /// Model time for the segment (summed over the session for `final`)
+        let modelTime: TimeInterval
+        let words: [TimedWord]
+    }
+
+    struct Failure: Codable {
+        let reason: String
+    }
+
+    static let sampleRate = 16000
+    /// Larger frames are a protocol error (16 s of audio)
+    static let maxPayload = 1 << 20
+}
+
+/// A connected socket carrying `TranscriptionProtocol` frames. Reads and writes block;
+/// writes are serialized so several threads can send on one socket.
+final class FrameSocket {
+    typealias Kind = TranscriptionProtocol.Kind
+
+    private let fd: Int32
+    private let writeLock = NSLock()
+
+    init(fd: Int32) {
+        self.fd = fd
+        // A peer that went away fails the write instead of raising SIGPIPE
+        var on: Int32 = 1
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, socklen_t(MemoryLayout<Int32>.size))
+    }
+
+    deinit {
+        close(fd)
+    }
+
+    /// Connect to a server listening at `path`
+    static func connect(path: String) -> FrameSocket? {
+        guard var address = address(path) else { return nil }
+        let fd = socket(AF_UNIX, SOCK_STREAM, 0)
+        guard fd >= 0 else { return nil }
+        let result = withUnsafePointer(to: &address) {
+            $0.withMemoryRebound(to: sockaddr.self, capacity: 1) {
+                Darwin.connect(fd, $0, socklen_t(MemoryLayout<sockaddr_un>.size))
+            }
+        }
+        guard result == 0 else {
+            close(fd)
+            return nil
+        }
+        return FrameSocket(fd: fd)
+    }
+
+    /// `sockaddr_un` for a socket path; nil if the path is too long
+    static func address(_ path: String) -> sockaddr_un? {
+        var address = sockaddr_un()
+        address.sun_family = sa_family_t(AF_UNIX)
+        let bytes = Array(path.utf8)
+        guard bytes.count < MemoryLayout.size(ofValue: address.sun_path) else { return nil }
+        withUnsafeMutableBytes(of: &address.sun_path) { $0.copyBytes(from: bytes) }
+        return address
+    }
+
+    // MARK: - Frames
+
+    @discardableResult
+    func send(_ kind: Kind, _ payload: Data = Data()) -> Bool {
+        payload.withUnsafeBytes { send(kind, bytes: $0) }
+    }
+
+    @discardableResult
+    func send<T: Encodable>(_ kind: Kind, json value: T) -> Bool {
+        guard let payload = try? JSONEncoder().encode(value) else { return false }
+        return send(kind, payload)
+    }
+
+    /// Send 16kHz mono samples as one `audio` frame
+    @discardableResult
+    func send(samples: [Float]) -> Bool {
+        samples.withUnsafeBytes { send(.audio, bytes: $0) }
+    }
+
+    /// Next frame; nil when the peer closed the connection or broke the protocol
+    func receive() -> (kind: Kind, payload: Data)? {
+        var header = [UInt8](repeating: 0, count: 5)
+        guard header.withUnsafeMutableBytes({ readAll($0) }) else { return nil }
+        let length = Int(header[0]) | Int(header[1]) << 8 | Int(header[2]) << 16 | Int(header[3]) << 24
+        guard let kind = Kind(rawValue: header[4]), length <= TranscriptionProtocol.maxPayload else { return nil }
+
+        var payload = Data(count: length)
+        guard length == 0 || payload.withUnsafeMutableBytes({ readAll($0) }) else { return nil }
+        return (kind, payload)
+    }
+
+    /// Fail a write that cannot make progress for `seconds` (the peer stopped reading)
+    func setSendTimeout(_ seconds: TimeInterval) {
+        var timeout = timeval(tv_sec: Int(seconds), tv_usec: Int32((seconds - seconds.rounded(.down)) * 1_000_000))
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, socklen_t(MemoryLayout<timeval>.size))
+    }
+
+    /// Wake a thread blocked in `receive` and fail further I/O
+    func shutdown() {
+        _ = Darwin.shutdown(fd, SHUT_RDWR)
+    }
+
+    /// Samples of an `audio` payload
+    static func samples(_ payload: Data) -> [Float] {
+        [Float](unsafeUninitializedCapacity: payload.count / MemoryLayout<Float>.size) { buffer, count in
+            count = buffer.count
+            _ = payload.copyBytes(to: buffer)
+        }
+    }
+
+    // MARK: - I/O
+
+    private func send(_ kind: Kind, bytes: UnsafeRawBufferPointer) -> Bool {
+        let length = UInt32(bytes.count)
+        let header: [UInt8] = [UInt8(length & 0xFF), UInt8(length >> 8 & 0xFF), UInt8(length >> 16 & 0xFF),
+                               UInt8(length >> 24), kind.rawValue]
+        writeLock.lock()
+        defer { writeLock.unlock() }
+        return header.withUnsafeBytes { writeAll($0) } && writeAll(bytes)
+    }
+
+    private func writeAll(_ bytes: UnsafeRawBufferPointer) -> Bool {
+        var offset = 0
+        while offset < bytes.count {
+            let written = write(fd, bytes.baseAddress! + offset, bytes.count - offset)
+            if written < 0 && errno == EINTR { continue }
+            guard written > 0 else { return false }
+            offset += written
+        }
+        return true
+    }
+
+    private func readAll(_ bytes: UnsafeMutableRawBufferPointer) -> Bool {
+        var offset = 0
+        while offset < bytes.count {
+            let count = read(fd, bytes.baseAddress! + offset, bytes.count - offset)
+            if count < 0 && errno == EINTR { continue }
+            guard count > 0 else { return false }
+            offset += count
+        }
+        return true
+    }
+}
@@ -0,0 +1,396 @@
+import Foundation
+
+/// Local transcription daemon (`Voca --serve <socket>`): loads the models once and serves
+/// any number of tools over a Unix domain socket, speaking `TranscriptionProtocol`.
+///
+/// - Sessions are isolated: each connection has its own reader thread, writer queue, speech
+///   segmenter and post-processor, and receives its segment results in order. The batch
+///   worker never touches a client socket, and a client that stops reading is dropped
+///   after `sendTimeout` instead of stalling everyone else.
+/// - Micro-batching: segments from all sessions share one queue. The worker takes up to
+///   `maxBatch` at a time and runs them as one `Transcriber.transcribeBatch` call. When the
+///   engine runs several utterances at once it waits `batchWindow` after the first for
+///   others to join; with one session waiting would only add latency.
+/// - Admission control: beyond `maxSessions`, or while more than `maxBacklogSeconds` of
+///   audio is waiting for the model, new sessions are refused. A session with
+///   `maxPendingPerSession` segments in flight is not read until one finishes, so a sender
+///   faster than the model is held back by the socket instead of growing the queue.
+final class TranscriptionServer {
+    struct Limits {
+        var maxSessions = 64
+        var maxBacklogSeconds: Double = 120
+        var maxPendingPerSession = 4
+        var maxBatch = 8
+        /// How long the first queued segment waits for company (0: never waits)
+        var batchWindow: TimeInterval = 0.01
+        /// A session whose client accepts nothing for this long is dropped
+        var sendTimeout: TimeInterval = 10
+    }
+
+    struct Stats {
+        var accepted = 0
+        var refused = 0
+        /// Batches whose segments ran concurrently, and the segments in them
+        var batches = 0
+        var batchedSegments = 0
+
+        var meanBatchSize: Double {
+            batches == 0 ? 0 : Double(batchedSegments) / Double(batches)
+        }
+    }
+
+    let path: String
+    let limits: Limits
+
+    var stats: Stats {
+        lock.lock()
+        defer { lock.unlock() }
+        return counters
+    }
+
+    private struct Job {
+        let samples: [Float]
+        let completion: (TranscriptionResult) -> Void
+    }
+
+    private let transcriber: Transcriber
+    private let models: ModelRegistry
+    private var listener: Int32 = -1
+    private var running = false
+
+    /// Guards sessions, counters and the backlog; `queue` has its own condition
+    private let lock = NSLock()
+    private var sessions: [ObjectIdentifier: Session] = [:]
+    private var counters = Stats()
+    private var backlogSamples = 0
+
+    private let queueCondition = NSCondition()
+    private var queue: [Job] = []
+
+    init(path: String, transcriber: Transcriber, models: ModelRegistry, limits: Limits = Limits()) {
+        self.path = path
+        self.transcriber = transcriber
+        self.models = models
+        self.limits = limits
+    }
+
+    /// `--serve <socket> [--max-sessions N]`: start the daemon if requested
+    static func startFromArguments(modelDir: String, assetsDir: String) -> TranscriptionServer? {
+        let arguments = ProcessInfo.processInfo.arguments
+        guard let index = arguments.firstIndex(of: "--serve"), index + 1 < arguments.count else { return nil }
+        var limits = Limits()
+        if let flag = arguments.firstIndex(of: "--max-sessions"), flag + 1 < arguments.count,
+           let value = Int(arguments[flag + 1]) {
+            limits.maxSessions = max(value, 1)
+        }
+
+        let models = ModelRegistry(modelDir: modelDir, assetsDir: assetsDir, initial: AppSettings.shared.selectedModel)
+        let server = TranscriptionServer(path: arguments[index + 1], transcriber: Transcriber(models: models),
+                                         models: models, limits: limits)
+        // Load before accepting so the first session doesn't pay for it
+        guard models.recognizer() != nil else {
+            print("✗ Server: no ASR model could be loaded")
+            return nil
+        }
+        return server.start() ? server : nil
+    }
+
+    /// Listen on `path` (replacing a stale socket file); returns false if that fails
+    func start() -> Bool {
+        guard var address = FrameSocket.address(path) else {
+            print("✗ Server: socket path too long: \(path)")
+            return false
+        }
+        unlink(path)
+        listener = socket(AF_UNIX, SOCK_STREAM, 0)
+        let bound = withUnsafePointer(to: &address) {
+            $0.withMemoryRebound(to: sockaddr.self, capacity: 1) {
+                bind(listener, $0, socklen_t(MemoryLayout<sockaddr_un>.size))
+            }
+        }
+        guard listener >= 0, bound == 0, listen(listener, 128) == 0 else {
+            print("✗ Server: cannot listen on \(path): \(String(cString: strerror(errno)))")
+            if listener >= 0 { close(listener) }
+            listener = -1
+            return false
+        }
+
+        running = true
+        Thread { [self] in acceptLoop() }.start()
+        Thread { [self] in batchLoop() }.start()
+        print("✓ Server: listening on \(path) (up to \(limits.maxSessions) sessions)")
+        return true
+    }
+
+    func stop() {
+        guard running else { return }
+        running = false
+        // A connection of our own wakes the blocked accept
+        _ = FrameSocket.connect(path: path)
+        close(listener)
+        unlink(path)
+
+        lock.lock()
+        sessions.values.forEach { $0.socket.shutdown() }
+        lock.unlock()
+        queueCondition.lock()
+        queueCondition.broadcast()
+        queueCondition.unlock()
+    }
+
+    // MARK: - Sessions
+
+    private func acceptLoop() {
+        while running {
+            let fd = accept(listener, nil, nil)
+            guard running else {
+                if fd >= 0 { close(fd) }
+                break
+            }
+            guard fd >= 0 else { continue }
+            let socket = FrameSocket(fd: fd)
+            socket.setSendTimeout(limits.sendTimeout)
+            Thread { [self] in serve(socket) }.start()
+        }
+    }
+
+    /// One session, on its own thread, from `start` to `final`
+    private func serve(_ socket: FrameSocket) {
+        guard let hello = socket.receive(), hello.kind == .start else { return }
+        guard let session = admit(socket) else { return }
+        defer { release(session) }
+        socket.send(.accepted)
+
+        while let frame = socket.receive() {
+            switch frame.kind {
+            case .audio:
+                for segment in session.append(FrameSocket.samples(frame.payload)) {
+                    submit(segment, for: session)
+                }
+            case .end:
+                if let segment = session.finish() {
+                    submit(segment, for: session)
+                }
+                session.inFlight.wait()
+                session.sendFinal()
+                return
+            default:
+                socket.send(.error, json: TranscriptionProtocol.Failure(reason: "unexpected \(frame.kind)"))
+                return
+            }
+        }
+        // Disconnected: results still in flight are dropped when their send fails
+    }
+
+    private func admit(_ socket: FrameSocket) -> Session? {
+        lock.lock()
+        let backlog = Double(backlogSamples) / Double(TranscriptionProtocol.sampleRate)
+        var reason: String?
+        if sessions.count >= limits.maxSessions {
+            reason = "busy: \(sessions.count) sessions"
+        } else if backlog > limits.maxBacklogSeconds {
+            reason = "busy: \(Int(backlog)) s of audio queued"
+        }
+        let session = reason == nil ? Session(socket: socket, maxPending: limits.maxPendingPerSession) : nil
+        if let session = session {
+            sessions[ObjectIdentifier(session)] = session
+            counters.accepted += 1
+        } else {
+            counters.refused += 1
+        }
+        lock.unlock()
+
+        if let reason = reason {
+            socket.send(.error, json: TranscriptionProtocol.Failure(reason: reason))
+        }
+        return session
+    }
+
+    private func release(_ session: Session) {
+        lock.lock()
+        sessions.removeValue(forKey: ObjectIdentifier(session))
+        lock.unlock()
+    }
+
+    /// Queue a segment for the model; blocks while the session has too many in flight
+    private func submit(_ segment: Session.Pending, for session: Session) {
+        session.slots.wait()
+        session.inFlight.enter()
+        let count = segment.samples.count
+        lock.lock()
+        backlogSamples += count
+        lock.unlock()
+
+        enqueue(Job(samples: segment.samples) { result in
+            self.lock.lock()
+            self.backlogSamples -= count
+            self.lock.unlock()
+            session.deliver(segment, result: result)
+            session.slots.signal()
+            session.inFlight.leave()
+        })
+    }
+
+    // MARK: - Batching
+
+    private func enqueue(_ job: Job) {
+        queueCondition.lock()
+        queue.append(job)
+        queueCondition.signal()
+        queueCondition.unlock()
+    }
+
+    private func batchLoop() {
+        while true {
+            queueCondition.lock()
+            while queue.isEmpty && running {
+                queueCondition.wait()
+            }
+            // Give other sessions' segments a moment to join this batch, if they can run with it
+            let concurrency = transcriber.batchConcurrency
+            if concurrency > 1 {
+                let deadline = Date(timeIntervalSinceNow: limits.batchWindow)
+                while queue.count < limits.maxBatch && running && queueCondition.wait(until: deadline) {}
+            }
+            let batch = Array(queue.prefix(limits.maxBatch))
+            queue.removeFirst(batch.count)
+            queueCondition.unlock()
+
+            guard running else {
+                batch.forEach { $0.completion(TranscriptionResult(text: nil, modelTime: 0)) }
+                return
+            }
+
+            let results = transcriber.transcribeBatch(batch.map(\.samples))
+            if concurrency > 1 && batch.count > 1 {
+                lock.lock()
+                counters.batches += 1
+                counters.batchedSegments += batch.count
+                lock.unlock()
+            }
+            for (job, result) in zip(batch, results) {
+                job.completion(result)
+            }
+            models.collectGarbage()
+        }
+    }
+}
+
+// MARK: - Session
+
+/// Per-connection state; `deliver` may run on the batch worker while the reader thread
+/// appends audio. Frames go out on the session's own serial writer queue.
+private final class Session {
+    struct Pending {
+        let index: Int
+        let segment: SpeechSegmenter.Segment
+        var samples: [Float] { segment.samples }
+    }
+
+    /// Segmenter blocks (100 ms), matching the RMS granularity of live capture
+    static let blockSize = TranscriptionProtocol.sampleRate / 10
+
+    let socket: FrameSocket
+    let slots: DispatchSemaphore
+    let inFlight = DispatchGroup()
+    private let writer = DispatchQueue(label: "com.voca.server.session", qos: .userInitiated)
+
+    // Reader thread only
+    private var segmenter = SpeechSegmenter()
+    private var block: [Float] = []
+    private var received = 0
+    private var segments = 0
+
+    // Under `lock`
+    private let lock = NSLock()
+    private var nextToSend = 0
+    private var completed: [Int: TranscriptionProtocol.Result] = [:]
+    private let text = TextPostProcessor()
+    private var words: [TimedWord] = []
+    private var modelTime: TimeInterval = 0
+
+    // Writer queue only: a send failed (client gone or not reading), nothing more is sent
+    private var dropped = false
+
+    init(socket: FrameSocket, maxPending: Int) {
+        self.socket = socket
+        self.slots = DispatchSemaphore(value: maxPending)
+        block.reserveCapacity(Self.blockSize)
+    }
+
+    /// Feed received audio; returns the segments it completed
+    func append(_ samples: [Float]) -> [Pending] {
+        received += samples.count
+        var finished: [Pending] = []
+        var offset = 0
+        while offset < samples.count {
+            let take = min(Self.blockSize - block.count, samples.count - offset)
+            block.append(contentsOf: samples[offset..<(offset + take)])
+            offset += take
+            guard block.count == Self.blockSize else { continue }
+
+            let rms = (block.reduce(0) { $0 + $1 * $1 } / Float(block.count)).squareRoot()
+            if let segment = segmenter.append(block, rms: rms) {
+                finished.append(Pending(index: segments, segment: segment))
+                segments += 1
+            }
+            block.removeAll(keepingCapacity: true)
+        }
+        return finished
+    }
+
+    /// The last segment at the end of the stream, if there is speech left
+    func finish() -> Pending? {
+        guard let segment = segmenter.finish(tail: block) else { return nil }
+        block.removeAll()
+        segments += 1
+        return Pending(index: segments - 1, segment: segment)
+    }
+
+    /// Record a segment's transcription and send every result now due, in segment order
+    func deliver(_ pending: Pending, result: TranscriptionResult) {
+        let sampleRate = Double(TranscriptionProtocol.sampleRate)
+        let start = Double(pending.segment.start) / sampleRate
+        let segmentWords = WordTiming.shift(result.words, by: start)
+
+        lock.lock()
+        defer { lock.unlock() }
+        completed[pending.index] = TranscriptionProtocol.Result(
+            segment: pending.index, text: result.text ?? "", start: start,
+            end: start + Double(pending.samples.count) / sampleRate, modelTime: result.modelTime, words: segmentWords
+        )
+        while let due = completed.removeValue(forKey: nextToSend) {
+            if !due.text.isEmpty {
+                text.append(due.text)
+            }
+            words += due.words
+            modelTime += due.modelTime
+            // Queued under the lock, so results leave in segment order
+            writer.async { self.send(.result, due) }
+            nextToSend += 1
+        }
+    }
+
+    /// The whole session's transcript; call once every segment has been delivered
+    func sendFinal() {
+        lock.lock()
+        let final = TranscriptionProtocol.Result(
+            segment: segments, text: text.text, start: 0,
+            end: Double(received) / Double(TranscriptionProtocol.sampleRate), modelTime: modelTime, words: words
+        )
+        lock.unlock()
+        // After every queued result; waits so the frame is out before the session ends
+        writer.sync { send(.final, final) }
+    }
+
+    /// Send one frame on the writer queue; a failure (including `SO_SNDTIMEO`) drops the
+    /// session, which also wakes its reader thread
+    private func send(_ kind: FrameSocket.Kind, _ result: TranscriptionProtocol.Result) {
+        guard !dropped else { return }
+        if !socket.send(kind, json: result) {
+            dropped = true
+            socket.shutdown()
+            print("⚠️ Server: dropped a session (client gone or not reading)")
+        }
+    }
+}
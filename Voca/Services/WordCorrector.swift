@@ -0,0 +1,600 @@
+import Foundation
+
+/// Post-transcription corrections: exact word mappings plus phonetic near-misses.
+///
+/// The mappings and custom words compile into a `CorrectionRules` set (an Aho–Corasick
+/// automaton over case-folded scalars for the exact `find` strings, plus Metaphone and
+/// pinyin key indexes for near-misses), which is only rebuilt when the settings change.
+/// Applying the rules is one scan over the segment, however many there are.
+final class WordCorrector {
+    static let shared = WordCorrector()
+
+    private let lock = NSLock()
+    private var rules = CorrectionRules(mappings: [], customWords: [])
+    private var mappings: [WordMapping] = []
+    private var customWords: [String] = []
+    /// Rules compiled from settings; dropped when the word lists change, so segments
+    /// neither re-read nor compare them
+    private var settingsRules: CorrectionRules?
+
+    init() {
+        NotificationCenter.default.addObserver(forName: .wordListsChanged, object: nil, queue: nil) { [weak self] _ in
+            guard let self = self else { return }
+            self.lock.lock()
+            self.settingsRules = nil
+            self.lock.unlock()
+        }
+    }
+
+    /// Apply the word mappings and custom words from settings
+    func apply(_ text: String) -> String {
+        lock.lock()
+        if settingsRules == nil {
+            settingsRules = compile(mappings: AppSettings.shared.wordMappings, customWords: AppSettings.shared.customWords)
+        }
+        let rules = settingsRules!
+        lock.unlock()
+        return rules.apply(text)
+    }
+
+    func apply(_ text: String, mappings: [WordMapping], customWords: [String]) -> String {
+        rules(mappings: mappings, customWords: customWords).apply(text)
+    }
+
+    /// Compiled rules for a configuration, cached until it changes
+    func rules(mappings: [WordMapping], customWords: [String]) -> CorrectionRules {
+        lock.lock()
+        defer { lock.unlock() }
+
+        if mappings != self.mappings || customWords != self.customWords {
+            rules = compile(mappings: mappings, customWords: customWords)
+            self.mappings = mappings
+            self.customWords = customWords
+        }
+        return rules
+    }
+
+    private func compile(mappings: [WordMapping], customWords: [String]) -> CorrectionRules {
+        let start = Date()
+        let rules = CorrectionRules(mappings: mappings, customWords: customWords)
+        print("📝 Corrections: \(mappings.count) mappings, \(customWords.count) words compiled in \(Int(Date().timeIntervalSince(start) * 1000))ms")
+        return rules
+    }
+}
+
+// MARK: - Rules
+
+/// An immutable, compiled rule set
+final class CorrectionRules {
+    /// Longest run of words a phonetic match may span ("chat gpt" → "ChatGPT")
+    private static let maxPhoneticWords = 3
+    /// Shortest Han spelling matched by sound. Fuzzy toneless keys collide too often for
+    /// single characters (王 would rewrite 万/完/晚/网), so those stay exact-only.
+    private static let minHanPhoneticLength = 2
+
+    private struct LatinTarget {
+        let text: String
+        let letters: [UInt8]
+    }
+
+    private let automaton: AhoCorasick
+    private let replacements: [String]
+    private var latinIndex: [[UInt8]: LatinTarget] = [:]
+    private var hanIndex: [String: String] = [:]
+    private var hanLengths: [Int] = []
+
+    var isEmpty: Bool { replacements.isEmpty && latinIndex.isEmpty && hanIndex.isEmpty }
+
+    init(mappings: [WordMapping], customWords: [String]) {
+        var automaton = AhoCorasick()
+        var replacements: [String] = []
+        for mapping in mappings {
+            if automaton.insert(Self.folded(mapping.find), rule: Int32(replacements.count)) {
+                replacements.append(mapping.replace)
+            }
+        }
+        automaton.build()
+        self.automaton = automaton
+        self.replacements = replacements
+
+        // Phonetic index: both spellings of a mapping point at its replacement; custom
+        // words point at themselves. Earlier entries win key collisions.
+        let targets = mappings.flatMap { [($0.find, $0.replace), ($0.replace, $0.replace)] }
+            + customWords.map { ($0, $0) }
+        var lengths = Set<Int>()
+        for (spelling, target) in targets {
+            let scalars = Array(spelling.unicodeScalars).filter { !$0.properties.isWhitespace }
+            if !scalars.isEmpty && scalars.allSatisfy({ $0.isHan }) {
+                guard scalars.count >= Self.minHanPhoneticLength else { continue }
+                let key = Pinyin.key(scalars[...])
+                if hanIndex[key] == nil {
+                    hanIndex[key] = target
+                    lengths.insert(scalars.count)
+                }
+            } else if !scalars.contains(where: { $0.isHan }) {
+                let letters = Self.asciiLetters(scalars[...])
+                let key = Metaphone.encode(letters)
+                guard letters.count >= 3, key.count >= 2, latinIndex[key] == nil else { continue }
+                latinIndex[key] = LatinTarget(text: target, letters: Self.asciiLetters(Array(target.unicodeScalars)[...]))
+            }
+        }
+        hanLengths = lengths.sorted(by: >)
+    }
+
+    private struct Edit {
+        let range: Range<Int>
+        let replacement: String
+    }
+
+    func apply(_ text: String) -> String {
+        guard !isEmpty else { return text }
+        let scalars = Array(text.unicodeScalars)
+
+        // One scan: drive the automaton and collect Latin words and Han runs
+        var exact: [Edit] = []
+        var words: [Range<Int>] = []
+        var hanRuns: [Range<Int>] = []
+        var state = AhoCorasick.root
+        var wordStart = -1
+        var hanStart = -1
+
+        for (i, scalar) in scalars.enumerated() {
+            state = automaton.step(state, Self.fold(scalar))
+            automaton.forEachMatch(at: state) { rule, length in
+                let start = i + 1 - length
+                if isBoundary(scalars, before: start) && isBoundary(scalars, after: i + 1) {
+                    exact.append(Edit(range: start..<(i + 1), replacement: replacements[Int(rule)]))
+                }
+            }
+
+            if scalar.isLatinWordScalar {
+                if wordStart < 0 { wordStart = i }
+            } else if wordStart >= 0 {
+                words.append(wordStart..<i)
+                wordStart = -1
+            }
+            if scalar.isHan {
+                if hanStart < 0 { hanStart = i }
+            } else if hanStart >= 0 {
+                hanRuns.append(hanStart..<i)
+                hanStart = -1
+            }
+        }
+        if wordStart >= 0 { words.append(wordStart..<scalars.count) }
+        if hanStart >= 0 { hanRuns.append(hanStart..<scalars.count) }
+
+        // Exact matches: leftmost, then longest
+        exact.sort { $0.range.lowerBound != $1.range.lowerBound
+            ? $0.range.lowerBound < $1.range.lowerBound
+            : $0.range.count > $1.range.count }
+        var edits: [Edit] = []
+        var covered = [Bool](repeating: false, count: scalars.count)
+        var end = 0
+        for edit in exact where edit.range.lowerBound >= end {
+            edits.append(edit)
+            end = edit.range.upperBound
+            for i in edit.range { covered[i] = true }
+        }
+
+        matchLatin(scalars, words: words, covered: covered, into: &edits)
+        matchHan(scalars, runs: hanRuns, covered: covered, into: &edits)
+        guard !edits.isEmpty else { return text }
+
+        edits.sort { $0.range.lowerBound < $1.range.lowerBound }
+        var output = String.UnicodeScalarView()
+        var position = 0
+        for edit in edits {
+            output.append(contentsOf: scalars[position..<edit.range.lowerBound])
+            output.append(contentsOf: edit.replacement.unicodeScalars)
+            position = edit.range.upperBound
+        }
+        output.append(contentsOf: scalars[position...])
+        return String(output)
+    }
+
+    // MARK: Phonetic matching
+
+    /// Replace runs of 1-3 space-separated words whose Metaphone key matches a target, if
+    /// the spelling is also close (keys alone over-match, e.g. "call it" vs "Claude") and
+    /// the words aren't all real ones ("cloud" was heard right, not a misheard "Claude")
+    private func matchLatin(_ scalars: [Unicode.Scalar], words: [Range<Int>], covered: [Bool], into edits: inout [Edit]) {
+        guard !latinIndex.isEmpty else { return }
+
+        var w = 0
+        while w < words.count {
+            var matched = 0
+            for count in stride(from: min(Self.maxPhoneticWords, words.count - w), through: 1, by: -1) {
+                let span = words[w].lowerBound..<words[w + count - 1].upperBound
+                let spacedOnly = (w..<(w + count - 1)).allSatisfy { k in
+                    scalars[words[k].upperBound..<words[k + 1].lowerBound].allSatisfy { $0 == " " }
+                }
+                guard spacedOnly, !span.contains(where: { covered[$0] }) else { continue }
+
+                let letters = Self.asciiLetters(scalars[span])
+                guard letters.count >= 3,
+                      let target = latinIndex[Metaphone.encode(letters)],
+                      !target.text.unicodeScalars.elementsEqual(scalars[span]),
+                      Self.editDistance(letters, target.letters) <= max(1, target.letters.count / 4),
+                      !(w..<(w + count)).allSatisfy({ CommonWords.contains(Self.asciiLetters(scalars[words[$0]])) }) else {
+                    continue
+                }
+                edits.append(Edit(range: span, replacement: target.text))
+                matched = count
+                break
+            }
+            w += max(matched, 1)
+        }
+    }
+
+    /// Replace Han windows (2+ characters) whose toneless (fuzzy) pinyin matches a target's
+    private func matchHan(_ scalars: [Unicode.Scalar], runs: [Range<Int>], covered: [Bool], into edits: inout [Edit]) {
+        guard !hanIndex.isEmpty else { return }
+
+        for run in runs {
+            var i = run.lowerBound
+            while i < run.upperBound {
+                var matched = 0
+                for length in hanLengths where i + length <= run.upperBound {
+                    let window = i..<(i + length)
+                    guard !window.contains(where: { covered[$0] }),
+                          let target = hanIndex[Pinyin.key(scalars[window])],
+                          !target.unicodeScalars.elementsEqual(scalars[window]) else {
+                        continue
+                    }
+                    edits.append(Edit(range: window, replacement: target))
+                    matched = length
+                    break
+                }
+                i += max(matched, 1)
+            }
+        }
+    }
+
+    // MARK: Helpers
+
+    /// Exact matches of Latin patterns must start and end on word boundaries
+    private func isBoundary(_ scalars: [Unicode.Scalar], before index: Int) -> Bool {
+        index == 0 || !(scalars[index - 1].isLatinWordScalar && scalars[index].isLatinWordScalar)
+    }
+
+    private func isBoundary(_ scalars: [Unicode.Scalar], after index: Int) -> Bool {
+        index == scalars.count || !(scalars[index - 1].isLatinWordScalar && scalars[index].isLatinWordScalar)
+    }
+
+    /// Simple case folding that keeps scalar offsets aligned with the original text
+    private static func fold(_ scalar: Unicode.Scalar) -> Unicode.Scalar {
+        if scalar.isASCII {
+            return (0x41...0x5A).contains(scalar.value) ? Unicode.Scalar(scalar.value + 0x20)! : scalar
+        }
+        let lower = scalar.properties.lowercaseMapping.unicodeScalars
+        return lower.count == 1 ? lower.first! : scalar
+    }
+
+    private static func folded(_ text: String) -> [Unicode.Scalar] {
+        text.unicodeScalars.map(fold)
+    }
+
+    /// Uppercase ASCII letters of a span (accents stripped), for Metaphone
+    private static func asciiLetters(_ scalars: ArraySlice<Unicode.Scalar>) -> [UInt8] {
+        var letters: [UInt8] = []
+        for scalar in scalars {
+            var value = scalar.value
+            if value >= 0xC0, let base = String(scalar).applyingTransform(.stripDiacritics, reverse: false)?.unicodeScalars.first {
+                value = base.value
+            }
+            switch value {
+            case 0x41...0x5A: letters.append(UInt8(value))
+            case 0x61...0x7A: letters.append(UInt8(value - 0x20))
+            default: break
+            }
+        }
+        return letters
+    }
+
+    private static func editDistance(_ a: [UInt8], _ b: [UInt8]) -> Int {
+        guard !a.isEmpty else { return b.count }
+        guard !b.isEmpty else { return a.count }
+
+        var previous = Array(0...b.count)
+        var current = previous
+        for i in 1...a.count {
+            current[0] = i
+            for j in 1...b.count {
+                current[j] = min(previous[j] + 1, current[j - 1] + 1, previous[j - 1] + (a[i - 1] == b[j - 1] ? 0 : 1))
+            }
+            swap(&previous, &current)
+        }
+        return previous[b.count]
+    }
+}
+
+private extension Unicode.Scalar {
+    /// Letter or digit of an alphabetic script (ASCII and Latin-1/Extended-A/B)
+    var isLatinWordScalar: Bool {
+        switch value {
+        case 0x30...0x39, 0x41...0x5A, 0x61...0x7A: return true
+        case 0xC0...0x24F: return value != 0xD7 && value != 0xF7
+        default: return false
+        }
+    }
+}
+
+// MARK: - Aho–Corasick
+
+/// Multi-pattern matcher over Unicode scalars
+struct AhoCorasick {
+    static let root: Int32 = 0
+
+    private var transitions: [UInt64: Int32] = [:]
+    private var edges: [[(scalar: UInt32, node: Int32)]] = [[]]
+    private var fail: [Int32] = [0]
+    /// Rule of the pattern ending exactly at a node (-1 if none)
+    private var output: [Int32] = [-1]
+    private var depth: [Int32] = [0]
+    /// Nearest node on the failure chain that has an output
+    private var outputLink: [Int32] = [-1]
+
+    /// Add a pattern; returns false if it is empty or already present
+    mutating func insert(_ pattern: [Unicode.Scalar], rule: Int32) -> Bool {
+        guard !pattern.isEmpty else { return false }
+        var node = Self.root
+        for scalar in pattern {
+            let key = Self.key(node, scalar.value)
+            if let next = transitions[key] {
+                node = next
+                continue
+            }
+            let next = Int32(fail.count)
+            transitions[key] = next
+            edges[Int(node)].append((scalar.value, next))
+            edges.append([])
+            fail.append(Self.root)
+            output.append(-1)
+            depth.append(depth[Int(node)] + 1)
+            outputLink.append(-1)
+            node = next
+        }
+        guard output[Int(node)] < 0 else { return false }
+        output[Int(node)] = rule
+        return true
+    }
+
+    /// Compute failure and output links (breadth-first)
+    mutating func build() {
+        var queue = edges[Int(Self.root)].map { $0.node }
+        var head = 0
+        while head < queue.count {
+            let node = queue[head]
+            head += 1
+            for (scalar, child) in edges[Int(node)] {
+                // Children of the root fail to the root; deeper nodes follow the parent's chain
+                var failNode = Self.root
+                if node != Self.root {
+                    var f = fail[Int(node)]
+                    while f != Self.root && transitions[Self.key(f, scalar)] == nil {
+                        f = fail[Int(f)]
+                    }
+                    failNode = transitions[Self.key(f, scalar)] ?? Self.root
+                }
+                fail[Int(child)] = failNode
+                outputLink[Int(child)] = output[Int(failNode)] >= 0 ? failNode : outputLink[Int(failNode)]
+                queue.append(child)
+            }
+        }
+    }
+
+    func step(_ state: Int32, _ scalar: Unicode.Scalar) -> Int32 {
+        var node = state
+        while true {
+            if let next = transitions[Self.key(node, scalar.value)] {
+                return next
+            }
+            if node == Self.root {
+                return Self.root
+            }
+            node = fail[Int(node)]
+        }
+    }
+
+    /// Every pattern ending at `state`, as (rule, length in scalars)
+    func forEachMatch(at state: Int32, _ body: (Int32, Int) -> Void) {
+        var node = output[Int(state)] >= 0 ? state : outputLink[Int(state)]
+        while node >= 0 {
+            body(output[Int(node)], Int(depth[Int(node)]))
+            node = outputLink[Int(node)]
+        }
+    }
+
+    private static func key(_ node: Int32, _ scalar: UInt32) -> UInt64 {
+        UInt64(UInt32(bitPattern: node)) << 32 | UInt64(scalar)
+    }
+}
+
+// MARK: - Common Words
+
+/// The system word list (`/usr/share/dict/words`) as sorted hashes of each word's letters,
+/// loaded on first use; empty if the list is missing
+enum CommonWords {
+    private static let hashes: [UInt64] = {
+        guard let data = FileManager.default.contents(atPath: "/usr/share/dict/words") else { return [] }
+        var hashes: [UInt64] = []
+        hashes.reserveCapacity(data.count / 8)
+        var hash = CommonWords.offsetBasis
+        var length = 0
+        for byte in data {
+            if byte == 0x0A {
+                if length > 0 { hashes.append(hash) }
+                hash = CommonWords.offsetBasis
+                length = 0
+            } else if let letter = CommonWords.uppercased(byte) {
+                hash = CommonWords.mix(hash, letter)
+                length += 1
+            }
+        }
+        if length > 0 { hashes.append(hash) }
+        hashes.sort()
+        return hashes
+    }()
+
+    private static let offsetBasis: UInt64 = 0xCBF2_9CE4_8422_2325
+
+    /// Whether uppercase ASCII `letters` spell a listed word (case-insensitive)
+    static func contains(_ letters: [UInt8]) -> Bool {
+        guard !letters.isEmpty else { return false }
+        let hash = letters.reduce(offsetBasis, mix)
+        var low = 0
+        var high = hashes.count
+        while low < high {
+            let middle = (low + high) / 2
+            if hashes[middle] < hash {
+                low = middle + 1
+            } else {
+                high = middle
+            }
+        }
+        return low < hashes.count && hashes[low] == hash
+    }
+
+    /// FNV-1a step
+    private static func mix(_ hash: UInt64, _ byte: UInt8) -> UInt64 {
+        (hash ^ UInt64(byte)) &* 0x100_0000_01B3
+    }
+
+    private static func uppercased(_ byte: UInt8) -> UInt8? {
+        switch byte {
+        case 0x41...0x5A: return byte
+        case 0x61...0x7A: return byte - 0x20
+        default: return nil
+        }
+    }
+}
+
+// MARK: - Phonetic Keys
+
+/// Original Metaphone (Lawrence Philips, 1990) over uppercase ASCII letters
+enum Metaphone {
+    private static let A = UInt8(ascii: "A"), B = UInt8(ascii: "B"), C = UInt8(ascii: "C")
+    private static let D = UInt8(ascii: "D"), E = UInt8(ascii: "E"), F = UInt8(ascii: "F")
+    private static let G = UInt8(ascii: "G"), H = UInt8(ascii: "H"), I = UInt8(ascii: "I")
+    private static let J = UInt8(ascii: "J"), K = UInt8(ascii: "K"), M = UInt8(ascii: "M")
+    private static let N = UInt8(ascii: "N"), O = UInt8(ascii: "O"), P = UInt8(ascii: "P")
+    private static let Q = UInt8(ascii: "Q"), R = UInt8(ascii: "R"), S = UInt8(ascii: "S")
+    private static let T = UInt8(ascii: "T"), U = UInt8(ascii: "U"), V = UInt8(ascii: "V")
+    private static let W = UInt8(ascii: "W"), X = UInt8(ascii: "X"), Y = UInt8(ascii: "Y")
+    private static let Z = UInt8(ascii: "Z"), theta = UInt8(ascii: "0")
+
+    static func encode(_ letters: [UInt8]) -> [UInt8] {
+        var word = letters
+        guard !word.isEmpty else { return [] }
+
+        // Initial exceptions
+        if word.count >= 2 {
+            switch (word[0], word[1]) {
+            case (A, E), (G, N), (K, N), (P, N), (W, R):
+                word.removeFirst()
+            case (W, H):
+                word.remove(at: 1)
+            default:
+                break
+            }
+        }
+        if word[0] == X {
+            word[0] = S
+        }
+
+        func at(_ i: Int) -> UInt8 { i >= 0 && i < word.count ? word[i] : 0 }
+        func isVowel(_ c: UInt8) -> Bool { c == A || c == E || c == I || c == O || c == U }
+        func isFront(_ c: UInt8) -> Bool { c == E || c == I || c == Y }
+
+        var key: [UInt8] = []
+        for i in 0..<word.count {
+            let c = word[i]
+            // Doubled letters count once, except C
+            if c != C && c == at(i - 1) { continue }
+
+            switch c {
+            case A, E, I, O, U:
+                if i == 0 { key.append(c) }
+            case B:
+                if !(i == word.count - 1 && at(i - 1) == M) { key.append(B) }
+            case C:
+                if at(i + 1) == I && at(i + 2) == A {
+                    key.append(X)
+                } else if at(i + 1) == H {
+                    key.append(at(i - 1) == S ? K : X)
+                } else if isFront(at(i + 1)) {
+                    if at(i - 1) != S { key.append(S) }
+                } else {
+                    key.append(K)
+                }
+            case D:
+                key.append(at(i + 1) == G && isFront(at(i + 2)) ? J : T)
+            case G:
+                if at(i + 1) == H && i + 2 < word.count && !isVowel(at(i + 2)) { continue }
+                if at(i + 1) == N && (i + 2 == word.count || (at(i + 2) == E && at(i + 3) == D && i + 4 == word.count)) { continue }
+                if at(i - 1) == D && isFront(at(i + 1)) { continue }
+                key.append(isFront(at(i + 1)) && at(i - 1) != G ? J : K)
+            case H:
+                if isVowel(at(i + 1)) && ![C, S, P, T, G].contains(at(i - 1)) { key.append(H) }
+            case K:
+                if at(i - 1) != C { key.append(K) }
+            case P:
+                key.append(at(i + 1) == H ? F : P)
+            case Q:
+                key.append(K)
+            case S:
+                key.append(at(i + 1) == H || (at(i + 1) == I && (at(i + 2) == O || at(i + 2) == A)) ? X : S)
+            case T:
+                if at(i + 1) == I && (at(i + 2) == O || at(i + 2) == A) {
+                    key.append(X)
+                } else if at(i + 1) == H {
+                    key.append(theta)
+                } else if !(at(i + 1) == C && at(i + 2) == H) {
+                    key.append(T)
+                }
+            case V:
+                key.append(F)
+            case W, Y:
+                if isVowel(at(i + 1)) { key.append(c) }
+            case X:
+                key.append(contentsOf: [K, S])
+            case Z:
+                key.append(S)
+            default:
+                key.append(c)  // F, J, L, M, N, R
+            }
+        }
+        return key
+    }
+}
+
+/// Toneless Mandarin readings with common fuzzy merges (zh/z, ch/c, sh/s, l/n,
+/// -ng/-n), so accent-level near-misses share a key
+enum Pinyin {
+    private static var cache: [UInt32: String] = [:]
+    private static let cacheLock = NSLock()
+
+    static func key(_ scalars: ArraySlice<Unicode.Scalar>) -> String {
+        scalars.map(syllable).joined(separator: " ")
+    }
+
+    private static func syllable(_ scalar: Unicode.Scalar) -> String {
+        cacheLock.lock()
+        defer { cacheLock.unlock() }
+        if let cached = cache[scalar.value] { return cached }
+
+        var reading = String(scalar)
+            .applyingTransform(.mandarinToLatin, reverse: false)?
+            .applyingTransform(.stripDiacritics, reverse: false)?
+            .lowercased() ?? String(scalar)
+        for (from, to) in [("zh", "z"), ("ch", "c"), ("sh", "s"), ("l", "n")] where reading.hasPrefix(from) {
+            reading = to + reading.dropFirst(from.count)
+            break
+        }
+        if reading.hasSuffix("ng") {
+            reading.removeLast()
+        }
+        cache[scalar.value] = reading
+        return reading
+    }
+}
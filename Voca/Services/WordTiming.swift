@@ -0,0 +1,115 @@
+import Foundation
+import VoicePipeline
+
+/// A word with its time span, in seconds from the start of the audio
+struct TimedWord: Codable, Equatable {
+    let text: String
+    let start: TimeInterval
+    let end: TimeInterval
+}
+
+/// Recognized text plus per-word timing (words are empty when the engine gives no alignment)
+struct TimedTranscript {
+    let text: String
+    var words: [TimedWord]
+    /// Speech confidence, when the engine exposes its CTC output
+    var confidence: SpeechConfidence?
+    /// SenseVoice's language tag, when the engine exposes its CTC output
+    var language: DetectedLanguage?
+
+    init(text: String, words: [TimedWord] = [], confidence: SpeechConfidence? = nil, language: DetectedLanguage? = nil) {
+        self.text = text
+        self.words = words
+        self.confidence = confidence
+        self.language = language
+    }
+}
+
+/// Maps SenseVoice CTC alignments to timed words.
+///
+/// Each encoder frame is one LFR frame, which advances LFR_N mel hops, so frame `f` starts
+/// at `(f - queryFrames) × LFR_N × HOP_LENGTH / SAMPLE_RATE` seconds (60 ms per frame).
+/// The timing comes from the decode that produced the text; there is no second alignment pass.
+enum WordTiming {
+    /// Seconds per encoder frame
+    static let frameShift = Double(ConstantsKt.LFR_N * ConstantsKt.HOP_LENGTH) / ConstantsKt.SAMPLE_RATE_DOUBLE
+    /// Language/event/emotion/ITN query frames the encoder prepends before the audio
+    static let queryFrames: Int32 = 4
+
+    /// Start time of an encoder frame
+    static func seconds(_ frame: Int32) -> TimeInterval {
+        Double(max(frame - queryFrames, 0)) * frameShift
+    }
+
+    /// Detokenize an aligned decode: special tags are split off and the text tokens are
+    /// grouped into timed words
+    static func transcript(_ tokens: [CTCToken], tokenizer: BPETokenizer) -> TimedTranscript {
+        let split = TokenMappings.shared.decodeSpecialTokens(tokens: tokens.map { KotlinInt(int: $0.id) })
+        let textIds = (split.second as? [KotlinInt] ?? []).map { $0.int32Value }
+
+        // The text tokens are the aligned tokens minus the tags, in order
+        var text: [CTCToken] = []
+        text.reserveCapacity(textIds.count)
+        for token in tokens where text.count < textIds.count && token.id == textIds[text.count] {
+            text.append(token)
+        }
+        return TimedTranscript(text: tokenizer.decode(textIds), words: words(text, tokenizer: tokenizer))
+    }
+
+    /// Group text tokens into words: a "▁" piece starts a word, every CJK character is a
+    /// word of its own, and punctuation stays with the word before it
+    static func words(_ tokens: [CTCToken], tokenizer: BPETokenizer) -> [TimedWord] {
+        var words: [TimedWord] = []
+        var current: [CTCToken] = []
+        var currentIsCJK = false
+
+        func finishWord() {
+            guard let first = current.first, let last = current.last else { return }
+            let text = tokenizer.decode(current.map(\.id)).trimmingCharacters(in: .whitespaces)
+            if !text.isEmpty {
+                words.append(TimedWord(text: text, start: seconds(first.startFrame), end: seconds(last.endFrame)))
+            }
+            current.removeAll(keepingCapacity: true)
+        }
+
+        for token in tokens {
+            let piece = tokenizer.piece(for: token.id) ?? ""
+            let scalars = piece.unicodeScalars.drop { $0 == "\u{2581}" }
+            let isPunctuation = !scalars.isEmpty && scalars.allSatisfy { $0.properties.generalCategory.isPunctuation }
+            let isCJK = scalars.first.map(Self.isCJK) ?? false
+
+            if !isPunctuation && (piece.hasPrefix("\u{2581}") || isCJK || currentIsCJK) {
+                finishWord()
+            }
+            current.append(token)
+            if !isPunctuation {
+                currentIsCJK = isCJK
+            }
+        }
+        finishWord()
+        return words
+    }
+
+    /// Move words by `offset` seconds (e.g. a chunk's start within the whole recording)
+    static func shift(_ words: [TimedWord], by offset: TimeInterval) -> [TimedWord] {
+        guard offset != 0 else { return words }
+        return words.map { TimedWord(text: $0.text, start: $0.start + offset, end: $0.end + offset) }
+    }
+
+    /// Chinese and Japanese script, written without spaces (every character counts as a word)
+    static func isCJK(_ scalar: Unicode.Scalar) -> Bool {
+        scalar.properties.isIdeographic || (0x3040...0x30FF).contains(scalar.value)  // + Hiragana, Katakana
+    }
+}
+
+extension Unicode.GeneralCategory {
+    var isPunctuation: Bool {
+        switch self {
+        case .connectorPunctuation, .dashPunctuation, .openPunctuation, .closePunctuation,
+             .initialPunctuation, .finalPunctuation, .otherPunctuation:
+            return true
+        default:
+            return false
+        }
+    }
+}
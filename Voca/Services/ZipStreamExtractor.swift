@@ -0,0 +1,415 @@
+import Foundation
+import Compression
+import CryptoKit
+
+/// Extracts a ZIP archive while its bytes arrive, without needing the central directory.
+///
+/// Local file headers are parsed in stream order; stored and deflated entries are written
+/// straight into `destination`, checked against their CRC-32 and hashed with SHA-256 for
+/// manifest verification. Entries using data descriptors are supported for deflate (the
+/// deflate stream marks its own end).
+final class ZipStreamExtractor {
+    enum ExtractError: LocalizedError {
+        case malformed(String)
+        case unsupported(String)
+        case checksumMismatch(String)
+        case writeFailed(String)
+
+        var errorDescription: String? {
+            switch self {
+            case .malformed(let detail): return "Malformed archive: \(detail)"
+            case .unsupported(let detail): return "Unsupported archive: \(detail)"
+            case .checksumMismatch(let path): return "Checksum mismatch: \(path)"
+            case .writeFailed(let path): return "Failed to write \(path)"
+            }
+        }
+    }
+
+    private struct EntryInfo {
+        let path: String
+        let method: UInt16
+        let hasDescriptor: Bool
+        var isZip64: Bool
+        var crc: UInt32
+        var compressedSize: UInt64
+        var size: UInt64
+    }
+
+    private enum State {
+        case header
+        case stored(remaining: UInt64)
+        case deflated(remaining: UInt64?)
+        case descriptor
+        case finished
+    }
+
+    private static let localHeaderSignature: UInt32 = 0x04034B50
+    private static let centralHeaderSignature: UInt32 = 0x02014B50
+    private static let endOfCentralSignature: UInt32 = 0x06054B50
+    private static let descriptorSignature: UInt32 = 0x08074B50
+    private static let localHeaderSize = 30
+
+    let destination: URL
+    /// Archive offset of the next byte to consume
+    private(set) var offset: UInt64
+    /// Archive offset of the local header of the entry in progress (or the next one)
+    private(set) var entryStart: UInt64
+    var isFinished: Bool {
+        if case .finished = state { return true }
+        return false
+    }
+
+    /// Called with (archive path, SHA-256 hex) after each file is written and CRC-checked
+    var onFileExtracted: ((String, String) -> Void)?
+
+    private var state = State.header
+    private var pending: [UInt8] = []
+    private var entry: EntryInfo?
+    private var output: FileHandle?
+    private var hasher = SHA256()
+    private var crc = CRC32()
+    private var written: UInt64 = 0
+    private var inflater: Inflater?
+
+    /// Start extracting at `startOffset`, which must be the start of a local header
+    init(destination: URL, startOffset: UInt64 = 0) {
+        self.destination = destination
+        self.offset = startOffset
+        self.entryStart = startOffset
+    }
+
+    func consume(_ data: Data) throws {
+        try data.withUnsafeBytes { (raw: UnsafeRawBufferPointer) in
+            var input = raw[...]
+            while !input.isEmpty && !isFinished {
+                let used = try step(UnsafeRawBufferPointer(rebasing: input))
+                input = input.dropFirst(used)
+                offset += UInt64(used)
+                if case .header = state, pending.isEmpty {
+                    entryStart = offset
+                }
+            }
+        }
+    }
+
+    // MARK: - State Machine
+
+    /// Process the front of `input`; returns the number of bytes consumed
+    private func step(_ input: UnsafeRawBufferPointer) throws -> Int {
+        switch state {
+        case .header:
+            return try readHeader(input)
+
+        case .stored(let remaining):
+            let count = Int(min(remaining, UInt64(input.count)))
+            try emit(UnsafeRawBufferPointer(rebasing: input[..<count]))
+            state = .stored(remaining: remaining - UInt64(count))
+            if remaining == UInt64(count) {
+                try endOfData()
+            }
+            return count
+
+        case .deflated(let remaining):
+            // With a known compressed size, never hand the inflater bytes past the entry
+            let limit = remaining.map { Int(min($0, UInt64(input.count))) } ?? input.count
+            let (consumed, ended) = try inflater!.inflate(UnsafeRawBufferPointer(rebasing: input[..<limit])) { chunk in
+                try emit(chunk)
+            }
+            let left = remaining.map { $0 - UInt64(consumed) }
+            state = .deflated(remaining: left)
+            if ended {
+                if let left = left, left != 0 {
+                    throw ExtractError.malformed("deflate stream ended early in \(entry!.path)")
+                }
+                try endOfData()
+            } else if left == 0 {
+                throw ExtractError.malformed("truncated deflate stream in \(entry!.path)")
+            }
+            return consumed
+
+        case .descriptor:
+            return try readDescriptor(input)
+
+        case .finished:
+            return input.count
+        }
+    }
+
+    private func readHeader(_ input: UnsafeRawBufferPointer) throws -> Int {
+        // Accumulate the fixed part, then name + extra field
+        var needed = Self.localHeaderSize
+        if pending.count >= 4 && Self.uint32(pending, 0) != Self.localHeaderSignature {
+            needed = 4
+        } else if pending.count >= Self.localHeaderSize {
+            needed += Int(Self.uint16(pending, 26)) + Int(Self.uint16(pending, 28))
+        }
+        let count = min(needed - pending.count, input.count)
+        pending.append(contentsOf: input[..<count])
+        guard pending.count >= 4 else { return count }
+
+        let signature = Self.uint32(pending, 0)
+        if signature == Self.centralHeaderSignature || signature == Self.endOfCentralSignature {
+            // Central directory: every entry has been extracted
+            pending.removeAll()
+            state = .finished
+            return count
+        }
+        guard signature == Self.localHeaderSignature else {
+            throw ExtractError.malformed(String(format: "bad signature 0x%08x at %llu", signature, entryStart))
+        }
+        guard pending.count >= Self.localHeaderSize else { return count }
+
+        let nameLength = Int(Self.uint16(pending, 26))
+        let extraLength = Int(Self.uint16(pending, 28))
+        guard pending.count == Self.localHeaderSize + nameLength + extraLength else {
+            // Fixed part just completed; come back for the variable part
+            return count
+        }
+
+        try beginEntry(nameLength: nameLength, extraLength: extraLength)
+        pending.removeAll()
+        return count
+    }
+
+    private func beginEntry(nameLength: Int, extraLength: Int) throws {
+        let flags = Self.uint16(pending, 6)
+        let method = Self.uint16(pending, 8)
+        let nameStart = Self.localHeaderSize
+        let path = String(decoding: pending[nameStart..<(nameStart + nameLength)], as: UTF8.self)
+        guard flags & 0x1 == 0 else { throw ExtractError.unsupported("encrypted entry \(path)") }
+
+        var info = EntryInfo(
+            path: path,
+            method: method,
+            hasDescriptor: flags & 0x8 != 0,
+            isZip64: false,
+            crc: Self.uint32(pending, 14),
+            compressedSize: UInt64(Self.uint32(pending, 18)),
+            size: UInt64(Self.uint32(pending, 22))
+        )
+
+        // Zip64 extra field (0x0001) carries sizes that overflow 32 bits
+        var extra = nameStart + nameLength
+        let extraEnd = extra + extraLength
+        while extra + 4 <= extraEnd {
+            let id = Self.uint16(pending, extra)
+            let length = Int(Self.uint16(pending, extra + 2))
+            if id == 0x0001 {
+                var field = extra + 4
+                info.isZip64 = true
+                if info.size == 0xFFFF_FFFF && field + 8 <= extraEnd {
+                    info.size = Self.uint64(pending, field)
+                    field += 8
+                }
+                if info.compressedSize == 0xFFFF_FFFF && field + 8 <= extraEnd {
+                    info.compressedSize = Self.uint64(pending, field)
+                }
+            }
+            extra += 4 + length
+        }
+
+        try openOutput(for: path)
+        entry = info
+        hasher = SHA256()
+        crc = CRC32()
+        written = 0
+
+        switch method {
+        case 0:
+            guard !info.hasDescriptor || info.compressedSize > 0 || path.hasSuffix("/") else {
+                throw ExtractError.unsupported("stored entry of unknown size \(path)")
+            }
+            state = .stored(remaining: info.compressedSize)
+            if info.compressedSize == 0 {
+                try endOfData()
+            }
+        case 8:
+            inflater = try Inflater()
+            state = .deflated(remaining: info.hasDescriptor ? nil : info.compressedSize)
+        default:
+            throw ExtractError.unsupported("compression method \(method) for \(path)")
+        }
+    }
+
+    private func readDescriptor(_ input: UnsafeRawBufferPointer) throws -> Int {
+        let sizeBytes = entry!.isZip64 ? 16 : 8
+        var needed = 4 + 4 + sizeBytes  // assume the optional signature until we can tell
+        if pending.count >= 4 && Self.uint32(pending, 0) != Self.descriptorSignature {
+            needed = 4 + sizeBytes
+        }
+        let count = min(needed - pending.count, input.count)
+        pending.append(contentsOf: input[..<count])
+        guard pending.count >= 4 else { return count }
+
+        let crcOffset = Self.uint32(pending, 0) == Self.descriptorSignature ? 4 : 0
+        guard pending.count == crcOffset + 4 + sizeBytes else { return count }
+
+        entry!.crc = Self.uint32(pending, crcOffset)
+        entry!.size = entry!.isZip64 ? Self.uint64(pending, crcOffset + 12) : UInt64(Self.uint32(pending, crcOffset + 8))
+        pending.removeAll()
+        try finishEntry()
+        return count
+    }
+
+    // MARK: - Output
+
+    private func openOutput(for path: String) throws {
+        output = nil
+
+        // Skip resource-fork metadata; refuse paths escaping the destination
+        let components = path.split(separator: "/")
+        if components.first == "__MACOSX" || components.last?.hasPrefix("._") == true {
+            return
+        }
+        guard !path.hasPrefix("/"), !components.contains("..") else {
+            throw ExtractError.malformed("unsafe path \(path)")
+        }
+
+        let url = destination.appendingPathComponent(path)
+        if path.hasSuffix("/") {
+            try? FileManager.default.createDirectory(at: url, withIntermediateDirectories: true)
+            return
+        }
+        try? FileManager.default.createDirectory(at: url.deletingLastPathComponent(), withIntermediateDirectories: true)
+        // Truncates a partial copy left by an interrupted attempt
+        guard FileManager.default.createFile(atPath: url.path, contents: nil),
+              let handle = try? FileHandle(forWritingTo: url) else {
+            throw ExtractError.writeFailed(path)
+        }
+        output = handle
+    }
+
+    private func emit(_ chunk: UnsafeRawBufferPointer) throws {
+        guard !chunk.isEmpty else { return }
+        crc.update(chunk)
+        hasher.update(bufferPointer: chunk)
+        written += UInt64(chunk.count)
+        if let output = output {
+            do {
+                try output.write(contentsOf: Data(chunk))
+            } catch {
+                throw ExtractError.writeFailed(entry?.path ?? "")
+            }
+        }
+    }
+
+    private func endOfData() throws {
+        inflater = nil
+        if entry!.hasDescriptor {
+            state = .descriptor
+        } else {
+            try finishEntry()
+        }
+    }
+
+    private func finishEntry() throws {
+        guard let info = entry else { return }
+        try? output?.close()
+        output = nil
+        entry = nil
+        state = .header
+
+        guard crc.value == info.crc, written == info.size else {
+            throw ExtractError.checksumMismatch(info.path)
+        }
+        if !info.path.hasSuffix("/") {
+            let digest = hasher.finalize().map { String(format: "%02x", $0) }.joined()
+            onFileExtracted?(info.path, digest)
+        }
+    }
+
+    // MARK: - Little-endian Reads
+
+    private static func uint16(_ bytes: [UInt8], _ at: Int) -> UInt16 {
+        UInt16(bytes[at]) | UInt16(bytes[at + 1]) << 8
+    }
+
+    private static func uint32(_ bytes: [UInt8], _ at: Int) -> UInt32 {
+        UInt32(uint16(bytes, at)) | UInt32(uint16(bytes, at + 2)) << 16
+    }
+
+    private static func uint64(_ bytes: [UInt8], _ at: Int) -> UInt64 {
+        UInt64(uint32(bytes, at)) | UInt64(uint32(bytes, at + 4)) << 32
+    }
+}
+
+// MARK: - Inflate
+
+/// Raw DEFLATE decoder over `compression_stream` (COMPRESSION_ZLIB is headerless deflate)
+private final class Inflater {
+    private static let bufferSize = 256 * 1024
+
+    private let stream = UnsafeMutablePointer<compression_stream>.allocate(capacity: 1)
+    private let buffer = UnsafeMutablePointer<UInt8>.allocate(capacity: Inflater.bufferSize)
+
+    init() throws {
+        guard compression_stream_init(stream, COMPRESSION_STREAM_DECODE, COMPRESSION_ZLIB) == COMPRESSION_STATUS_OK else {
+            stream.deallocate()
+            buffer.deallocate()
+            throw ZipStreamExtractor.ExtractError.unsupported("deflate decoder unavailable")
+        }
+    }
+
+    deinit {
+        compression_stream_destroy(stream)
+        stream.deallocate()
+        buffer.deallocate()
+    }
+
+    /// Decode as much of `input` as possible; returns bytes consumed and whether the
+    /// deflate stream has ended
+    func inflate(_ input: UnsafeRawBufferPointer, output: (UnsafeRawBufferPointer) throws -> Void) throws -> (Int, Bool) {
+        guard let base = input.baseAddress, !input.isEmpty else { return (0, false) }
+        stream.pointee.src_ptr = base.assumingMemoryBound(to: UInt8.self)
+        stream.pointee.src_size = input.count
+
+        while true {
+            stream.pointee.dst_ptr = buffer
+            stream.pointee.dst_size = Self.bufferSize
+            let status = compression_stream_process(stream, 0)
+            let produced = Self.bufferSize - stream.pointee.dst_size
+            if produced > 0 {
+                try output(UnsafeRawBufferPointer(start: buffer, count: produced))
+            }
+
+            switch status {
+            case COMPRESSION_STATUS_END:
+                return (input.count - stream.pointee.src_size, true)
+            case COMPRESSION_STATUS_OK:
+                // Output buffer not filled: the decoder wants more input
+                if produced < Self.bufferSize {
+                    return (input.count - stream.pointee.src_size, false)
+                }
+            default:
+                throw ZipStreamExtractor.ExtractError.malformed("invalid deflate data")
+            }
+        }
+    }
+}
+
+// MARK: - CRC-32
+
+/// CRC-32 (IEEE 802.3, as used by ZIP)
+struct CRC32 {
+    private static let table: [UInt32] = (0..<256).map { n in
+        var c = UInt32(n)
+        for _ in 0..<8 {
+            c = c & 1 != 0 ? 0xEDB8_8320 ^ (c >> 1) : c >> 1
+        }
+        return c
+    }
+
+    private var crc: UInt32 = 0xFFFF_FFFF
+
+    var value: UInt32 { crc ^ 0xFFFF_FFFF }
+
+    mutating func update(_ bytes: UnsafeRawBufferPointer) {
+        var c = crc
+        Self.table.withUnsafeBufferPointer { table in
+            for byte in bytes {
+                c = table[Int((c ^ UInt32(byte)) & 0xFF)] ^ (c >> 8)
+            }
+        }
+        crc = c
+    }
+}
@@ -111,6 +111,26 @@ struct Hotkey: Codable, Equatable {
     }
 }
 
+/// A `find=replace` correction applied to transcribed text
+struct WordMapping: Codable, Equatable {
+    var find: String
+    var replace: String
+
+    init(find: String, replace: String) {
+        self.find = find
+        self.replace = replace
+    }
+
+    /// Parse a "find=replace" entry
+    init?(entry: String) {
+        let parts = entry.split(separator: "=", maxSplits: 1).map { $0.trimmingCharacters(in: .whitespaces) }
+        guard parts.count == 2, !parts[0].isEmpty, !parts[1].isEmpty else { return nil }
+        self.init(find: parts[0], replace: parts[1])
+    }
+
+    var entry: String { "\(find)=\(replace)" }
+}
+
 class AppSettings {
     static let shared = AppSettings()
 
@@ -120,6 +140,16 @@ class AppSettings {
         static let selectedModel = "selectedModel"
         static let recordHotkey = "recordHotkey"
         static let inputDeviceUID = "inputDeviceUID"
+        static let customWords = "customWords"
+        static let wordMappings = "wordReplacements"
+        static let modelMemoryBudgetMB = "modelMemoryBudgetMB"
+        static let senseVoiceOnONNX = "senseVoiceOnONNX"
+        static let onnxSessions = "onnxSessions"
+        static let audioFrontEnd = "audioFrontEnd"
+        static let minSpeechConfidence = "minSpeechConfidence"
+        static let livePartials = "livePartials"
+        static let languageRouting = "languageRouting"
+        static let halfPrecisionLogits = "halfPrecisionLogits"
     }
 
     var selectedModel: ASRModel {
@@ -160,5 +190,117 @@ class AppSettings {
         }
     }
 
+    /// Words to bias recognition towards (names, jargon); empty = plain greedy decoding
+    var customWords: [String] {
+        get {
+            defaults.stringArray(forKey: Keys.customWords) ?? []
+        }
+        set {
+            defaults.set(newValue, forKey: Keys.customWords)
+            NotificationCenter.default.post(name: .wordListsChanged, object: nil)
+        }
+    }
+
+    /// Exact `find=replace` corrections (near-misses are matched phonetically)
+    var wordMappings: [WordMapping] {
+        get {
+            guard let data = defaults.data(forKey: Keys.wordMappings),
+                  let mappings = try? JSONDecoder().decode([WordMapping].self, from: data) else {
+                return []
+            }
+            return mappings
+        }
+        set {
+            if let data = try? JSONEncoder().encode(newValue) {
+                defaults.set(data, forKey: Keys.wordMappings)
+                NotificationCenter.default.post(name: .wordListsChanged, object: nil)
+            }
+        }
+    }
+
+    /// Memory resident ASR models may use before the least recently used is unloaded
+    var modelMemoryBudgetMB: Int {
+        get {
+            defaults.object(forKey: Keys.modelMemoryBudgetMB) == nil ? 3072 : defaults.integer(forKey: Keys.modelMemoryBudgetMB)
+        }
+        set {
+            defaults.set(newValue, forKey: Keys.modelMemoryBudgetMB)
+        }
+    }
+
+    /// Run SenseVoice on ONNX Runtime (CPU) instead of CoreML
+    var senseVoiceOnONNX: Bool {
+        get {
+            defaults.bool(forKey: Keys.senseVoiceOnONNX)
+        }
+        set {
+            defaults.set(newValue, forKey: Keys.senseVoiceOnONNX)
+        }
+    }
+
+    /// ONNX sessions (utterances decoded in parallel); each holds its own copy of the model
+    var onnxSessions: Int {
+        get {
+            defaults.object(forKey: Keys.onnxSessions) == nil ? 1 : max(1, defaults.integer(forKey: Keys.onnxSessions))
+        }
+        set {
+            defaults.set(newValue, forKey: Keys.onnxSessions)
+        }
+    }
+
+    /// Clean the microphone signal (high-pass, noise suppression, gain control) before
+    /// speech detection and transcription
+    var audioFrontEnd: Bool {
+        get {
+            defaults.object(forKey: Keys.audioFrontEnd) == nil ? true : defaults.bool(forKey: Keys.audioFrontEnd)
+        }
+        set {
+            defaults.set(newValue, forKey: Keys.audioFrontEnd)
+        }
+    }
+
+    /// Segments whose speech confidence (VAD probability, CTC non-blank share) falls below
+    /// this are not decoded; 0 decodes everything
+    var minSpeechConfidence: Float {
+        get {
+            defaults.object(forKey: Keys.minSpeechConfidence) == nil ? 0.15 : defaults.float(forKey: Keys.minSpeechConfidence)
+        }
+        set {
+            defaults.set(newValue, forKey: Keys.minSpeechConfidence)
+        }
+    }
+
+    /// Show partial text while speaking (streaming SenseVoice; needs the ONNX backend)
+    var livePartials: Bool {
+        get {
+            defaults.bool(forKey: Keys.livePartials)
+        }
+        set {
+            defaults.set(newValue, forKey: Keys.livePartials)
+        }
+    }
+
+    /// With SenseVoice selected, send other languages and low-confidence utterances to
+    /// Whisper Turbo (downloaded separately)
+    var languageRouting: Bool {
+        get {
+            defaults.bool(forKey: Keys.languageRouting)
+        }
+        set {
+            defaults.set(newValue, forKey: Keys.languageRouting)
+        }
+    }
+
+    /// Keep SenseVoice's CTC logits as fp16 (half the memory per utterance; applies to
+    /// models loaded afterwards)
+    var halfPrecisionLogits: Bool {
+        get {
+            defaults.bool(forKey: Keys.halfPrecisionLogits)
+        }
+        set {
+            defaults.set(newValue, forKey: Keys.halfPrecisionLogits)
+        }
+    }
+
     private init() {}
 }
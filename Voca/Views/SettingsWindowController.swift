@@ -9,7 +9,7 @@ class SettingsWindowController: NSWindowController {
 
     private init() {
         let window = NSWindow(
-            contentRect: NSRect(x: 0, y: 0, width: 500, height: 380),
+            contentRect: NSRect(x: 0, y: 0, width: 500, height: 444),
             styleMask: [.titled, .closable],
             backing: .buffered,
             defer: false
@@ -44,6 +44,8 @@ class SettingsView: NSView {
     private var modelPopup: NSPopUpButton!
     private var inputPopup: NSPopUpButton!
     private var shortcutPopup: NSPopUpButton!
+    private var customWordsField: NSTextField!
+    private var replacementsField: NSTextField!
     private var micStatusLabel: NSTextField!
     private var micStatusIcon: NSButton!
     private var accessibilityStatusLabel: NSTextField!
@@ -127,11 +129,21 @@ class SettingsView: NSView {
         let modelLabel = createLabel(NSLocalizedString("Language", comment: ""))
         let inputLabel = createLabel(NSLocalizedString("Microphone", comment: ""))
         let shortcutLabel = createLabel(NSLocalizedString("Shortcut", comment: ""))
+        let customWordsLabel = createLabel(NSLocalizedString("Custom Words", comment: ""))
+        let replacementsLabel = createLabel(NSLocalizedString("Replacements", comment: ""))
 
         modelPopup = createPopup()
         inputPopup = createPopup()
         shortcutPopup = createPopup()
 
+        customWordsField = NSTextField()
+        customWordsField.font = NSFont.systemFont(ofSize: 13)
+        customWordsField.placeholderString = NSLocalizedString("Comma-separated, e.g. Voca, Kubernetes", comment: "")
+
+        replacementsField = NSTextField()
+        replacementsField.font = NSFont.systemFont(ofSize: 13)
+        replacementsField.placeholderString = NSLocalizedString("find=replace, e.g. cloud=Claude", comment: "")
+
         // Permission indicators (bottom left)
         micStatusLabel = NSTextField(labelWithString: "")
         micStatusLabel.font = NSFont.systemFont(ofSize: 12)
@@ -196,6 +208,10 @@ class SettingsView: NSView {
         addSubview(inputPopup)
         addSubview(shortcutLabel)
         addSubview(shortcutPopup)
+        addSubview(customWordsLabel)
+        addSubview(customWordsField)
+        addSubview(replacementsLabel)
+        addSubview(replacementsField)
         addSubview(micStatusLabel)
         addSubview(micStatusIcon)
         addSubview(accessibilityStatusLabel)
@@ -213,6 +229,10 @@ class SettingsView: NSView {
         inputPopup.translatesAutoresizingMaskIntoConstraints = false
         shortcutLabel.translatesAutoresizingMaskIntoConstraints = false
         shortcutPopup.translatesAutoresizingMaskIntoConstraints = false
+        customWordsLabel.translatesAutoresizingMaskIntoConstraints = false
+        customWordsField.translatesAutoresizingMaskIntoConstraints = false
+        replacementsLabel.translatesAutoresizingMaskIntoConstraints = false
+        replacementsField.translatesAutoresizingMaskIntoConstraints = false
         micStatusLabel.translatesAutoresizingMaskIntoConstraints = false
         micStatusIcon.translatesAutoresizingMaskIntoConstraints = false
         accessibilityStatusLabel.translatesAutoresizingMaskIntoConstraints = false
@@ -256,9 +276,27 @@ class SettingsView: NSView {
             shortcutPopup.trailingAnchor.constraint(equalTo: trailingAnchor, constant: -20),
             shortcutPopup.centerYAnchor.constraint(equalTo: shortcutLabel.centerYAnchor),
 
-            // History section (after shortcut row)
+            // Custom words row
+            customWordsLabel.leadingAnchor.constraint(equalTo: leadingAnchor, constant: 20),
+            customWordsLabel.topAnchor.constraint(equalTo: shortcutLabel.bottomAnchor, constant: 16),
+            customWordsLabel.widthAnchor.constraint(equalToConstant: 100),
+
+            customWordsField.leadingAnchor.constraint(equalTo: customWordsLabel.trailingAnchor, constant: 10),
+            customWordsField.trailingAnchor.constraint(equalTo: trailingAnchor, constant: -20),
+            customWordsField.centerYAnchor.constraint(equalTo: customWordsLabel.centerYAnchor),
+
+            // Replacements row
+            replacementsLabel.leadingAnchor.constraint(equalTo: leadingAnchor, constant: 20),
+            replacementsLabel.topAnchor.constraint(equalTo: customWordsLabel.bottomAnchor, constant: 16),
+            replacementsLabel.widthAnchor.constraint(equalToConstant: 100),
+
+            replacementsField.leadingAnchor.constraint(equalTo: replacementsLabel.trailingAnchor, constant: 10),
+            replacementsField.trailingAnchor.constraint(equalTo: trailingAnchor, constant: -20),
+            replacementsField.centerYAnchor.constraint(equalTo: replacementsLabel.centerYAnchor),
+
+            // History section (after replacements row)
             historyLabel.leadingAnchor.constraint(equalTo: leadingAnchor, constant: 20),
-            historyLabel.topAnchor.constraint(equalTo: shortcutLabel.bottomAnchor, constant: 16),
+            historyLabel.topAnchor.constraint(equalTo: replacementsLabel.bottomAnchor, constant: 16),
 
             historyScrollView.leadingAnchor.constraint(equalTo: leadingAnchor, constant: 20),
             historyScrollView.trailingAnchor.constraint(equalTo: trailingAnchor, constant: -20),
@@ -304,6 +342,10 @@ class SettingsView: NSView {
         inputPopup.action = #selector(inputChanged(_:))
         shortcutPopup.target = self
         shortcutPopup.action = #selector(shortcutChanged(_:))
+        customWordsField.target = self
+        customWordsField.action = #selector(customWordsChanged(_:))
+        replacementsField.target = self
+        replacementsField.action = #selector(replacementsChanged(_:))
 
         refresh()
     }
@@ -325,6 +367,7 @@ class SettingsView: NSView {
         refreshModels()
         refreshInputDevices()
         refreshShortcuts()
+        refreshWordLists()
         refreshPermissions()
         refreshHistory()
     }
@@ -433,6 +476,11 @@ class SettingsView: NSView {
         }
     }
 
+    private func refreshWordLists() {
+        customWordsField.stringValue = AppSettings.shared.customWords.joined(separator: ", ")
+        replacementsField.stringValue = AppSettings.shared.wordMappings.map(\.entry).joined(separator: ", ")
+    }
+
     // MARK: - Actions
 
     @objc private func modelChanged(_ sender: NSPopUpButton) {
@@ -463,6 +511,23 @@ class SettingsView: NSView {
         AppSettings.shared.recordHotkey = hotkey
     }
 
+    @objc private func customWordsChanged(_ sender: NSTextField) {
+        // Accept ASCII and CJK separators
+        let words = sender.stringValue
+            .components(separatedBy: CharacterSet(charactersIn: ",，、\n"))
+            .map { $0.trimmingCharacters(in: .whitespaces) }
+            .filter { !$0.isEmpty }
+        AppSettings.shared.customWords = words
+        refreshWordLists()
+    }
+
+    @objc private func replacementsChanged(_ sender: NSTextField) {
+        AppSettings.shared.wordMappings = sender.stringValue
+            .components(separatedBy: CharacterSet(charactersIn: ",，\n"))
+            .compactMap(WordMapping.init(entry:))
+        refreshWordLists()
+    }
+
     // MARK: - Permissions
 
     private func refreshPermissions() {
@@ -574,6 +639,14 @@ class SettingsView: NSView {
             playButton.translatesAutoresizingMaskIntoConstraints = false
             rowView.addSubview(playButton)
 
+            let retranscribeButton = NSButton(image: NSImage(systemSymbolName: "arrow.clockwise.circle", accessibilityDescription: "Transcribe Again")!, target: self, action: #selector(retranscribeHistoryItem(_:)))
+            retranscribeButton.bezelStyle = .inline
+            retranscribeButton.isBordered = false
+            retranscribeButton.tag = index
+            retranscribeButton.toolTip = NSLocalizedString("Transcribe again with the current model and settings", comment: "")
+            retranscribeButton.translatesAutoresizingMaskIntoConstraints = false
+            rowView.addSubview(retranscribeButton)
+
             NSLayoutConstraint.activate([
                 timeLabel.leadingAnchor.constraint(equalTo: rowView.leadingAnchor),
                 timeLabel.centerYAnchor.constraint(equalTo: rowView.centerYAnchor),
@@ -581,7 +654,11 @@ class SettingsView: NSView {
 
                 textLabel.leadingAnchor.constraint(equalTo: timeLabel.trailingAnchor, constant: 8),
                 textLabel.centerYAnchor.constraint(equalTo: rowView.centerYAnchor),
-                textLabel.trailingAnchor.constraint(equalTo: playButton.leadingAnchor, constant: -8),
+                textLabel.trailingAnchor.constraint(equalTo: retranscribeButton.leadingAnchor, constant: -8),
+
+                retranscribeButton.trailingAnchor.constraint(equalTo: playButton.leadingAnchor, constant: -4),
+                retranscribeButton.centerYAnchor.constraint(equalTo: rowView.centerYAnchor),
+                retranscribeButton.widthAnchor.constraint(equalToConstant: 24),
 
                 playButton.trailingAnchor.constraint(equalTo: rowView.trailingAnchor),
                 playButton.centerYAnchor.constraint(equalTo: rowView.centerYAnchor),
@@ -612,6 +689,11 @@ class SettingsView: NSView {
         historyManager.playAudio(at: sender.tag)
     }
 
+    @objc private func retranscribeHistoryItem(_ sender: NSButton) {
+        guard let item = historyManager.getItem(at: sender.tag), item.audioURL != nil else { return }
+        NotificationCenter.default.post(name: .retranscribeRequested, object: NSNumber(value: item.id))
+    }
+
     private func pasteHistoryText(_ text: String) {
         // Copy to clipboard
         let pasteboard = NSPasteboard.general
@@ -703,5 +785,8 @@ class ClickableHistoryRow: NSView {
 // Notification for model change
 extension Notification.Name {
     static let modelChanged = Notification.Name("modelChanged")
+    static let modelInstalled = Notification.Name("modelInstalled")
     static let historyDidUpdate = Notification.Name("historyDidUpdate")
+    static let retranscribeRequested = Notification.Name("retranscribeRequested")
+    static let wordListsChanged = Notification.Name("wordListsChanged")
 }
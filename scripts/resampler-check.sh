@@ -0,0 +1,12 @@
+#!/bin/sh
+# Build and run the resampler quality/throughput checks with plain swiftc (no Xcode,
+# no VoicePipeline), e.g. on a Linux CI box. Exits non-zero if a quality bound fails.
+set -e
+cd "$(dirname "$0")/.."
+
+work="$(mktemp -d)"
+trap 'rm -rf "$work"' EXIT
+printf 'import Foundation\nexit(ResamplerCheck.run() ? 0 : 1)\n' > "$work/main.swift"
+
+swiftc -O Voca/Services/Resampler.swift Tests/VocaTests/ResamplerCheck.swift "$work/main.swift" -o "$work/resampler-check"
+"$work/resampler-check"